@@ -0,0 +1,88 @@
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "SolveOptions.h"
+
+/// @brief Board and status handed back by an asynchronous solve
+struct AsyncSolveResult {
+    std::array<std::array<char, 9>, 9> board;
+    SolveStatus status;
+    SolveStats stats;
+};
+
+/**
+ * @brief Solve puzzles on a pool of threads owned by the library
+ *
+ * Jobs are queued and picked up in submission order. Each job carries its own
+ * SolveOptions so a caller can cancel one puzzle or give it a deadline without
+ * affecting the others. Destroying the AsyncSolver cancels nothing: queued jobs
+ * are finished before the workers are joined.
+ */
+class AsyncSolver {
+public:
+    using Board = std::array<std::array<char, 9>, 9>;
+    using Callback = std::function<void(AsyncSolveResult&)>;
+    using ErrorCallback = std::function<void(std::exception_ptr)>;
+
+    /**
+     * @brief Start the worker threads
+     * @param threadCount Number of workers. 0 uses std::thread::hardware_concurrency
+     */
+    explicit AsyncSolver(unsigned threadCount = 0);
+
+    /// @brief Drain the queue and join the workers
+    ~AsyncSolver();
+
+    AsyncSolver(const AsyncSolver&) = delete;
+    AsyncSolver& operator=(const AsyncSolver&) = delete;
+
+    /**
+     * @brief Queue a puzzle and get a future for its result
+     * @param board The puzzle, copied into the job
+     * @param opts Cancellation token and deadline for this puzzle
+     * @return Future that becomes ready once the solve finished or was aborted. get() rethrows an exception of the solve
+     */
+    std::future<AsyncSolveResult> submit(const Board& board, SolveOptions opts = SolveOptions());
+
+    /**
+     * @brief Queue a puzzle and call `onDone` from the worker thread once it is finished
+     *
+     * Callbacks must not throw. An exception leaving one is caught and dropped so
+     * the worker survives, and nobody hears about it.
+     *
+     * @param board The puzzle, copied into the job
+     * @param opts Cancellation token and deadline for this puzzle
+     * @param onDone Completion callback. It must not block for long, it runs on a pool thread
+     * @param onError Called instead of onDone if the solve throws, e.g. std::bad_alloc. Without it such a job is dropped
+     */
+    void submit(const Board& board, SolveOptions opts, Callback onDone, ErrorCallback onError = nullptr);
+
+    /// @brief Number of worker threads
+    size_t threadCount() const;
+
+private:
+    struct Job {
+        Board board;
+        SolveOptions options;
+        Callback onDone;
+        ErrorCallback onError;
+    };
+
+    /// @brief Loop run by every worker: pop a job, solve it, report it
+    void workerLoop();
+
+    std::vector<std::thread> workers;
+    std::deque<Job> queue;
+    std::mutex queueMutex;
+    std::condition_variable queueReady;
+    bool stopping = false;
+};
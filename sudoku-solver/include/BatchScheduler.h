@@ -0,0 +1,185 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "Bitboard.h"
+#include "NumaTopology.h"
+#include "SolveOptions.h"
+
+/**
+ * @brief Cheap prediction of how hard a puzzle is, computed before solving it
+ *
+ * The score is the base-2 logarithm of the number of candidate combinations left
+ * after the initial propagation, the sum of log2(candidates) over the unresolved
+ * cells. It is 0 for a puzzle that propagation solves, and grows with the size of
+ * the tree the search may have to explore.
+ */
+struct DifficultyEstimate {
+    /// @brief Givens of the puzzle
+    int clues = 0;
+
+    /// @brief Cells still unknown after naked singles, hidden singles and box/line interactions
+    int unresolved = 0;
+
+    double score = 0;
+};
+
+/// @brief Settings of a BatchScheduler
+struct BatchOptions {
+    /// @brief Worker threads. 0 uses std::thread::hardware_concurrency
+    unsigned threads = 0;
+
+    /// @brief Start with the puzzles with the highest score (longest processing time first)
+    bool longestFirst = true;
+
+    /// @brief Puzzles scoring at least this much are split into independent pieces. Infinity never splits
+    double splitScore = 100;
+
+    /// @brief Most pieces a puzzle is split into. 0 allows four per thread
+    size_t maxPieces = 0;
+
+    /// @brief Node budget of each piece
+    uint64_t maxNodes = std::numeric_limits<uint64_t>::max();
+
+    /// @brief Point after which every piece still running gives up
+    SolveOptions::Clock::time_point deadline = SolveOptions::Clock::time_point::max();
+
+    /// @brief Pin each worker to one CPU, taking the NUMA nodes in turn
+    bool pinThreads = false;
+
+    /// @brief Give each NUMA node a share of the batch, held in memory local to the node
+    bool shardByNode = false;
+};
+
+/// @brief Counters of the last batch
+struct BatchStats {
+    uint64_t puzzles = 0;
+
+    /// @brief Puzzles that were split into more than one piece
+    uint64_t splitPuzzles = 0;
+
+    /// @brief Jobs handed to the workers, one per unsplit puzzle plus one per piece
+    uint64_t pieces = 0;
+
+    /// @brief Wall-clock time of the whole batch
+    std::chrono::nanoseconds elapsed = std::chrono::nanoseconds::zero();
+
+    /// @brief Solve time summed over every piece
+    std::chrono::nanoseconds work = std::chrono::nanoseconds::zero();
+
+    /// @brief Longest single piece, the lower bound on the batch time
+    std::chrono::nanoseconds longestPiece = std::chrono::nanoseconds::zero();
+
+    unsigned threads = 0;
+
+    /// @brief Shards the batch was divided into, one per NUMA node with workers
+    unsigned shards = 0;
+
+    /// @brief Workers of the solving phase that the OS let pin themselves
+    unsigned pinnedThreads = 0;
+
+    /// @brief Pieces solved by a worker of another shard once its own ran out
+    uint64_t stolenPieces = 0;
+
+    /// @brief work / (elapsed * threads). 1 means no core was ever idle
+    double efficiency() const
+    {
+        double capacity = static_cast<double>(elapsed.count()) * threads;
+        return capacity == 0 ? 0 : static_cast<double>(work.count()) / capacity;
+    }
+};
+
+/**
+ * @brief Solve a batch of puzzles without leaving cores idle behind a few hard ones
+ *
+ * Every puzzle is loaded into a BitboardState and scored by estimate, in
+ * parallel. Puzzles at or above BatchOptions::splitScore are split on their
+ * cell with the fewest candidates, one piece per candidate, repeatedly on the
+ * highest scoring piece, until the pieces score below the threshold or
+ * maxPieces is reached. The jobs are then handed out highest score first.
+ *
+ * The pieces of a puzzle share a CancellationToken: the first piece to find
+ * a solution cancels its siblings. A puzzle is Unsolvable once every piece is.
+ *
+ * With shardByNode, the batch is cut into one contiguous shard per NUMA node,
+ * sized by the workers of the node. The workers of a node copy their shard into
+ * a NodeArena, prepare and solve it there, and only move on to the jobs of
+ * other shards once their own are gone. Solutions are copied back at the end.
+ */
+class BatchScheduler {
+public:
+    using Board = std::array<std::array<char, 9>, 9>;
+
+    /// @param options The settings. The topology is detected if pinThreads or shardByNode is set
+    explicit BatchScheduler(const BatchOptions& options = BatchOptions());
+
+    /**
+     * @brief Schedule over a given topology instead of the detected one
+     * @param options The settings
+     * @param topology The nodes the workers are spread over
+     */
+    BatchScheduler(const BatchOptions& options, const NumaTopology& topology);
+
+    /**
+     * @brief Predict the difficulty of a puzzle
+     * @param board The puzzle
+     * @return The estimate. A puzzle whose givens contradict each other scores 0
+     */
+    static DifficultyEstimate estimate(const Board& board);
+
+    /**
+     * @brief Predict the difficulty of a puzzle and keep the state it was loaded into
+     * @param board The puzzle
+     * @param state Receives the propagated givens, ready to be split or solved
+     * @param e Receives the estimate
+     * @return False if the givens contradict each other, the state is then unusable
+     */
+    static bool estimate(const Board& board, BitboardState& state, DifficultyEstimate& e);
+
+    /**
+     * @brief Score of an already propagated state
+     * @param state The state
+     * @return Sum of log2(candidates) over the unsolved cells
+     */
+    static double score(const BitboardState& state);
+
+    /**
+     * @brief Solve every board of the batch
+     * @param boards The puzzles. Each solved board is replaced by its solution
+     * @return The status of each board, in the same order
+     */
+    std::vector<SolveStatus> solve(std::vector<Board>& boards);
+
+    /// @brief Counters of the last call to solve
+    const BatchStats& getStats() const;
+
+private:
+    /**
+     * @brief Split a state until its pieces score below the threshold or there are enough of them
+     * @param state A propagated state
+     * @param pieces Receives the consistent pieces. Empty if every branch is a contradiction
+     */
+    void split(const BitboardState& state, std::vector<BitboardState>& pieces) const;
+
+    /// @brief Where a worker runs
+    struct Placement {
+        size_t shard;
+        /// @brief CPU to pin to, -1 to leave the thread free
+        int cpu;
+    };
+
+    BatchOptions options;
+    unsigned threadCount;
+    BatchStats stats;
+
+    /// @brief Placement of each worker, in thread order
+    std::vector<Placement> placements;
+
+    /// @brief Workers of each shard
+    std::vector<unsigned> shardThreads;
+};
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/**
+ * @brief One bit per cell of the board, cells numbered row by row
+ *
+ * Cells 0 through 63 live in `lo`, cells 64 through 80 in the low bits of `hi`.
+ */
+struct Bitboard81 {
+    uint64_t lo = 0;
+    uint64_t hi = 0;
+
+    /// @brief Bits of `hi` that hold cells
+    static const uint64_t HI_MASK = (uint64_t(1) << 17) - 1;
+
+    static Bitboard81 cell(int c)
+    {
+        Bitboard81 b;
+        if (c < 64) b.lo = uint64_t(1) << c;
+        else b.hi = uint64_t(1) << (c - 64);
+        return b;
+    }
+
+    static Bitboard81 all()
+    {
+        Bitboard81 b;
+        b.lo = ~uint64_t(0);
+        b.hi = HI_MASK;
+        return b;
+    }
+
+    bool test(int c) const { return c < 64 ? ((lo >> c) & 1) != 0 : ((hi >> (c - 64)) & 1) != 0; }
+    void set(int c) { *this = *this | cell(c); }
+    void reset(int c) { *this = andNot(cell(c)); }
+
+    bool any() const { return (lo | hi) != 0; }
+    bool none() const { return (lo | hi) == 0; }
+
+    /// @brief Number of cells set
+    int count() const { return popcount(lo) + popcount(hi); }
+
+    /// @brief Lowest cell set, -1 if none
+    int first() const
+    {
+        if (lo != 0) return countTrailingZeros(lo);
+        if (hi != 0) return 64 + countTrailingZeros(hi);
+        return -1;
+    }
+
+    /// @brief Highest cell set, -1 if none
+    int last() const
+    {
+        if (hi != 0) return 127 - countLeadingZeros(hi);
+        if (lo != 0) return 63 - countLeadingZeros(lo);
+        return -1;
+    }
+
+    Bitboard81 operator&(const Bitboard81& o) const { Bitboard81 b; b.lo = lo & o.lo; b.hi = hi & o.hi; return b; }
+    Bitboard81 operator|(const Bitboard81& o) const { Bitboard81 b; b.lo = lo | o.lo; b.hi = hi | o.hi; return b; }
+    Bitboard81 operator^(const Bitboard81& o) const { Bitboard81 b; b.lo = lo ^ o.lo; b.hi = hi ^ o.hi; return b; }
+    Bitboard81& operator|=(const Bitboard81& o) { lo |= o.lo; hi |= o.hi; return *this; }
+    Bitboard81& operator&=(const Bitboard81& o) { lo &= o.lo; hi &= o.hi; return *this; }
+
+    /// @brief this & ~o
+    Bitboard81 andNot(const Bitboard81& o) const { Bitboard81 b; b.lo = lo & ~o.lo; b.hi = hi & ~o.hi; return b; }
+
+    bool operator==(const Bitboard81& o) const { return lo == o.lo && hi == o.hi; }
+    bool operator!=(const Bitboard81& o) const { return !(*this == o); }
+
+    static int popcount(uint64_t x)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_popcountll(x);
+#elif defined(_MSC_VER) && defined(_M_X64)
+        return static_cast<int>(__popcnt64(x));
+#else
+        int n = 0;
+        for (; x != 0; x &= x - 1) n++;
+        return n;
+#endif
+    }
+
+    /// @brief Index of the lowest set bit. x must not be 0
+    static int countTrailingZeros(uint64_t x)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(x);
+#elif defined(_MSC_VER) && defined(_M_X64)
+        unsigned long index;
+        _BitScanForward64(&index, x);
+        return static_cast<int>(index);
+#else
+        int n = 0;
+        while ((x & 1) == 0) { x >>= 1; n++; }
+        return n;
+#endif
+    }
+
+    /// @brief Number of zero bits above the highest set bit. x must not be 0
+    static int countLeadingZeros(uint64_t x)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_clzll(x);
+#elif defined(_MSC_VER) && defined(_M_X64)
+        unsigned long index;
+        _BitScanReverse64(&index, x);
+        return 63 - static_cast<int>(index);
+#else
+        int n = 0;
+        while ((x & (uint64_t(1) << 63)) == 0) { x <<= 1; n++; }
+        return n;
+#endif
+    }
+};
+
+/// @brief Unit and peer masks of the standard board as bitboards
+struct BitboardMasks {
+    std::array<Bitboard81, 9> rows;
+    std::array<Bitboard81, 9> cols;
+    std::array<Bitboard81, 9> boxes;
+    /// @brief Rows, then columns, then boxes
+    std::array<Bitboard81, 27> units;
+    std::array<Bitboard81, 81> peers;
+
+    /// @brief The masks, built on first use
+    static const BitboardMasks& get();
+};
+
+/**
+ * @brief Candidates of a board stored digit-major
+ *
+ * candidates[d] holds the cells where digit d+1 may still go. A solved cell keeps
+ * exactly its own digit, so "where can d go in this unit" is a single AND with a
+ * unit mask. The whole state is 160 bytes, so the search copies it instead of
+ * undoing changes.
+ */
+struct BitboardState {
+    std::array<Bitboard81, 9> candidates;
+    /// @brief Cells whose value is fixed
+    Bitboard81 solved;
+
+    /// @brief A board without any given: every digit everywhere
+    static BitboardState empty();
+
+    /**
+     * @brief Set a cell and remove its digit from the peers
+     * @param c The cell, 0 through 80
+     * @param digit The digit, 1 through 9
+     * @return false If the digit is not a candidate of the cell
+     */
+    bool assign(int c, int digit);
+
+    /**
+     * @brief Apply naked singles, hidden singles and box/line interactions until nothing changes
+     * @return false If a cell or a unit runs out of candidates
+     */
+    bool propagate();
+
+    /// @brief Value of a solved cell, 0 if the cell is not solved
+    int valueAt(int c) const;
+
+    /// @brief Candidates of a cell, bit d set if digit d is possible
+    uint16_t candidatesAt(int c) const;
+
+    /// @brief True when every cell is solved
+    bool isComplete() const { return solved == Bitboard81::all(); }
+
+private:
+    /// @brief Place every cell that has a single candidate left. Sets `progress` if one was placed
+    bool nakedSingles(bool& progress);
+
+    /// @brief Place every digit that has a single spot left in a unit. Sets `progress` if one was placed
+    bool hiddenSingles(bool& progress);
+
+    /// @brief Remove candidates with pointing pairs/triples and box/line reduction. Sets `progress` if one was removed
+    void boxLineInteractions(bool& progress);
+};
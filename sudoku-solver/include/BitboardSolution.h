@@ -0,0 +1,117 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "Bitboard.h"
+#include "SolveOptions.h"
+
+/**
+ * @brief Solver built on digit-major bitboards
+ *
+ * Offers the same solveSudoku, countSolutions and getStats members as Solution so
+ * the two layouts can be swapped and benchmarked against each other. Propagation
+ * (naked singles, hidden singles, box/line interactions) is done on whole digit
+ * planes with AND/ANDN/popcount and the precomputed masks of BitboardMasks.
+ */
+class BitboardSolution
+{
+public:
+    using Board = std::array<std::array<char, 9>, 9>;
+
+    /**
+     * @brief Solve the Sudoku puzzle
+     * @param board The sudoku puzzle to solve. If it can't be solved, it remains untouched
+     */
+    void solveSudoku(Board& board);
+
+    /**
+     * @brief Solve the Sudoku puzzle, giving up when cancelled or out of budget
+     * @param board The sudoku puzzle to solve
+     * @param opts The cancellation token, deadline and node budget of the search
+     * @return The outcome of the solve. The board is only written when Solved
+     */
+    SolveStatus solveSudoku(Board& board, const SolveOptions& opts);
+
+    /**
+     * @brief Solve from an already propagated state
+     * @param state A state built by load or assign and propagate. Replaced by the solution when Solved
+     * @param opts The cancellation token, deadline and node budget of the search
+     * @return The outcome of the solve
+     */
+    SolveStatus solveState(BitboardState& state, const SolveOptions& opts);
+
+    /**
+     * @brief Count the solutions of a puzzle, stopping once `limit` are found
+     * @param board The sudoku puzzle. It is not modified
+     * @param limit Stop counting after this many solutions
+     * @return The number of solutions, at most `limit`
+     */
+    uint32_t countSolutions(const Board& board, uint32_t limit = 2);
+
+    /// @brief Get the counters of the last solve
+    const SolveStats& getStats() const;
+
+    /**
+     * @brief Build the propagated state of a board
+     * @param board The puzzle. Anything other than '1' through '9' is an empty cell
+     * @param state Receives the state
+     * @return false If the givens contradict each other
+     */
+    static bool load(const Board& board, BitboardState& state);
+
+    /**
+     * @brief Write the solved cells of a state into a board
+     * @param state The state
+     * @param board Receives the digits of the solved cells
+     */
+    static void store(const BitboardState& state, Board& board);
+
+private:
+    /// @brief Number of nodes between two polls of the cancellation token and deadline
+    static const uint64_t POLL_INTERVAL = 64;
+
+    /// @brief One level of the explicit search stack
+    struct Frame {
+        /// @brief State before the guess of this level
+        BitboardState state;
+        /// @brief Cell guessed at this level
+        int cell;
+        /// @brief Values not tried yet at this level, bit v set if v remains
+        uint16_t untried;
+    };
+
+    /// @brief Search stack, preallocated to one frame per cell
+    std::vector<Frame> frames;
+
+    /// @brief Number of frames in use
+    size_t depth = 0;
+
+    /// @brief State being searched. Holds the solution once search returns Solved
+    BitboardState current;
+
+    const SolveOptions* options = nullptr;
+    SolveStats stats;
+
+    /**
+     * @brief Pick the unsolved cell with the fewest candidates
+     * @param state The state
+     * @return The cell
+     */
+    static int pickCell(const BitboardState& state);
+
+    /**
+     * @brief Continue the search from `current` and the frames until a solution, exhaustion or an abort
+     * @return Solved, Unsolvable, Cancelled or BudgetExceeded
+     */
+    SolveStatus search();
+
+    /**
+     * @brief Push a frame for the best cell of `current`
+     */
+    void descend();
+
+    /// @brief Check the node budget, and every POLL_INTERVAL nodes the token and the deadline
+    bool inline shouldAbort(SolveStatus& why) const;
+};
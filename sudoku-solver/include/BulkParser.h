@@ -0,0 +1,64 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// @brief A record that is not a board
+struct ParseError {
+    /// @brief Byte offset of the offending character, from the start of the buffer
+    uint64_t offset = 0;
+
+    std::string message;
+};
+
+/// @brief The boards of a buffer, in order, and what could not be read
+struct ParseResult {
+    std::vector<std::array<std::array<char, 9>, 9>> boards;
+
+    /// @brief Byte offset of the first character of each board
+    std::vector<uint64_t> offsets;
+
+    std::vector<ParseError> errors;
+};
+
+/**
+ * @brief Read many boards from a buffer, in either of the two formats of the project
+ *
+ * Records are told apart by their first character, so both may be mixed:
+ * - `[` starts a bracketed board, nine rows of nine quoted cells as in input/,
+ *   `[[".","5",...],...]`, spread over any number of lines;
+ * - a digit or `.` starts a line board, 81 characters as in PuzzleFormat, the
+ *   rest of the line being ignored;
+ * - `#` starts a comment running to the end of the line.
+ * Whitespace between records is skipped. Cells are '1' to '9', and '.' or '0'
+ * for an empty cell, always stored as '.'.
+ *
+ * The scan classifies 16 bytes per SSE2 instruction (scalar code elsewhere) into
+ * bit masks: a line board is validated and copied with five vector compares,
+ * and a bracketed board is read by finding every `"x"` cell pattern in 64-byte
+ * windows with shifts and ANDs of the quote and cell-character masks, so only
+ * brackets are visited one at a time. A malformed record is reported with the
+ * offset of the first bad byte and skipped, and parsing goes on with the next one.
+ */
+class BulkParser {
+public:
+    using Board = std::array<std::array<char, 9>, 9>;
+
+    /**
+     * @brief Parse a buffer
+     * @param data The text
+     * @param size Its length in bytes
+     */
+    static ParseResult parse(const char* data, size_t size);
+
+    static ParseResult parse(const std::string& text) { return parse(text.data(), text.size()); }
+
+    /**
+     * @brief Read a whole file and parse it
+     * @throws std::runtime_error If the file can't be read
+     */
+    static ParseResult parseFile(const std::string& path);
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <bitset>
+#include <cstdint>
 #include <list>
 
 /**
@@ -94,6 +95,12 @@ public:
    */
    std::list<int> getRemainingPossiblities() const;
 
+   /**
+    * @brief Get the possible values as a bit mask
+    * @return Bit i (1 through 9) is set if the value could be `i`. Bit 0 is never set
+   */
+   uint16_t getRemainingPossibilitiesMask() const;
+
    /**
     * @brief Sets the value of the cell authoritatively
     * @param i The value of the cell
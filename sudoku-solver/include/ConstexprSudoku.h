@@ -0,0 +1,241 @@
+#pragma once
+
+// The solver needs constexpr std::array access and std::string_view, both C++17.
+// Configure with -DSUDOKU_CXX17=ON to get it; C++14 builds see an empty header.
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#define SUDOKU_HAS_CONSTEXPR_SOLVER 1
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+/**
+ * @brief A solver that runs at compile time
+ *
+ * Boards are solved with the same 9x9 digit masks as everywhere else, but in
+ * plain arrays of integers and without allocation, std::bitset or exceptions
+ * on the solving path, so every function is constexpr. Solving a fixed set of
+ * puzzles in a constexpr variable bakes the solutions into the binary:
+ *
+ *     constexpr auto table = ConstexprSudoku::solveAll(puzzles);
+ *
+ * and known-answer puzzles can be checked with static_assert. The search picks
+ * the cell with the fewest candidates and backtracks with an explicit stack, so
+ * it stays well within the compilers' constant evaluation limits for the
+ * puzzles of input/. Harder ones may need -fconstexpr-ops-limit (GCC),
+ * -fconstexpr-steps (Clang) or /constexpr:steps (MSVC) to be raised. It is
+ * just as usable at run time, but Solution and BitboardSolution are faster there.
+ */
+class ConstexprSudoku {
+public:
+    using Board = std::array<std::array<char, 9>, 9>;
+
+    /// @brief A board and whether it was solved
+    struct Result {
+        bool solved = false;
+
+        /// @brief The solution, or the puzzle unchanged if there is none
+        Board board{};
+    };
+
+    /**
+     * @brief Solve a puzzle
+     * @param puzzle Digits '1'-'9' and '.' for the empty cells
+     * @return solved is false if the givens clash, a cell holds another character or there is no solution
+     */
+    static constexpr Result solve(const Board& puzzle)
+    {
+        Result result;
+        result.board = puzzle;
+
+        std::array<uint16_t, 27> used{}; // Rows, columns then squares, bit d for digit d
+        std::array<uint8_t, 81> empty{};
+        int emptyCount = 0;
+        for (int c = 0; c < 81; c++) {
+            char v = puzzle[c / 9][c % 9];
+            if (v == '.') {
+                empty[emptyCount++] = static_cast<uint8_t>(c);
+                continue;
+            }
+            if (v < '1' || v > '9') return result;
+            uint16_t bit = static_cast<uint16_t>(1u << (v - '0'));
+            if (((used[c / 9] | used[9 + c % 9] | used[18 + square(c)]) & bit) != 0) return result;
+            place(used, c, bit);
+        }
+
+        // One frame per guess: the cell, its untried candidates and the digit placed
+        std::array<uint8_t, 81> cellAt{};
+        std::array<uint16_t, 81> untried{};
+        std::array<uint16_t, 81> placed{};
+        int depth = 0;
+        bool descend = true;
+        for (;;) {
+            if (descend) {
+                if (depth == emptyCount) break;
+
+                // The empty cell with the fewest candidates, moved to position depth
+                int best = depth;
+                int bestCount = 10;
+                uint16_t bestMask = 0;
+                for (int i = depth; i < emptyCount && bestCount > 1; i++) {
+                    uint16_t mask = candidates(used, empty[i]);
+                    int n = popcount(mask);
+                    if (n < bestCount) {
+                        best = i;
+                        bestCount = n;
+                        bestMask = mask;
+                    }
+                }
+                uint8_t swapped = empty[depth];
+                empty[depth] = empty[best];
+                empty[best] = swapped;
+                cellAt[depth] = empty[depth];
+                untried[depth] = bestMask;
+            }
+            else {
+                unplace(used, cellAt[depth], placed[depth]);
+            }
+
+            if (untried[depth] == 0) {
+                if (depth == 0) return result;
+                depth--;
+                descend = false;
+                continue;
+            }
+            uint16_t bit = static_cast<uint16_t>(untried[depth] & (0u - untried[depth]));
+            untried[depth] = static_cast<uint16_t>(untried[depth] & ~bit);
+            placed[depth] = bit;
+            place(used, cellAt[depth], bit);
+            depth++;
+            descend = true;
+        }
+
+        for (int i = 0; i < emptyCount; i++) {
+            int c = cellAt[i];
+            result.board[c / 9][c % 9] = static_cast<char>('0' + lowestDigit(placed[i]));
+        }
+        result.solved = true;
+        return result;
+    }
+
+    /// @brief Solve every puzzle of a table, for solution tables built by the compiler
+    template <size_t N>
+    static constexpr std::array<Result, N> solveAll(const std::array<Board, N>& puzzles)
+    {
+        std::array<Result, N> results{};
+        for (size_t i = 0; i < N; i++) {
+            results[i] = solve(puzzles[i]);
+        }
+        return results;
+    }
+
+    /// @brief Whether every cell holds a digit and no unit repeats one, like SudokuValidator::isSudokuValid
+    static constexpr bool isSolved(const Board& board)
+    {
+        std::array<uint16_t, 27> used{};
+        for (int c = 0; c < 81; c++) {
+            char v = board[c / 9][c % 9];
+            if (v < '1' || v > '9') return false;
+            uint16_t bit = static_cast<uint16_t>(1u << (v - '0'));
+            if (((used[c / 9] | used[9 + c % 9] | used[18 + square(c)]) & bit) != 0) return false;
+            place(used, c, bit);
+        }
+        return true;
+    }
+
+    /// @brief Whether `solution` is solved and keeps every given of `puzzle`
+    static constexpr bool solves(const Board& solution, const Board& puzzle)
+    {
+        for (int c = 0; c < 81; c++) {
+            char given = puzzle[c / 9][c % 9];
+            if (given != '.' && given != solution[c / 9][c % 9]) return false;
+        }
+        return isSolved(solution);
+    }
+
+    /// @brief Cell by cell comparison. std::array's operator== is only constexpr from C++20
+    static constexpr bool equal(const Board& a, const Board& b)
+    {
+        for (int c = 0; c < 81; c++) {
+            if (a[c / 9][c % 9] != b[c / 9][c % 9]) return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Read a board in the line format of PuzzleFormat: 81 characters, '.' or '0' for an empty cell
+     * @throws std::invalid_argument If the line is not a board; a compile error when evaluated at compile time
+     */
+    static constexpr Board fromLine(std::string_view line)
+    {
+        if (line.size() < 81) throw std::invalid_argument("A board line has 81 cells");
+        Board board{};
+        for (int c = 0; c < 81; c++) {
+            char v = line[c];
+            if (v == '0') v = '.';
+            if (v != '.' && (v < '1' || v > '9')) throw std::invalid_argument("A board line holds digits and dots");
+            board[c / 9][c % 9] = v;
+        }
+        return board;
+    }
+
+    /**
+     * @brief Read a board in the format of the files in input/, the one main.cpp reads
+     * @param text Nine rows of nine quoted cells, like [["5","3",".",...],...]
+     * @throws std::invalid_argument If there are not 81 quoted cells; a compile error when evaluated at compile time
+     */
+    static constexpr Board fromArrayText(std::string_view text)
+    {
+        Board board{};
+        int c = 0;
+        for (size_t i = 0; i + 2 < text.size(); i++) {
+            if (text[i] != '"' || text[i + 2] != '"') continue;
+            if (c == 81) throw std::invalid_argument("A board has 81 cells");
+            board[c / 9][c % 9] = text[i + 1];
+            c++;
+            i += 2;
+        }
+        if (c != 81) throw std::invalid_argument("A board has 81 cells");
+        return board;
+    }
+
+private:
+    static constexpr int square(int c) { return (c / 27) * 3 + (c % 9) / 3; }
+
+    static constexpr void place(std::array<uint16_t, 27>& used, int c, uint16_t bit)
+    {
+        used[c / 9] |= bit;
+        used[9 + c % 9] |= bit;
+        used[18 + square(c)] |= bit;
+    }
+
+    static constexpr void unplace(std::array<uint16_t, 27>& used, int c, uint16_t bit)
+    {
+        used[c / 9] &= static_cast<uint16_t>(~bit);
+        used[9 + c % 9] &= static_cast<uint16_t>(~bit);
+        used[18 + square(c)] &= static_cast<uint16_t>(~bit);
+    }
+
+    static constexpr uint16_t candidates(const std::array<uint16_t, 27>& used, int c)
+    {
+        return static_cast<uint16_t>(0x3FE & ~(used[c / 9] | used[9 + c % 9] | used[18 + square(c)]));
+    }
+
+    static constexpr int popcount(uint16_t x)
+    {
+        int n = 0;
+        for (; x != 0; x = static_cast<uint16_t>(x & (x - 1))) n++;
+        return n;
+    }
+
+    static constexpr int lowestDigit(uint16_t bit)
+    {
+        int d = 0;
+        while ((bit >> d) != 1) d++;
+        return d;
+    }
+};
+
+#endif
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// @brief Cells whose digits are all different and add up to `sum`
+struct Cage {
+    std::vector<uint8_t> cells;
+    int sum = 0;
+};
+
+/**
+ * @brief The rules of a 9x9 variant, before compilation
+ *
+ * Every unit is nine cells holding the digits 1 through 9 once each. Cells are
+ * numbered row by row, from 0 to 80.
+ */
+struct RuleSet {
+    std::vector<std::array<uint8_t, 9>> units;
+    std::vector<Cage> cages;
+
+    /// @brief Rows, columns and 3x3 squares
+    static RuleSet classic();
+
+    /// @brief Classic plus both main diagonals (X-Sudoku)
+    static RuleSet diagonal();
+
+    /**
+     * @brief Rows, columns and nine irregular regions
+     * @param regions 81 characters, the same character for the cells of one region
+     * @throws std::invalid_argument If there are not nine regions of nine cells
+     */
+    static RuleSet jigsaw(const std::string& regions);
+
+    /**
+     * @brief Classic plus sum cages
+     * @param cages The cages. They need not cover the board
+     */
+    static RuleSet killer(std::vector<Cage> cages);
+};
+
+/**
+ * @brief A RuleSet compiled into flat tables for the solver
+ *
+ * The peers of a cell, every cell sharing a unit or a cage with it, are stored
+ * back to back in one array, so propagating a value is a single loop over a
+ * contiguous range whatever the variant. Cages are kept in the same layout.
+ * Compile a RuleSet once and share the graph between solvers: it is immutable.
+ */
+class ConstraintGraph {
+public:
+    static const size_t CELLS = 81;
+
+    /// @brief A contiguous run of cell or cage indices
+    template <class T>
+    struct Range {
+        const T* first;
+        const T* last;
+        const T* begin() const { return first; }
+        const T* end() const { return last; }
+        size_t size() const { return static_cast<size_t>(last - first); }
+    };
+
+    /// @brief A cage after compilation
+    struct CompiledCage {
+        /// @brief Offset of its cells in the cage cell table
+        uint16_t offset;
+        uint8_t size;
+        uint8_t sum;
+    };
+
+    /**
+     * @brief Compile the rules
+     * @param rules The units and cages
+     * @throws std::invalid_argument If a unit or cage names a cell twice or outside the board, or a cage sum can't be reached
+     */
+    explicit ConstraintGraph(const RuleSet& rules);
+
+    /// @brief The graph of the classic rules, shared by every solver that is not given one
+    static const ConstraintGraph& classic();
+
+    /// @brief Every cell sharing a unit or a cage with `cell`, in increasing order
+    Range<uint8_t> peers(int cell) const
+    {
+        return Range<uint8_t>{ peerList.data() + peerStart[cell], peerList.data() + peerStart[cell + 1] };
+    }
+
+    /// @brief Indices of the cages containing `cell`
+    Range<uint16_t> cagesOf(int cell) const
+    {
+        return Range<uint16_t>{ cageIndex.data() + cageStart[cell], cageIndex.data() + cageStart[cell + 1] };
+    }
+
+    const CompiledCage& cage(size_t k) const { return cages[k]; }
+
+    /// @brief The cells of cage `k`
+    Range<uint8_t> cageCells(size_t k) const
+    {
+        return Range<uint8_t>{ cageCellList.data() + cages[k].offset, cageCellList.data() + cages[k].offset + cages[k].size };
+    }
+
+    size_t cageCount() const { return cages.size(); }
+
+    const std::vector<std::array<uint8_t, 9>>& getUnits() const { return units; }
+
+    /**
+     * @brief Digits that can complete a cage
+     * @param count Empty cells of the cage
+     * @param sum What they must add up to
+     * @param used Digits already placed in the cage, bit d for digit d
+     * @param available Candidates of the empty cells, bit d for digit d
+     * @return Union of every set of `count` distinct digits adding up to `sum` drawn from available and not used
+     */
+    static uint16_t cageDigits(int count, int sum, uint16_t used, uint16_t available);
+
+private:
+    std::vector<std::array<uint8_t, 9>> units;
+    std::array<uint16_t, CELLS + 1> peerStart;
+    std::vector<uint8_t> peerList;
+    std::array<uint16_t, CELLS + 1> cageStart;
+    std::vector<uint16_t> cageIndex;
+    std::vector<CompiledCage> cages;
+    std::vector<uint8_t> cageCellList;
+};
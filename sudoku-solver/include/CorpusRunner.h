@@ -0,0 +1,171 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+/// @brief A contiguous run of lines of the corpus, solved as one unit of work
+struct CorpusShard {
+    /// @brief Byte offset of its first line in the input
+    uint64_t offset = 0;
+
+    /// @brief Lines it spans, comments and blank lines included
+    uint64_t lines = 0;
+};
+
+/**
+ * @brief How a corpus is cut into shards
+ *
+ * Stored as `plan` in the run directory. The cut only depends on the input and
+ * the shard size, so planning the same file twice gives the same shards.
+ */
+struct CorpusPlan {
+    /// @brief Path of the input, as every worker sees it
+    std::string input;
+
+    std::vector<CorpusShard> shards;
+};
+
+/// @brief Counters of some shards
+struct CorpusStats {
+    uint64_t puzzles = 0;
+    uint64_t solved = 0;
+    uint64_t unsolvable = 0;
+    uint64_t overBudget = 0;
+
+    /// @brief Lines that are not a puzzle
+    uint64_t invalid = 0;
+
+    /// @brief Wall-clock time spent solving, summed over the workers
+    std::chrono::nanoseconds solveTime = std::chrono::nanoseconds::zero();
+
+    CorpusStats& operator+=(const CorpusStats& o);
+};
+
+/// @brief Settings of a worker
+struct CorpusOptions {
+    /// @brief Solver threads. 0 uses std::thread::hardware_concurrency
+    unsigned threads = 0;
+
+    /// @brief Puzzles solved between two checkpoints
+    size_t checkpointEvery = 1000;
+
+    /// @brief A claim not refreshed for this long belongs to a dead worker and may be taken over
+    std::chrono::seconds lease = std::chrono::seconds(600);
+
+    /// @brief Node budget of each puzzle
+    uint64_t maxNodes = std::numeric_limits<uint64_t>::max();
+
+    /// @brief Name written in the claims of this worker. Empty picks a random one
+    std::string worker;
+};
+
+/// @brief Where a shard stands
+enum class ShardState {
+    Pending,
+    Claimed,
+    Done
+};
+
+/**
+ * @brief Solve a corpus too big for one run, with any number of workers sharing a directory
+ *
+ * plan cuts the input into shards. Each worker then loops over the shards and
+ * claims a free one by creating `shard-K.claim` exclusively, so two workers,
+ * even on different hosts of a shared filesystem, never solve the same shard.
+ * Results are appended to `shard-K.out` and, every checkpointEvery puzzles,
+ * the line reached and the counters are written to `shard-K.progress` through
+ * a temporary file and a rename, so the checkpoint is either the old or the new
+ * one. A worker that dies leaves its claim and progress behind: once the lease
+ * has expired, the next worker takes the shard over, drops the output written
+ * after the last checkpoint and resumes from it. The claim is refreshed every
+ * quarter of the lease while a chunk is solved, and a worker checks that it
+ * still owns the shard before writing anything. A finished shard becomes
+ * `shard-K.done`. merge concatenates the checkpointed part of every output in
+ * shard order.
+ *
+ * Claims carry the time they were last refreshed, so the clocks of the hosts
+ * must roughly agree compared to the lease.
+ *
+ * The result lines are those of sudoku-pipeline: the solution, the puzzle
+ * followed by " unsolvable" or " budget", or "invalid".
+ */
+class CorpusRunner {
+public:
+    /**
+     * @param directory Run directory, created by plan
+     * @param options Settings of this worker
+     */
+    explicit CorpusRunner(const std::string& directory, const CorpusOptions& options = CorpusOptions());
+
+    /**
+     * @brief Cut a corpus into shards and start a run directory
+     * @param input The corpus, one puzzle per line
+     * @param directory Created if missing. Must not hold a plan yet
+     * @param linesPerShard Lines of each shard, the last one may be shorter
+     * @return The plan
+     * @throws std::runtime_error If the input can't be read or the directory already holds a plan
+     */
+    static CorpusPlan plan(const std::string& input, const std::string& directory, uint64_t linesPerShard);
+
+    /// @brief Read the plan of the run directory
+    CorpusPlan loadPlan() const;
+
+    /**
+     * @brief Claim and solve shards until none is left to claim
+     * @return Number of shards this call finished
+     * @throws std::runtime_error If the run directory or the input can't be read or written
+     */
+    size_t work();
+
+    /// @brief State of every shard
+    std::vector<ShardState> status() const;
+
+    /// @brief Counters of the finished shards
+    CorpusStats finishedStats() const;
+
+    /**
+     * @brief Write the results of every shard, in input order
+     * @param output File receiving the results. Replaced at once when complete
+     * @return Counters over the whole corpus
+     * @throws std::runtime_error If a shard is not done
+     */
+    CorpusStats merge(const std::string& output) const;
+
+private:
+    /// @brief What a checkpoint records
+    struct Progress {
+        /// @brief Lines of the shard already handled
+        uint64_t next = 0;
+
+        /// @brief Size of the shard output matching `next`
+        uint64_t bytes = 0;
+
+        CorpusStats stats;
+    };
+
+    std::string directory;
+    CorpusOptions options;
+
+    std::string pathOf(size_t shard, const char* suffix) const;
+
+    /// @brief Create the claim of a shard, or take over an expired one
+    bool claim(size_t shard);
+
+    /// @brief Write the claim again with the current time
+    void refreshClaim(size_t shard);
+
+    /// @brief Check that the claim of a shard is still this worker's
+    bool ownsClaim(size_t shard) const;
+
+    /**
+     * @brief Solve a claimed shard from its last checkpoint
+     * @return false If another worker took the shard over meanwhile
+     */
+    bool solveShard(size_t shard, const CorpusShard& range, const std::string& input);
+
+    static bool readProgress(const std::string& path, Progress& progress);
+    void writeProgress(const std::string& path, const Progress& progress) const;
+};
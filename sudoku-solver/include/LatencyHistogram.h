@@ -0,0 +1,80 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Counts of latencies over a wide range at a fixed relative precision
+ *
+ * A high-dynamic-range histogram: values are bucketed by their power of two,
+ * and every power of two is split into enough linear sub-buckets to keep
+ * `significantDigits` decimal digits. Recording is an index computation and an
+ * increment, whatever the value, so a nanosecond and an hour cost the same, and
+ * the memory used only depends on the range and the precision (about 270 KB for
+ * three digits up to an hour).
+ */
+class LatencyHistogram {
+public:
+    /**
+     * @param highest Largest value kept exactly, larger ones are counted as this one
+     * @param significantDigits Precision of every recorded value, 1 to 5
+     * @throws std::invalid_argument If the precision is out of range or highest is below 2
+     */
+    explicit LatencyHistogram(uint64_t highest = 3600000000000ULL, int significantDigits = 3);
+
+    /// @brief Count one value
+    void record(uint64_t value)
+    {
+        if (value > highest) value = highest;
+        counts[indexOf(value)]++;
+        total++;
+        sum += value;
+        if (value < smallest) smallest = value;
+        if (value > largest) largest = value;
+    }
+
+    void record(std::chrono::nanoseconds value) { record(static_cast<uint64_t>(value.count() < 0 ? 0 : value.count())); }
+
+    /**
+     * @brief Add the counts of another histogram
+     * @throws std::invalid_argument If its range or precision differ
+     */
+    void add(const LatencyHistogram& o);
+
+    void reset();
+
+    uint64_t count() const { return total; }
+
+    /// @brief Smallest recorded value, 0 when empty
+    uint64_t min() const { return total == 0 ? 0 : smallest; }
+
+    /// @brief Largest recorded value, exact
+    uint64_t max() const { return largest; }
+
+    double mean() const { return total == 0 ? 0.0 : static_cast<double>(sum) / static_cast<double>(total); }
+
+    /**
+     * @brief Value that `percentile` percent of the recorded values are at or below
+     * @param percentile 0 to 100
+     * @return The highest value of the bucket holding that rank, so never below the true one, and at most max()
+     */
+    uint64_t valueAtPercentile(double percentile) const;
+
+private:
+    uint64_t highest;
+    int subBucketHalfCountMagnitude;
+    uint64_t subBucketHalfCount;
+    uint64_t subBucketMask;
+    std::vector<uint64_t> counts;
+
+    uint64_t total = 0;
+    uint64_t sum = 0;
+    uint64_t smallest = UINT64_MAX;
+    uint64_t largest = 0;
+
+    size_t indexOf(uint64_t value) const;
+
+    /// @brief Largest value counted at `index`
+    uint64_t highestValueAt(size_t index) const;
+};
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "LatencyHistogram.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/// @brief Where the puzzles of a replay are solved
+enum class ReplayMode {
+    /// @brief On the thread issuing the arrivals, one at a time
+    Inline,
+    /// @brief On an AsyncSolver pool fed by the arrival thread
+    Pool
+};
+
+/// @brief Settings of a LoadReplay run
+struct ReplayConfig {
+    /// @brief Puzzles arriving per second
+    double rate = 1000;
+
+    ReplayMode mode = ReplayMode::Pool;
+
+    /// @brief Workers of the pool. 0 uses std::thread::hardware_concurrency
+    unsigned threads = 0;
+
+    /// @brief Arrivals in total, cycling over the corpus. 0 sends every puzzle once
+    uint64_t requests = 0;
+
+    /// @brief Node budget of each puzzle
+    uint64_t maxNodesPerPuzzle = std::numeric_limits<uint64_t>::max();
+};
+
+/// @brief What a replay measured, latencies in nanoseconds
+struct ReplayStats {
+    /**
+     * @brief From the time a puzzle was due to arrive to the end of its solve
+     *
+     * This is the latency a client sending at the configured rate would see,
+     * queueing included, and the one to hold against an SLO.
+     */
+    LatencyHistogram response;
+
+    /// @brief Solve time alone, without the wait in front of it
+    LatencyHistogram service;
+
+    uint64_t sent = 0;
+    uint64_t solved = 0;
+    uint64_t unsolvable = 0;
+    uint64_t overBudget = 0;
+
+    /// @brief From the first arrival to the last completion
+    std::chrono::nanoseconds elapsed = std::chrono::nanoseconds::zero();
+
+    /// @brief Furthest the arrival thread fell behind its schedule
+    std::chrono::nanoseconds maxSendLag = std::chrono::nanoseconds::zero();
+
+    /// @brief Completions per second over the run
+    double throughput() const
+    {
+        return elapsed.count() == 0 ? 0.0 : static_cast<double>(sent) * 1e9 / static_cast<double>(elapsed.count());
+    }
+};
+
+/**
+ * @brief Feed a corpus to the solver at a fixed arrival rate and measure the latencies
+ *
+ * The load is open loop: puzzle i is due at start + i / rate whatever happened
+ * to the earlier ones, like requests from independent clients. A closed-loop
+ * benchmark that waits for each answer before sending the next one stops
+ * sending exactly when the solver stalls, so the stall shows up in a single
+ * sample and the tail looks far better than what clients experience
+ * (coordinated omission). Here every response latency is measured from the due
+ * time rather than from the actual send or solve start, so a stall is charged
+ * to every puzzle that should have arrived during it, including in Inline mode
+ * where the arrival thread itself is the one stalled.
+ */
+class LoadReplay {
+public:
+    using Board = std::array<std::array<char, 9>, 9>;
+
+    /// @throws std::invalid_argument If the rate is not positive
+    explicit LoadReplay(const ReplayConfig& config);
+
+    /**
+     * @brief Replay the corpus and wait for the last answer
+     * @param corpus The puzzles, sent in order
+     */
+    ReplayStats run(const std::vector<Board>& corpus);
+
+private:
+    ReplayConfig config;
+};
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "SolveOptions.h"
+#include "sudoku-solver.h"
+
+/// @brief Counters of a LockstepSolver
+struct LockstepStats {
+    /// @brief Boards finished by lockstep propagation alone
+    uint64_t solvedInLockstep = 0;
+
+    /// @brief Boards found inconsistent by lockstep propagation
+    uint64_t unsolvableInLockstep = 0;
+
+    /// @brief Boards that needed a guess and went through Solution
+    uint64_t fellBack = 0;
+};
+
+/**
+ * @brief Propagate several boards at once, one board per vector lane
+ *
+ * Candidates are stored structure-of-arrays: for every cell, one 16 bit mask per
+ * lane. Naked and hidden singles are applied to all lanes with the same loops,
+ * whose innermost dimension is the lane, so the compiler turns them into vector
+ * instructions without any branch on the contents of a lane. A lane that ends up
+ * needing a guess is handed to the scalar Solution, starting from the cells the
+ * lockstep pass already found.
+ *
+ * Works best on large batches of easy and medium puzzles, which rarely need a guess.
+ */
+class LockstepSolver {
+public:
+    using Board = std::array<std::array<char, 9>, 9>;
+
+    /// @brief Number of boards propagated together. 8 masks fill a 128 bit register
+    static const size_t LANES = 8;
+
+    /**
+     * @brief Solve boards in place
+     * @param boards The boards. Solved boards are overwritten, the others are left untouched
+     * @param count Number of boards
+     * @param statuses Receives one status per board
+     */
+    void solve(Board* boards, size_t count, SolveStatus* statuses);
+
+    /**
+     * @brief Solve boards in place
+     * @param boards The boards. Solved boards are overwritten, the others are left untouched
+     * @return One status per board
+     */
+    std::vector<SolveStatus> solve(std::vector<Board>& boards);
+
+    /// @brief Get the counters accumulated since construction
+    const LockstepStats& getStats() const;
+
+private:
+    /// @brief Candidates of every cell, bit d set if digit d is possible, one mask per lane
+    alignas(16) std::array<std::array<uint16_t, LANES>, 81> candidates;
+
+    /// @brief Singles already removed from the peers, per cell and lane
+    alignas(16) std::array<std::array<uint16_t, LANES>, 81> propagated;
+
+    /// @brief Fallback for lanes that need a guess
+    Solution scalar;
+
+    LockstepStats stats;
+
+    /**
+     * @brief Load up to LANES boards. Missing lanes hold a board with no givens that never changes
+     * @param boards First board of the group
+     * @param count Boards in the group
+     */
+    void load(const Board* boards, size_t count);
+
+    /**
+     * @brief Remove naked singles from their peers in every lane
+     * @return true If any lane changed
+     */
+    bool eliminateSingles();
+
+    /**
+     * @brief Place digits that have a single spot left in a unit, in every lane
+     * @return true If any lane changed
+     */
+    bool placeHiddenSingles();
+};
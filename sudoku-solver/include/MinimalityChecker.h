@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "Bitboard.h"
+#include "BitboardSolution.h"
+
+/// @brief What to do with each puzzle
+enum class MinimalityMode {
+    /// Find every clue that can be removed alone
+    Check,
+    /// Remove clues in reading order as long as the solution stays unique
+    Reduce
+};
+
+/// @brief What MinimalityChecker found out about a puzzle
+struct MinimalityResult {
+    using Board = std::array<std::array<char, 9>, 9>;
+
+    /// @brief Solutions of the puzzle, counted up to 2. The other members are only filled in when it is 1
+    uint32_t solutions = 0;
+
+    /**
+     * @brief Cells of the redundant clues, in reading order
+     *
+     * When checking, every clue whose removal alone keeps the solution unique.
+     * When reducing, the clues that were removed.
+     */
+    std::vector<uint8_t> redundant;
+
+    /// @brief The puzzle, without the redundant clues when reducing
+    Board puzzle;
+
+    /// @brief Searches for a second solution, one per clue tried
+    uint32_t trials = 0;
+
+    /// @brief Backtrack nodes of those searches
+    uint64_t nodes = 0;
+
+    /// @brief True if the solution is unique and no clue can be removed
+    bool isMinimal() const { return solutions == 1 && redundant.empty(); }
+};
+
+/**
+ * @brief Check that puzzles are minimal, or strip them down to a minimal clue set
+ *
+ * A puzzle is minimal if removing any clue allows a second solution. Such a
+ * solution differs from the known one at the removed cell, so each clue costs
+ * one search for a solution that avoids the clue's digit there, instead of a
+ * count of the solutions from scratch.
+ *
+ * The states the searches start from are built divide and conquer: the clues
+ * to try are split in two halves, the clues of one half are assigned and
+ * propagated on top of the state shared by both, and the other half recurses
+ * from there. Every state is a copy of its parent plus half of the clues, so a
+ * puzzle of n clues takes about n log n assignments instead of n^2.
+ *
+ * Reducing walks the clues in reading order and drops every clue whose search
+ * finds no second solution. A clue needed once stays needed with fewer clues,
+ * so one pass gives a minimal puzzle.
+ */
+class MinimalityChecker {
+public:
+    using Board = std::array<std::array<char, 9>, 9>;
+
+    /**
+     * @brief Check or reduce one puzzle
+     * @param puzzle Digits '1'-'9', anything else is an empty cell
+     * @param mode Check or Reduce
+     * @return The result
+     */
+    MinimalityResult run(const Board& puzzle, MinimalityMode mode);
+
+    /**
+     * @brief Check or reduce many puzzles on several threads
+     * @param puzzles The puzzles
+     * @param mode Check or Reduce
+     * @param threads Number of threads. 0 uses std::thread::hardware_concurrency
+     * @return One result per puzzle, in the same order
+     */
+    static std::vector<MinimalityResult> runAll(const std::vector<Board>& puzzles, MinimalityMode mode, unsigned threads = 0);
+
+private:
+    /// @brief Searches for the second solutions, reused from one trial to the next
+    BitboardSolution solver;
+
+    /// @brief Digit of every cell in the solution
+    std::array<uint8_t, 81> solution;
+
+    /// @brief Clues still in the puzzle: all of them when checking, the ones not dropped yet when reducing
+    Bitboard81 kept;
+
+    MinimalityMode mode;
+    MinimalityResult* result;
+
+    /**
+     * @brief Try the clues of a range, starting from a state holding every other clue kept so far
+     * @param clues Cells of the clues to try
+     * @param count Number of clues in the range
+     * @param base Propagated state of the kept clues outside the range
+     */
+    void tryClues(const uint8_t* clues, size_t count, const BitboardState& base);
+
+    /**
+     * @brief Whether the puzzle minus one clue has another solution
+     * @param cell The removed clue
+     * @param base Propagated state of every other kept clue
+     */
+    bool hasOtherSolution(int cell, const BitboardState& base);
+};
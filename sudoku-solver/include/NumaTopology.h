@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/// @brief One NUMA node and the CPUs of it this process may run on
+struct NumaNode {
+    int id = 0;
+    std::vector<int> cpus;
+};
+
+/**
+ * @brief The NUMA nodes of the machine, read from /sys on Linux
+ *
+ * Only the CPUs in the affinity mask of the process are listed, so a
+ * container or a taskset restriction is honoured. Without NUMA information
+ * (another OS, or a kernel without /sys/devices/system/node) the whole
+ * machine is one node.
+ */
+class NumaTopology {
+public:
+    /**
+     * @brief Describe a topology explicitly
+     * @param nodes The nodes. Nodes without CPUs are dropped, and an empty list becomes one node with CPU 0
+     */
+    explicit NumaTopology(std::vector<NumaNode> nodes);
+
+    /// @brief Topology of the machine this process runs on
+    static NumaTopology detect();
+
+    const std::vector<NumaNode>& getNodes() const;
+
+    /// @brief CPUs over every node
+    size_t cpuCount() const;
+
+    /**
+     * @brief Parse a kernel CPU list such as "0-3,8,10-11"
+     * @param text The list
+     * @param cpus Receives the CPUs in the order listed
+     * @return false If the text is not a CPU list
+     */
+    static bool parseCpuList(const std::string& text, std::vector<int>& cpus);
+
+    /**
+     * @brief Restrict the calling thread to one CPU
+     * @param cpu The CPU
+     * @return false If the OS refused or does not support pinning
+     */
+    static bool pinThisThread(int cpu);
+
+private:
+    std::vector<NumaNode> nodes;
+};
+
+/**
+ * @brief Bump allocator whose memory lives on the NUMA node of the thread that grew it
+ *
+ * Linux places a page on the node of the thread that first writes it. The
+ * arena zeroes every block as soon as it is allocated, so when the threads
+ * allocating from it are pinned to one node, so is its memory. Everything is
+ * freed at once by release or the destructor, so only trivially destructible
+ * types may be allocated. Safe to use from several threads.
+ */
+class NodeArena {
+public:
+    /// @param blockSize Bytes reserved at a time. Bigger requests get a block of their own
+    explicit NodeArena(size_t blockSize = size_t(1) << 20);
+    ~NodeArena();
+
+    NodeArena(const NodeArena&) = delete;
+    NodeArena& operator=(const NodeArena&) = delete;
+
+    /**
+     * @brief Reserve zeroed memory
+     * @param bytes Size of the allocation
+     * @param alignment A power of two, at most alignof(std::max_align_t)
+     * @return The memory, nullptr for 0 bytes. Throws std::bad_alloc when the system runs out
+     */
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+    /// @brief Reserve `count` zeroed objects of type T
+    template <class T>
+    T* allocateArray(size_t count)
+    {
+        static_assert(std::is_trivially_destructible<T>::value, "The arena never runs destructors");
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    /// @brief Free every block. Pointers handed out before become invalid
+    void release();
+
+    /// @brief Bytes of all the blocks held
+    size_t reserved() const;
+
+private:
+    struct Block {
+        char* data;
+        size_t size;
+    };
+
+    mutable std::mutex mutex;
+    std::vector<Block> blocks;
+    size_t blockSize;
+
+    /// @brief Bytes used in the last block
+    size_t used = 0;
+};
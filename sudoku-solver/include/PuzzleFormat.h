@@ -0,0 +1,34 @@
+#pragma once
+
+#include <array>
+#include <string>
+
+/**
+ * @brief Convert boards to and from the 81 character line format
+ *
+ * A line holds the cells row by row. Digits are givens, '.' (or '0' when reading)
+ * is an empty cell.
+ */
+class PuzzleFormat
+{
+public:
+    using Board = std::array<std::array<char, 9>, 9>;
+
+    /// @brief Number of characters of a board in the line format
+    static const size_t LINE_LENGTH = 81;
+
+    /**
+     * @brief Write a board as a single line
+     * @param board The board to write
+     * @return 81 characters, without a line ending
+     */
+    static std::string toLine(const Board& board);
+
+    /**
+     * @brief Read a board from a line
+     * @param line At least 81 characters. Anything after them is ignored
+     * @param board Receives the board
+     * @return false If the line is too short or holds a character that is not a digit or '.'
+     */
+    static bool fromLine(const std::string& line, Board& board);
+};
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <random>
+
+#include "SolveOptions.h"
+
+/// @brief Difficulty grade of a puzzle, from the work the solver needs for it
+enum class Difficulty {
+    /// Solved by constraint propagation alone
+    Easy,
+    /// Needs a handful of guesses
+    Medium,
+    /// Needs a few dozen guesses
+    Hard,
+    /// Needs more guesses than Hard
+    Expert
+};
+
+/// @brief A puzzle with a unique solution, and how hard it is
+struct GeneratedPuzzle {
+    std::array<std::array<char, 9>, 9> puzzle;
+    std::array<std::array<char, 9>, 9> solution;
+    int clues;
+    Difficulty difficulty;
+    /// @brief Backtrack nodes the solver needed for the puzzle
+    uint64_t nodes;
+};
+
+/**
+ * @brief Build puzzles with a unique solution
+ *
+ * A random full grid is built by solving a shuffled first row and applying
+ * random symmetries (digit relabelling, row and column swaps within bands and
+ * stacks, band and stack swaps, transposition). Clues are then removed in a
+ * random order, putting a clue back whenever Solution::countSolutions finds that
+ * removing it allows a second solution, or when a difficulty is targeted and the
+ * puzzle would grade above it.
+ *
+ * A generator is deterministic for a given seed.
+ */
+class PuzzleGenerator {
+public:
+    using Board = std::array<std::array<char, 9>, 9>;
+
+    /**
+     * @brief Create a generator
+     * @param seed Seed of the random number generator
+     */
+    explicit PuzzleGenerator(uint64_t seed);
+
+    /**
+     * @brief Build a random, completely filled, valid grid
+     * @return The grid
+     */
+    Board randomSolvedGrid();
+
+    /**
+     * @brief Build one puzzle with a unique solution, of whatever difficulty comes out
+     * @return The puzzle
+     */
+    GeneratedPuzzle generate();
+
+    /**
+     * @brief Build puzzles until one has the requested difficulty
+     *
+     * Clue removal stops short of going above `target`, so only puzzles that end
+     * up easier than it are rejected.
+     * @param target Difficulty to reach
+     * @param maxAttempts Number of puzzles to build before giving up
+     * @param result Receives the puzzle
+     * @return false If no puzzle of that difficulty came out in `maxAttempts` tries
+     */
+    bool generate(Difficulty target, unsigned maxAttempts, GeneratedPuzzle& result);
+
+    /**
+     * @brief Grade a puzzle by solving it
+     * @param puzzle The puzzle to grade
+     * @param stats If not nullptr, receives the statistics of the solve
+     * @return The difficulty
+     */
+    static Difficulty grade(const Board& puzzle, SolveStats* stats = nullptr);
+
+    /**
+     * @brief Build puzzles on several threads
+     *
+     * Each thread runs its own generator seeded from `seed` and its index. `sink`
+     * is called under a lock, in no particular order. Every thread stops once the
+     * threads together have built `maxAttempts` puzzles, so a difficulty that is
+     * rare or out of reach does not keep them busy forever.
+     *
+     * @param count Number of puzzles to deliver
+     * @param target Difficulty of every puzzle
+     * @param threadCount Number of threads. 0 uses std::thread::hardware_concurrency
+     * @param seed Base seed
+     * @param sink Receives every puzzle
+     * @param maxAttempts Puzzles built over all threads, those of another difficulty included
+     * @return Number of puzzles delivered, below `count` if the attempts ran out
+     */
+    static uint64_t generateParallel(uint64_t count, Difficulty target, unsigned threadCount, uint64_t seed,
+                                     const std::function<void(const GeneratedPuzzle&)>& sink,
+                                     uint64_t maxAttempts = std::numeric_limits<uint64_t>::max());
+
+    /**
+     * @brief Name of a difficulty, as used on the command line
+     * @param d The difficulty
+     * @return "easy", "medium", "hard" or "expert"
+     */
+    static const char* difficultyName(Difficulty d);
+
+    /**
+     * @brief Parse the name of a difficulty
+     * @param name "easy", "medium", "hard" or "expert"
+     * @param d Receives the difficulty
+     * @return false If the name is not known
+     */
+    static bool parseDifficulty(const char* name, Difficulty& d);
+
+private:
+    std::mt19937_64 rng;
+
+    /// @brief Random integer in [0, n)
+    int randomBelow(int n);
+
+    /**
+     * @brief Remove clues from a random grid while the solution stays unique
+     * @param ceiling Removals that would make the puzzle harder than this are undone
+     * @return The puzzle, graded
+     */
+    GeneratedPuzzle carve(Difficulty ceiling);
+};
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+/**
+ * @brief Bounded lock-free queue for any number of producers and consumers
+ *
+ * Each slot carries a sequence number telling whose turn it is: a producer may
+ * fill slot i when its sequence equals the position being claimed, a consumer may
+ * empty it when the sequence is one past that. Claiming a position is a single
+ * compare-and-swap on the head or the tail, so threads never block each other.
+ * A full queue refuses the push, which is how the pipeline applies backpressure.
+ *
+ * @tparam T Type of the elements. It must be default constructible and movable
+ */
+template <typename T>
+class RingBuffer {
+public:
+    /**
+     * @brief Allocate the slots
+     * @param capacity Number of slots, a power of two of at least 2
+     * @throws std::invalid_argument If the capacity is not a power of two
+     */
+    explicit RingBuffer(size_t capacity)
+        : mask(capacity - 1)
+    {
+        if (capacity < 2 || (capacity & (capacity - 1)) != 0) {
+            throw std::invalid_argument("RingBuffer capacity must be a power of two");
+        }
+        slots.reset(new Slot[capacity]);
+        for (size_t i = 0; i < capacity; i++) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    /**
+     * @brief Add an element if there is room
+     * @param value Moved into the queue on success, left untouched otherwise
+     * @return false If the queue is full
+     */
+    bool tryPush(T& value)
+    {
+        size_t pos = tail.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& s = slots[pos & mask];
+            size_t seq = s.sequence.load(std::memory_order_acquire);
+            if (seq == pos) {
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    s.value = std::move(value);
+                    s.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (seq < pos) {
+                return false; // The consumer of the previous lap has not emptied the slot yet
+            }
+            else {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Take the oldest element if there is one
+     * @param value Receives the element
+     * @return false If the queue is empty
+     */
+    bool tryPop(T& value)
+    {
+        size_t pos = head.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& s = slots[pos & mask];
+            size_t seq = s.sequence.load(std::memory_order_acquire);
+            if (seq == pos + 1) {
+                if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    value = std::move(s.value);
+                    s.sequence.store(pos + mask + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (seq < pos + 1) {
+                return false;
+            }
+            else {
+                pos = head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// @brief Number of elements, only exact while no other thread uses the queue
+    size_t sizeApprox() const
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t h = head.load(std::memory_order_relaxed);
+        return t > h ? t - h : 0;
+    }
+
+    /// @brief Number of slots
+    size_t capacity() const { return mask + 1; }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    const size_t mask;
+    std::unique_ptr<Slot[]> slots;
+
+    // Padded onto separate cache lines so producers and consumers do not contend.
+    // Padding rather than alignas, since C++14 new ignores over-alignment
+    char padTail[64];
+    std::atomic<size_t> tail{ 0 };
+    char padHead[64 - sizeof(std::atomic<size_t>)];
+    std::atomic<size_t> head{ 0 };
+    char padEnd[64 - sizeof(std::atomic<size_t>)];
+};
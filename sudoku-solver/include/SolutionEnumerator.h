@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <limits>
+
+/// @brief How enumerated solutions are encoded
+enum class SolutionFormat {
+    /// @brief 81 digits and a '\n', the line format of PuzzleFormat
+    Line,
+    /// @brief 41 bytes, two cells per byte: cell 2k in the low nibble of byte k, cell 2k+1 in the high one
+    Binary
+};
+
+/// @brief Settings of an enumeration
+struct EnumerateOptions {
+    /// @brief Worker threads. 0 uses std::thread::hardware_concurrency
+    unsigned threads = 0;
+
+    /// @brief Stop after this many solutions
+    uint64_t limit = std::numeric_limits<uint64_t>::max();
+
+    SolutionFormat format = SolutionFormat::Line;
+
+    /// @brief Subtrees cut per thread, more of them balance the load better
+    size_t piecesPerThread = 64;
+};
+
+/// @brief Counters of an enumeration
+struct EnumerateStats {
+    /// @brief Solutions handed to the sink
+    uint64_t solutions = 0;
+
+    /// @brief Values tried by the workers
+    uint64_t nodes = 0;
+
+    /// @brief Subtrees the search was cut into
+    uint64_t pieces = 0;
+
+    std::chrono::nanoseconds elapsed = std::chrono::nanoseconds::zero();
+};
+
+/// @brief Receives the encoded solutions of an enumeration
+class SolutionSink {
+public:
+    virtual ~SolutionSink() = default;
+
+    /**
+     * @brief Take a block of solutions
+     * @param data `count` encoded solutions back to back
+     * @param size Bytes of data
+     * @param count Solutions in data
+     *
+     * Called by one worker at a time, never concurrently.
+     */
+    virtual void write(const char* data, size_t size, uint64_t count) = 0;
+};
+
+/// @brief A sink writing every block to a stream as is
+class StreamSolutionSink : public SolutionSink {
+public:
+    explicit StreamSolutionSink(std::ostream& out) : out(out) {}
+
+    void write(const char* data, size_t size, uint64_t count) override;
+
+private:
+    std::ostream& out;
+};
+
+/**
+ * @brief Stream every solution of a board, or the first N, to a sink
+ *
+ * The givens are propagated with the bitboard engine, then the search tree is
+ * cut breadth first into about threads * piecesPerThread subtrees, which the
+ * workers claim one at a time. Each worker walks its subtree with a plain
+ * depth-first search on row, column and square digit masks, picking the cell
+ * with the fewest candidates: near the leaves, where nearly all the work of an
+ * enumeration is, that costs a few nanoseconds per node where full
+ * propagation costs a microsecond. Solutions are encoded into a buffer of each
+ * worker and handed to the sink a block at a time, so memory does not grow
+ * with the number of solutions.
+ *
+ * With several threads, the order of the solutions, and which ones are kept
+ * when a limit cuts the enumeration short, vary from run to run. Every solution
+ * is written at most once, and exactly once without a limit.
+ */
+class SolutionEnumerator {
+public:
+    using Board = std::array<std::array<char, 9>, 9>;
+
+    /// @brief Bytes of a solution in the Binary format
+    static const size_t BINARY_SIZE = 41;
+
+    explicit SolutionEnumerator(const EnumerateOptions& options = EnumerateOptions());
+
+    /**
+     * @brief Enumerate the solutions of a board
+     * @param puzzle The board. Anything other than '1' through '9' is an empty cell
+     * @param sink Receives the solutions
+     * @return The counters. No solution is written if the givens contradict each other
+     */
+    EnumerateStats run(const Board& puzzle, SolutionSink& sink);
+
+    /// @brief Read a solution written in the Binary format
+    static void decodeBinary(const char* record, Board& board);
+
+private:
+    EnumerateOptions options;
+};
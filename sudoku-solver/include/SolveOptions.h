@@ -0,0 +1,133 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+/**
+ * @brief Shared flag used to ask a running solve to stop
+ *
+ * Copies of a token share the same flag, so the caller can keep one copy and
+ * hand the other to the solver. The search polls the flag while it backtracks.
+ */
+class CancellationToken {
+private:
+    std::shared_ptr<std::atomic<bool>> flag = std::make_shared<std::atomic<bool>>(false);
+
+public:
+    /// @brief Request that every solve holding this token stops
+    void cancel() const { flag->store(true, std::memory_order_relaxed); }
+
+    /// @brief Check if cancellation has been requested
+    bool isCancelled() const { return flag->load(std::memory_order_relaxed); }
+};
+
+/// @brief Outcome of a solve
+enum class SolveStatus {
+    /// The board was solved and written back
+    Solved,
+    /// The givens are inconsistent or the puzzle has no solution
+    Unsolvable,
+    /// The cancellation token was triggered before the search finished
+    Cancelled,
+    /// The deadline or the node budget ran out before the search finished
+    BudgetExceeded
+};
+
+/// @brief Order in which the values of a guessed cell are tried
+enum class ValueOrder {
+    /// Smallest digit first
+    Ascending,
+    /// The value that removes the fewest candidates from the peers first
+    LeastConstraining,
+    /// The digit already placed most often on the board first
+    DigitFrequency
+};
+
+/// @brief When the search gives up on its current tree and starts again from the givens
+enum class RestartPolicy {
+    /// Never restart
+    None,
+    /// Restart after restartBase times 1, 1, 2, 1, 1, 2, 4, 1, ... failed guesses
+    Luby,
+    /// Restart after restartBase failed guesses, growing by restartGrowth each time
+    Geometric
+};
+
+/// @brief Controls how long a single solve may run and how it searches
+struct SolveOptions {
+    using Clock = std::chrono::steady_clock;
+
+    /// @brief Token polled by the search. Cancelling it aborts the solve
+    CancellationToken cancellation;
+
+    /// @brief Wall-clock point after which the search gives up
+    Clock::time_point deadline = Clock::time_point::max();
+
+    /// @brief Maximum number of backtrack nodes before the search gives up
+    uint64_t maxNodes = std::numeric_limits<uint64_t>::max();
+
+    /**
+     * @brief Analyse every contradiction to backjump past unrelated guesses and learn nogoods
+     *
+     * Turning it off gives the plain chronological search, whose node counts are
+     * easier to reason about. A paused search keeps the setting it was started with.
+     */
+    bool learnFromConflicts = true;
+
+    /// @brief Order of the values tried for a guessed cell
+    ValueOrder valueOrder = ValueOrder::Ascending;
+
+    /**
+     * @brief Break ties between equally constrained cells and equally ranked values at random
+     *
+     * The ties are drawn again at every restart. The same seed replays the same search.
+     */
+    bool randomizeTies = false;
+
+    /// @brief Seed of the tie-breaking
+    uint64_t seed = 0;
+
+    /// @brief Restart schedule. Restarts keep the learned nogoods, and the growing limit keeps the search complete
+    RestartPolicy restarts = RestartPolicy::None;
+
+    /// @brief Failed guesses allowed before the first restart
+    uint64_t restartBase = 100;
+
+    /// @brief Factor applied to the limit after every restart under RestartPolicy::Geometric
+    double restartGrowth = 1.5;
+};
+
+/**
+ * @brief Counters describing the last solve
+ *
+ * Filled for every outcome, so a solve that ran out of budget still reports how
+ * far it got.
+ */
+struct SolveStats {
+    /// @brief Values tried by backtrack
+    uint64_t nodes = 0;
+
+    /// @brief Values that led to a contradiction and were undone
+    uint64_t backtracks = 0;
+
+    /// @brief Guesses undone without being retried because they played no part in a contradiction
+    uint64_t levelsSkipped = 0;
+
+    /// @brief Nogoods stored in the learned table
+    uint64_t nogoodsLearned = 0;
+
+    /// @brief Times the search started over from the givens
+    uint64_t restarts = 0;
+
+    /// @brief Deepest number of nested guesses
+    uint32_t maxDepth = 0;
+
+    /// @brief Cells already known after the givens were propagated
+    uint32_t cellsSetByPropagation = 0;
+
+    /// @brief Wall-clock duration of the solve
+    std::chrono::nanoseconds elapsed = std::chrono::nanoseconds::zero();
+};
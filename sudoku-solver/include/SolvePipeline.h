@@ -0,0 +1,182 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <limits>
+
+/// @brief Settings of a SolvePipeline run
+struct PipelineConfig {
+    /// @brief Threads of the solver stage. 0 uses every core left after the reader, validator and writer
+    unsigned solverThreads = 0;
+
+    /// @brief Slots of each queue between two stages, a power of two
+    size_t queueCapacity = 1024;
+
+    /// @brief Write the results in input order. Otherwise they are written as soon as they are validated
+    bool preserveOrder = true;
+
+    /// @brief Node budget of each puzzle. A puzzle over budget is reported and the run goes on
+    uint64_t maxNodesPerPuzzle = std::numeric_limits<uint64_t>::max();
+};
+
+/// @brief Counters of one stage
+struct StageStats {
+    /// @brief Puzzles that went through the stage
+    uint64_t items = 0;
+
+    /// @brief Time spent working on puzzles, summed over the threads of the stage
+    std::chrono::nanoseconds busy = std::chrono::nanoseconds::zero();
+
+    /// @brief Time spent waiting for room in the next queue (backpressure)
+    std::chrono::nanoseconds blocked = std::chrono::nanoseconds::zero();
+
+    /// @brief Time spent waiting for the previous queue to deliver
+    std::chrono::nanoseconds starved = std::chrono::nanoseconds::zero();
+};
+
+/// @brief Counters of one queue between two stages
+struct QueueStats {
+    size_t capacity = 0;
+
+    /// @brief Elements in the queue when the snapshot was taken
+    size_t depth = 0;
+
+    /// @brief Average number of elements seen right after a push
+    double meanOccupancy = 0;
+};
+
+/**
+ * @brief Snapshot of the counters of a run
+ *
+ * The stage whose busy time is closest to the elapsed time (divided by its
+ * thread count) is the bottleneck. A full queue in front of a stage says the
+ * same thing.
+ */
+struct PipelineStats {
+    StageStats reader;
+    StageStats solver;
+    StageStats validator;
+    StageStats writer;
+
+    /// @brief Reader to solvers
+    QueueStats parsed;
+    /// @brief Solvers to validator
+    QueueStats solved;
+    /// @brief Validator to writer
+    QueueStats validated;
+
+    unsigned solverThreads = 0;
+
+    uint64_t solvedPuzzles = 0;
+    uint64_t unsolvablePuzzles = 0;
+    uint64_t overBudgetPuzzles = 0;
+    /// @brief Lines that are not a puzzle in the line format
+    uint64_t invalidLines = 0;
+    /// @brief Solutions the validator refused. Always 0 unless an engine is broken
+    uint64_t rejectedSolutions = 0;
+
+    std::chrono::nanoseconds elapsed = std::chrono::nanoseconds::zero();
+};
+
+/**
+ * @brief Solve a stream of puzzles with concurrent stages
+ *
+ * A reader thread parses one puzzle per line, a pool of BitboardSolution
+ * threads solves them, a validator thread checks every solution against its
+ * givens, and the calling thread writes the results. The stages are connected
+ * by bounded lock-free RingBuffers: a stage facing a full queue waits, so a slow
+ * writer slows the reader down instead of filling memory. When order is
+ * preserved, the reader also stays within a window of the last written puzzle.
+ *
+ * Each result is one line: the solution, the puzzle followed by `unsolvable`,
+ * `budget` or `rejected`, or `invalid` for a line that is not a puzzle.
+ *
+ * The counters can be read from another thread while a run is in progress.
+ */
+class SolvePipeline {
+public:
+    using Board = std::array<std::array<char, 9>, 9>;
+
+    /**
+     * @param config Settings of the runs
+     * @throws std::invalid_argument If the queue capacity is not a power of two
+     */
+    explicit SolvePipeline(const PipelineConfig& config = PipelineConfig());
+
+    SolvePipeline(const SolvePipeline&) = delete;
+    SolvePipeline& operator=(const SolvePipeline&) = delete;
+
+    /**
+     * @brief Solve every puzzle of `in` and write the results to `out`
+     *
+     * Empty lines and lines starting with '#' are skipped.
+     *
+     * @param in One puzzle per line in the line format
+     * @param out Receives one result per puzzle
+     * @return The counters of the run
+     */
+    PipelineStats run(std::istream& in, std::ostream& out);
+
+    /// @brief Counters of the run in progress, or of the last run
+    PipelineStats stats() const;
+
+private:
+    /// @brief Live counters of a stage, updated by its threads
+    struct StageCounters {
+        std::atomic<uint64_t> items{ 0 };
+        std::atomic<int64_t> busy{ 0 };
+        std::atomic<int64_t> blocked{ 0 };
+        std::atomic<int64_t> starved{ 0 };
+
+        void reset();
+        StageStats snapshot() const;
+    };
+
+    /// @brief Live counters of a queue
+    struct QueueCounters {
+        size_t capacity = 0;
+        std::atomic<size_t> depth{ 0 };
+        std::atomic<uint64_t> pushes{ 0 };
+        std::atomic<uint64_t> occupancySum{ 0 };
+
+        void reset(size_t queueCapacity);
+        QueueStats snapshot() const;
+    };
+
+    /// @brief Queues and end-of-stream flags of a run, defined in SolvePipeline.cpp
+    struct Run;
+
+    /// @brief Parse the input lines into the parsed queue
+    void readStage(Run& r);
+
+    /// @brief Solve the puzzles of the parsed queue into the solved queue. Runs on every solver thread
+    void solveStage(Run& r);
+
+    /// @brief Check the solutions of the solved queue into the validated queue
+    void validateStage(Run& r);
+
+    /// @brief Write the results of the validated queue, reordering them if needed
+    void writeStage(Run& r);
+
+    PipelineConfig config;
+    unsigned solverThreads;
+
+    StageCounters readerCounters;
+    StageCounters solverCounters;
+    StageCounters validatorCounters;
+    StageCounters writerCounters;
+
+    QueueCounters parsedQueue;
+    QueueCounters solvedQueue;
+    QueueCounters validatedQueue;
+
+    std::atomic<uint64_t> solvedPuzzles{ 0 };
+    std::atomic<uint64_t> unsolvablePuzzles{ 0 };
+    std::atomic<uint64_t> overBudgetPuzzles{ 0 };
+    std::atomic<uint64_t> invalidLines{ 0 };
+    std::atomic<uint64_t> rejectedSolutions{ 0 };
+    std::atomic<int64_t> elapsed{ 0 };
+};
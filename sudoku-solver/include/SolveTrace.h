@@ -0,0 +1,104 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/// @brief How a cell got its value
+enum class Technique : uint8_t {
+    /// The value was given in the puzzle
+    Given,
+    /// Every other value was excluded by the row, column and square of the cell
+    NakedSingle,
+    /// The value was guessed by the search and turned out right
+    Guess
+};
+
+/// @brief One placed digit
+struct TraceEvent {
+    /// @brief Row of the cell, 0 through 8
+    uint8_t row;
+    /// @brief Column of the cell, 0 through 8
+    uint8_t col;
+    /// @brief Digit placed, 1 through 9
+    uint8_t digit;
+    Technique technique;
+};
+
+/**
+ * @brief Ordered record of the deductions that solved a puzzle
+ *
+ * Attach it to a Solution with Solution::setTrace. Every cell is placed at most
+ * once along a search path, and guesses that fail are rolled back, so the buffer
+ * never needs more than one event per cell and is allocated with the trace.
+ * Once the solve finishes, the events are the deductions leading to the solution
+ * in the order the solver made them.
+ */
+class SolveTrace {
+public:
+    /// @brief Maximum number of events, one per cell
+    static const size_t CAPACITY = 81;
+
+    /// @brief Append a placement
+    void record(int row, int col, int digit, Technique technique)
+    {
+        events[count++] = TraceEvent{ static_cast<uint8_t>(row), static_cast<uint8_t>(col), static_cast<uint8_t>(digit), technique };
+    }
+
+    /// @brief Drop every event after the first `newSize`
+    void truncate(size_t newSize) { count = newSize; }
+
+    /// @brief Drop every event
+    void clear() { count = 0; }
+
+    /// @brief Number of events recorded
+    size_t size() const { return count; }
+
+    /// @brief Get an event
+    const TraceEvent& operator[](size_t k) const { return events[k]; }
+
+    const TraceEvent* begin() const { return events.data(); }
+    const TraceEvent* end() const { return events.data() + count; }
+
+    /**
+     * @brief Count the events that used a technique
+     * @param technique The technique to count
+     * @return Number of matching events
+     */
+    size_t countOf(Technique technique) const;
+
+    /**
+     * @brief Grade the solve by the hardest technique it needed
+     * @return Guess if any cell was guessed, NakedSingle if any cell was deduced, Given otherwise
+     */
+    Technique hardestTechnique() const;
+
+    /**
+     * @brief Export the events compactly
+     *
+     * Four characters per event: row and column (1 through 9), digit, and the
+     * technique letter (C for a given clue, N for a naked single, G for a guess).
+     *
+     * @return The encoded events
+     */
+    std::string toCompactString() const;
+
+    /**
+     * @brief Describe an event for a person
+     * @param e The event
+     * @return For example "r1c3 = 4 (naked single)"
+     */
+    static std::string describe(const TraceEvent& e);
+
+    /**
+     * @brief Name of a technique
+     * @param technique The technique
+     * @return "given", "naked single" or "guess"
+     */
+    static const char* techniqueName(Technique technique);
+
+private:
+    std::array<TraceEvent, CAPACITY> events;
+    size_t count = 0;
+};
@@ -0,0 +1,122 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Compile-time configuration of BasicSolution
+ *
+ * Every policy is a type holding `static const bool` switches. BasicSolution
+ * tests them with plain `if`s on constants, so a switch that is off removes its
+ * code from the instantiation instead of being checked on every node. Settings
+ * that stay in SolveOptions (value order, learning, limits) are only honoured
+ * when the policy leaves them configurable.
+ */
+
+/// @brief Propagation of cells with a single candidate left and conflict-directed backjumping
+struct ConflictDirectedPropagation {
+    /// @brief A cell narrowed down to one candidate is set at once, and its value propagated
+    static const bool nakedSingles = true;
+
+    /// @brief SolveOptions::learnFromConflicts is honoured. When false the search is chronological
+    static const bool conflictLearning = true;
+};
+
+/// @brief Naked singles without the bookkeeping of conflict learning
+struct SinglesPropagation {
+    static const bool nakedSingles = true;
+    static const bool conflictLearning = false;
+};
+
+/// @brief Forward checking only: a guess removes its value from the peers, and a cell left without candidates fails
+struct ForwardCheckingPropagation {
+    static const bool nakedSingles = false;
+    static const bool conflictLearning = false;
+};
+
+/// @brief Guess the cell with the fewest candidates, sorting the remaining cells again after every guess
+struct MinimumRemainingSelection {
+    static const bool resortAfterGuess = true;
+};
+
+/// @brief Guess the cells in the order they had once the givens were propagated
+struct StaticSelection {
+    static const bool resortAfterGuess = false;
+};
+
+/// @brief Values are tried following SolveOptions::valueOrder and randomizeTies
+struct ConfigurableValueOrder {
+    static const bool configurable = true;
+};
+
+/// @brief Values are always tried from 1 to 9
+struct AscendingValueOrder {
+    static const bool configurable = false;
+};
+
+/// @brief Search counters and SolveTrace, the default
+struct TracedInstrumentation {
+    /// @brief setTrace is supported
+    static const bool tracing = true;
+
+    /// @brief SolveStats counts backtracks, skipped levels, nogoods, depth and propagated cells. Nodes and restarts are always counted
+    static const bool counters = true;
+
+    /// @brief Every step of the search is printed to std::cout
+    static const bool logging = false;
+};
+
+/// @brief Only the node and restart counters, no trace
+struct SilentInstrumentation {
+    static const bool tracing = false;
+    static const bool counters = false;
+    static const bool logging = false;
+};
+
+/// @brief TracedInstrumentation and a log of every step, for debugging
+struct LoggingInstrumentation {
+    static const bool tracing = true;
+    static const bool counters = true;
+    static const bool logging = true;
+};
+
+/// @brief SolveOptions::maxNodes, deadline and cancellation are honoured
+struct PolledLimits {
+    static const bool enforced = true;
+};
+
+/// @brief The search runs to the end whatever the options say, so it never pauses
+struct NoLimits {
+    static const bool enforced = false;
+};
+
+/**
+ * @brief The policies of one BasicSolution
+ *
+ * @tparam Propagation ConflictDirectedPropagation, SinglesPropagation or ForwardCheckingPropagation
+ * @tparam CellSelection MinimumRemainingSelection or StaticSelection
+ * @tparam ValueOrdering ConfigurableValueOrder or AscendingValueOrder
+ * @tparam Instrumentation TracedInstrumentation, SilentInstrumentation or LoggingInstrumentation
+ * @tparam Limits PolledLimits or NoLimits
+ */
+template <class Propagation, class CellSelection, class ValueOrdering, class Instrumentation, class Limits>
+struct SolverPolicies {
+    using PropagationPolicy = Propagation;
+    using CellSelectionPolicy = CellSelection;
+    using ValueOrderingPolicy = ValueOrdering;
+    using InstrumentationPolicy = Instrumentation;
+    using LimitsPolicy = Limits;
+};
+
+/// @brief Everything configurable at run time, the policies of Solution
+using DefaultPolicies = SolverPolicies<ConflictDirectedPropagation, MinimumRemainingSelection, ConfigurableValueOrder, TracedInstrumentation, PolledLimits>;
+
+/// @brief Unbounded solves of ordinary puzzles: naked singles, MRV and nothing else
+using FastPolicies = SolverPolicies<SinglesPropagation, MinimumRemainingSelection, AscendingValueOrder, SilentInstrumentation, NoLimits>;
+
+/// @brief FastPolicies without re-sorting the cells, cheapest per node on easy puzzles
+using StaticOrderPolicies = SolverPolicies<SinglesPropagation, StaticSelection, AscendingValueOrder, SilentInstrumentation, NoLimits>;
+
+/// @brief The weakest propagation, guessing even the cells left with one candidate
+using ForwardCheckingPolicies = SolverPolicies<ForwardCheckingPropagation, MinimumRemainingSelection, AscendingValueOrder, SilentInstrumentation, NoLimits>;
+
+/// @brief DefaultPolicies printing every step
+using LoggingPolicies = SolverPolicies<ConflictDirectedPropagation, MinimumRemainingSelection, ConfigurableValueOrder, LoggingInstrumentation, PolledLimits>;
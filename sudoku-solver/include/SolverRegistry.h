@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "SolveOptions.h"
+
+/// @brief A solver configuration that can be picked by name
+struct SolverEngine {
+    using Board = std::array<std::array<char, 9>, 9>;
+
+    /// @brief Name given on the command line
+    const char* name;
+
+    /// @brief One line on what it is good at
+    const char* description;
+
+    /**
+     * @brief Solve a batch of boards with one solver object of this engine
+     *
+     * The engine is chosen once per batch, so the solves themselves run the
+     * specialized code without any dispatch.
+     *
+     * @param boards The puzzles, each replaced by its solution when Solved
+     * @param count Number of boards
+     * @param opts Options of every solve. Engines built with NoLimits ignore the limits
+     * @param statuses Receives the outcome of each board, or nullptr
+     */
+    void (*solveAll)(Board* boards, size_t count, const SolveOptions& opts, SolveStatus* statuses);
+};
+
+/**
+ * @brief The engines the tools can choose from
+ *
+ * "cells" is Solution, "bitboard" BitboardSolution, and the others the presets
+ * of SolverPolicies.h. Which one is fastest depends on the puzzles, so time a
+ * sample of the workload with each.
+ */
+class SolverRegistry {
+public:
+    /// @brief Every engine, "cells" first
+    static const std::vector<SolverEngine>& engines();
+
+    /**
+     * @brief Look an engine up by name
+     * @return nullptr If there is no such engine
+     */
+    static const SolverEngine* find(const std::string& name);
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Precomputed units and peers of the standard 9x9 board
+ *
+ * Cells are numbered row by row, from 0 to 80. Units 0 through 8 are the rows,
+ * 9 through 17 the columns and 18 through 26 the 3x3 squares.
+ */
+class SudokuGeometry
+{
+public:
+    static const size_t CELLS = 81;
+    static const size_t UNITS = 27;
+    static const size_t PEERS = 20;
+
+    /// @brief The nine cells of each unit
+    static const std::array<std::array<uint8_t, 9>, UNITS>& units();
+
+    /// @brief The twenty cells sharing a row, column or square with each cell
+    static const std::array<std::array<uint8_t, PEERS>, CELLS>& peers();
+};
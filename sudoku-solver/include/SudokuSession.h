@@ -0,0 +1,109 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "Bitboard.h"
+#include "BitboardSolution.h"
+
+/**
+ * @brief Board being edited interactively, kept propagated between edits
+ *
+ * Every assignment is applied on top of the propagated candidates of the previous
+ * edit, and the previous state is kept on an undo stack, so an edit or an undo
+ * costs one propagation instead of rebuilding the board from scratch. Whether the
+ * board can still be solved is computed on demand and cached until the next edit.
+ */
+class SudokuSession
+{
+public:
+    using Board = std::array<std::array<char, 9>, 9>;
+
+    /// @brief Start with an empty board
+    SudokuSession();
+
+    /**
+     * @brief Start with the givens of a puzzle
+     * @param givens The puzzle, digits '1'-'9' and anything else for an empty cell. The givens cannot be undone or erased
+     */
+    explicit SudokuSession(const Board& givens);
+
+    /**
+     * @brief Enter a digit in a cell
+     * @param row The row, 0 through 8
+     * @param col The column, 0 through 8
+     * @param digit The digit, 1 through 9
+     * @return false If the board is now inconsistent. The edit is kept so it can be undone
+     * @throws std::out_of_range If a coordinate or the digit is invalid
+     * @throws std::logic_error If the cell already holds an entry or a given
+     */
+    bool assign(int row, int col, int digit);
+
+    /**
+     * @brief Revert the last assign
+     * @return false If there is nothing to undo
+     */
+    bool undo();
+
+    /**
+     * @brief Remove the entry of a cell, wherever it is in the history
+     *
+     * The later entries are applied again on top of the state before the removed one.
+     *
+     * @param row The row, 0 through 8
+     * @param col The column, 0 through 8
+     * @return false If the cell holds no entry
+     */
+    bool erase(int row, int col);
+
+    /// @brief False once an entry contradicts the givens or the other entries
+    bool isConsistent() const;
+
+    /// @brief True if the board can still be completed. Searches on the first call after an edit
+    bool isSolvable();
+
+    /**
+     * @brief Digits still possible in a cell after propagation
+     * @return Bit d set if digit d is possible. A single bit for a known cell. 0 once inconsistent
+     */
+    uint16_t candidates(int row, int col) const;
+
+    /**
+     * @brief Value of a cell, entered or deduced
+     * @return The digit, 0 if the cell is still open
+     */
+    int value(int row, int col) const;
+
+    /// @brief The givens and entries, '.' elsewhere
+    const Board& entries() const;
+
+    /// @brief Number of entries that can be undone
+    size_t historySize() const;
+
+private:
+    struct Edit {
+        int cell;
+        int digit;
+        /// @brief State before the edit
+        BitboardState before;
+        bool consistentBefore;
+    };
+
+    Board board;
+    BitboardState state;
+    bool consistent = true;
+    std::vector<Edit> history;
+
+    /// @brief Cached answer of isSolvable, valid while solvableKnown is set
+    bool solvable = false;
+    bool solvableKnown = false;
+
+    BitboardSolution solver;
+    SolveOptions unlimited;
+
+    /// @brief Apply one entry on top of the current state
+    void apply(int cell, int digit);
+
+    static void throwIfOutOfRange(int row, int col);
+};
@@ -2,10 +2,20 @@
 
 #include <array>
 
+#include "ConstraintGraph.h"
+
 class SudokuValidator
 {
 private:
     /* data */
 public:
     static bool isSudokuValid(std::array<std::array<char, 9>, 9>& board);
+
+    /**
+     * @brief Check a filled board against the rules of a variant
+     * @param board The board
+     * @param graph The compiled rules
+     * @return true If every unit holds 1 through 9 once and every cage adds up
+     */
+    static bool isValid(const std::array<std::array<char, 9>, 9>& board, const ConstraintGraph& graph);
 };
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define SUDOKU_TIMELINE_TSC 1
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define SUDOKU_TIMELINE_TSC 1
+#else
+#include <chrono>
+#endif
+
+/**
+ * @brief Per-thread timeline of the solve phases, exported as Chrome trace-event JSON
+ *
+ * Every thread appends to its own preallocated buffer, so recording takes no
+ * lock: two time stamps and a store. A thread gets its buffer on its first
+ * event. When it exits the buffer goes back to the registry with its events,
+ * to be continued by a later thread of the same name, so the events of pool
+ * threads that already finished can still be exported while the memory stays
+ * bounded by the threads running at once. A full buffer drops new events and
+ * counts them.
+ *
+ * The library records through the SUDOKU_TIMELINE_SCOPE macro, which only
+ * expands to something when the SUDOKU_ENABLE_TIMELINE CMake option is on.
+ * Recording also has to be switched on at run time with enable.
+ *
+ * The JSON loads in Perfetto (ui.perfetto.dev) or chrome://tracing.
+ */
+class Timeline {
+public:
+    /// @brief True if the library was built with SUDOKU_ENABLE_TIMELINE
+    static bool compiledIn()
+    {
+#if defined(SUDOKU_ENABLE_TIMELINE)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Start recording and drop the events recorded so far
+     *
+     * Call it while no other thread records.
+     *
+     * @param eventsPerThread Capacity of the buffer of each thread
+     */
+    static void enable(size_t eventsPerThread = size_t(1) << 16);
+
+    /// @brief Stop recording. The events are kept for writeChromeTrace
+    static void disable();
+
+    static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+    /// @brief Name the calling thread in the exported trace
+    static void setThreadName(const char* name);
+
+    /**
+     * @brief Append an event to the calling thread's buffer
+     * @param name Name of the phase. It must outlive the export, a string literal in practice
+     * @param start Result of now when the phase started
+     * @param end Result of now when the phase ended
+     */
+    static void record(const char* name, uint64_t start, uint64_t end);
+
+    /// @brief Time stamp in ticks: the CPU time stamp counter on x86, nanoseconds elsewhere
+    static uint64_t now()
+    {
+#if defined(SUDOKU_TIMELINE_TSC)
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    /**
+     * @brief Write every recorded event as Chrome trace-event JSON
+     *
+     * Call it while no other thread records.
+     *
+     * @param out Receives a {"traceEvents": [...]} object
+     */
+    static void writeChromeTrace(std::ostream& out);
+
+    /// @brief Events recorded since enable, over every thread
+    static uint64_t recordedEvents();
+
+    /// @brief Buffers allocated so far, over every thread
+    static size_t threadBuffers();
+
+    /// @brief Events lost to full buffers since enable
+    static uint64_t droppedEvents();
+
+private:
+    static std::atomic<bool> enabled;
+};
+
+/// @brief Record the lifetime of a scope as one timeline event
+class TimelineScope {
+public:
+    explicit TimelineScope(const char* name)
+        : name(Timeline::isEnabled() ? name : nullptr), start(this->name != nullptr ? Timeline::now() : 0)
+    {
+    }
+
+    ~TimelineScope()
+    {
+        if (name != nullptr) {
+            Timeline::record(name, start, Timeline::now());
+        }
+    }
+
+    TimelineScope(const TimelineScope&) = delete;
+    TimelineScope& operator=(const TimelineScope&) = delete;
+
+private:
+    const char* name;
+    uint64_t start;
+};
+
+#if defined(SUDOKU_ENABLE_TIMELINE)
+#define SUDOKU_TIMELINE_CONCAT_INNER(a, b) a##b
+#define SUDOKU_TIMELINE_CONCAT(a, b) SUDOKU_TIMELINE_CONCAT_INNER(a, b)
+/// @brief Record the rest of the enclosing scope as a phase called `name`
+#define SUDOKU_TIMELINE_SCOPE(name) TimelineScope SUDOKU_TIMELINE_CONCAT(timelineScope, __LINE__)(name)
+/// @brief Name the calling thread in the timeline
+#define SUDOKU_TIMELINE_THREAD(name) Timeline::setThreadName(name)
+#else
+#define SUDOKU_TIMELINE_SCOPE(name) ((void)0)
+#define SUDOKU_TIMELINE_THREAD(name) ((void)0)
+#endif
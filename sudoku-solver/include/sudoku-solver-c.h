@@ -0,0 +1,108 @@
+#ifndef SUDOKU_SOLVER_C_H
+#define SUDOKU_SOLVER_C_H
+
+/**
+ * @file sudoku-solver-c.h
+ * @brief Stable C interface of the solver, for embedding from other languages
+ *
+ * A puzzle is 81 bytes in row-major order: '1' through '9' for a given, '.' or
+ * '0' for an empty cell. Batches are contiguous arrays of puzzles owned by the
+ * caller, and results are written in place, so a call copies nothing and, once
+ * the handle has warmed up, allocates nothing.
+ *
+ * Functions never throw or abort. A handle may be used by one thread at a time;
+ * use one handle per calling thread to solve concurrently.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#if defined(SUDOKU_C_EXPORTS)
+#define SUDOKU_C_API __declspec(dllexport)
+#elif defined(SUDOKU_C_SHARED)
+#define SUDOKU_C_API __declspec(dllimport)
+#else
+#define SUDOKU_C_API
+#endif
+#elif defined(__GNUC__)
+#define SUDOKU_C_API __attribute__((visibility("default")))
+#else
+#define SUDOKU_C_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Version of this interface. Bumped only on incompatible changes */
+#define SUDOKU_C_API_VERSION 1
+
+/** @brief Bytes of one puzzle in a batch buffer */
+#define SUDOKU_CELLS 81
+
+/** @brief Outcome of one puzzle, stored as int32_t in the status array */
+enum sudoku_status {
+    /** The puzzle was solved and its solution written */
+    SUDOKU_SOLVED = 0,
+    /** The givens are inconsistent or the puzzle has no solution */
+    SUDOKU_UNSOLVABLE = 1,
+    /** The node budget ran out before the search finished */
+    SUDOKU_BUDGET_EXCEEDED = 2,
+    /** A byte of the puzzle is not '1'-'9', '.' or '0' */
+    SUDOKU_INVALID = 3
+};
+
+/** @brief Errors returned instead of a count */
+enum sudoku_error {
+    /** A pointer is NULL or the handle is unusable */
+    SUDOKU_ERROR_ARGUMENT = -1,
+    /** Memory ran out or a worker thread could not be started */
+    SUDOKU_ERROR_RESOURCES = -2
+};
+
+/** @brief Opaque solver handle: its worker threads and search stacks */
+typedef struct sudoku_solver sudoku_solver;
+
+/** @brief SUDOKU_C_API_VERSION of the library actually loaded */
+SUDOKU_C_API int sudoku_api_version(void);
+
+/**
+ * @brief Create a solver
+ * @param threads Threads solving each batch, the caller's included. 0 uses every core
+ * @return The handle, or NULL if it could not be created
+ */
+SUDOKU_C_API sudoku_solver* sudoku_solver_create(unsigned threads);
+
+/** @brief Stop the worker threads and free the handle. NULL is ignored */
+SUDOKU_C_API void sudoku_solver_destroy(sudoku_solver* solver);
+
+/**
+ * @brief Limit the guesses of each puzzle
+ * @param solver The handle
+ * @param max_nodes Node budget per puzzle. 0 removes the limit
+ */
+SUDOKU_C_API void sudoku_solver_set_max_nodes(sudoku_solver* solver, uint64_t max_nodes);
+
+/**
+ * @brief Solve a batch of puzzles
+ *
+ * Puzzle i is read from puzzles + 81 * i. Its solution is written to
+ * solutions + 81 * i as the digits '1' through '9'; a puzzle that is not solved
+ * is copied unchanged. solutions may equal puzzles to solve in place.
+ *
+ * @param solver The handle
+ * @param puzzles count * 81 bytes
+ * @param solutions count * 81 bytes receiving the results
+ * @param statuses count entries receiving a sudoku_status each
+ * @param count Number of puzzles
+ * @return The number of puzzles solved, or a negative sudoku_error
+ */
+SUDOKU_C_API int64_t sudoku_solve_batch(sudoku_solver* solver, const char* puzzles, char* solutions,
+                                        int32_t* statuses, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
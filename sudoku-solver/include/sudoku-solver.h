@@ -4,22 +4,47 @@
 #pragma once
 
 #include <array>
+#include <cstdint>
+#include <random>
 #include <vector>
 
+#include "Bitboard.h"
 #include "Cell.h"
+#include "ConstraintGraph.h"
+#include "SolveOptions.h"
+#include "SolveTrace.h"
+#include "SolverPolicies.h"
 
 /** @brief Solution to Sudoku problems
  * Provide a public interface to solveSudoku problems efficiently
+ *
+ * The propagation, cell selection, value ordering, instrumentation and limits
+ * are chosen at compile time by a SolverPolicies, so each configuration is its
+ * own engine with the unused features compiled out. Solution is the one with
+ * every feature; the presets of SolverPolicies.h are instantiated in
+ * sudoku-solver.cpp, and other combinations have to be added there.
+ *
+ * @tparam Policies A SolverPolicies
  */
-class Solution
+template <class Policies>
+class BasicSolution
 {
 public:
 	/// @brief Hold the number of rows or cols in a standard Sudoku board
 	static const size_t SUDOKU_SIZE = 9;
 
 private:
+	using Propagation = typename Policies::PropagationPolicy;
+	using CellSelection = typename Policies::CellSelectionPolicy;
+	using ValueOrdering = typename Policies::ValueOrderingPolicy;
+	using Instrumentation = typename Policies::InstrumentationPolicy;
+	using Limits = typename Policies::LimitsPolicy;
+
 	/// @brief True if Logging is enabled throughout the application
-	static const bool loggingEnabled = false;
+	static const bool loggingEnabled = Instrumentation::logging;
+
+	/// @brief Set of search levels, bit l standing for the guess of frames[l]. A board never needs more than 81 levels
+	using LevelSet = Bitboard81;
 
 	template <typename T = uint8_t>
 	char intToChar(T i) {
@@ -41,10 +66,26 @@ private:
 	/**
 	 * @brief Initialize the Board
 	 *
-	 * Allocate the 9x9 area
+	 * Reset the 9x9 area and the search counters so the Solution can be reused
 	 */
 	void inline initialize();
 
+	/**
+	 * @brief Reset the board and set the givens, propagating their constraints
+	 *
+	 * @param board The sudoku puzzle
+	 * @return false If the givens are inconsistent
+	 */
+	bool inline applyGivens(const std::array<std::array<char, SUDOKU_SIZE>, SUDOKU_SIZE>& board);
+
+	/**
+	 * @brief Apply the givens, search, and write the solution back
+	 *
+	 * @param board The sudoku puzzle to solve
+	 * @return The outcome of the solve
+	 */
+	SolveStatus inline solveBoard(std::array<std::array<char, SUDOKU_SIZE>, SUDOKU_SIZE>& board);
+
 	/**
 	 * @brief Set the Value of a cell
 	 *
@@ -53,10 +94,24 @@ private:
 	 * @param i The x coordinate
 	 * @param j The y coordinate
 	 * @param value The value to set in the cell
+	 * @param technique How the value was found, recorded in the trace
+	 * @param reason Guesses that imply the value
 	 * @return true If the value was logically sound
-	 * @return false If the value or following deductions were inconsistent.
+	 * @return false If the value or following deductions were inconsistent. The guesses to blame are in conflictLevels
+	 */
+	bool inline setValue(int i, int j, int value, Technique technique, const LevelSet& reason);
+
+	/**
+	 * @brief Exclude a value that was just set from the peers of its cell
+	 *
+	 * @param i The x coordinate
+	 * @param j The y coordinate
+	 * @param value The value set at [i,j]
+	 * @param reason Guesses that imply the value
+	 * @return true If every peer could exclude the value
+	 * @return false If this value or following deductions were inconsistent
 	 */
-	bool inline setValue(int i, int j, int value);
+	bool inline propagateValue(int i, int j, int value, const LevelSet& reason);
 
 	/**
 	 * @brief Update the Constraints on a cell
@@ -68,10 +123,22 @@ private:
 	 * @param i The x coordinate
 	 * @param j The y coordinate
 	 * @param excludedValue The value that can no longer be set at this coordinate
+	 * @param reason Guesses that imply the exclusion
 	 * @return true If the value could logically be excluded
 	 * @return false If this value or following deductions were inconsistent
 	 */
-	bool inline updateConstraints(int i, int j, int excludedValue);
+	bool inline updateConstraints(int i, int j, int excludedValue, const LevelSet& reason);
+
+	/**
+	 * @brief Remove the candidates of a cage's empty cells that no combination reaching its sum uses
+	 *
+	 * @param k The cage
+	 * @return false If no combination of the remaining candidates reaches the sum
+	 */
+	bool inline applyCage(size_t k);
+
+	/// @brief Rules the board is solved under, compiled into peer and cage tables
+	const ConstraintGraph* graph = &ConstraintGraph::classic();
 
 	/// @brief Keep a list of empty cells at the beginning to back track
 	std::vector<std::pair<int, int>> bt;
@@ -79,7 +146,8 @@ private:
 	/**
 	 * @brief Sort the remaining empty cells
 	 *
-	 * This function sorts the bt array based on the number of remaining non-excluded values at each cell
+	 * This function sorts the bt array based on the number of remaining non-excluded values at each cell.
+	 * When ties are randomized, equally constrained cells are ordered by cellKey
 	 *
 	 * @param it The iterator to start sorting with
 	 *
@@ -94,14 +162,233 @@ private:
 	 */
 	bool inline findValuesForEmptyCells();
 
+	/// @brief One level of the explicit search stack
+	struct Frame {
+		/// @brief Position in bt of the cell guessed at this level
+		size_t position;
+
+		/// @brief Values not tried yet at this level, bit v set if v remains
+		uint16_t untried;
+
+		/// @brief Size of the trace before the guess of this level
+		size_t traceSize;
+
+		/// @brief Value guessed last at this level
+		uint8_t value;
+
+		/// @brief Lower levels to blame for the values of this level that failed or were excluded
+		LevelSet conflict;
+	};
+
+	/// @brief Search stack, preallocated to one frame per cell
+	std::vector<Frame> frames;
+
+	/// @brief snapshots[d] holds the cells before the guess of frames[d], restored when that guess fails
+	std::vector<std::array<std::array<Cell, SUDOKU_SIZE>, SUDOKU_SIZE>> snapshots;
+
+	/// @brief Number of frames in use
+	size_t depth = 0;
+
+	/**
+	 * @brief Undo the guess made at a level of the search
+	 *
+	 * @param level Index of the frame whose snapshot and trace size are restored
+	 */
+	void inline restoreLevel(size_t level);
+
+	/// @brief True if the next step of the search pushes a frame for bt[nextPosition]
+	bool descending = false;
+
+	/// @brief Position in bt of the next cell to guess when descending
+	size_t nextPosition = 0;
+
+	/// @brief True if a search stopped early and can be continued with resume
+	bool paused = false;
+
+	/// @brief True if the current search backjumps and learns nogoods, see SolveOptions::learnFromConflicts
+	bool learning = true;
+
+	/// @brief learning, folded to false at compile time when the propagation policy has no conflict learning
+	bool learns() const { return Propagation::conflictLearning && learning; }
+
+	/// @brief Value order of the current search
+	ValueOrder valueOrder = ValueOrder::Ascending;
+
+	/// @brief True if ties are broken by cellKey and digitKey
+	bool randomizeTies = false;
+
+	/// @brief Restart schedule of the current search
+	RestartPolicy restartPolicy = RestartPolicy::None;
+
+	/// @brief See SolveOptions::restartBase
+	uint64_t restartBase = 0;
+
+	/// @brief See SolveOptions::restartGrowth
+	double restartGrowth = 1;
+
+	/// @brief Failed guesses since the search last started from the givens
+	uint64_t failuresSinceRestart = 0;
+
+	/// @brief Failed guesses after which the search restarts
+	uint64_t restartLimit = 0;
+
+	/// @brief Draws the tie-breaking keys, seeded by SolveOptions::seed
+	std::mt19937_64 rng;
+
+	/// @brief Rank of each cell among cells with as many candidates, lower first
+	std::array<uint8_t, SUDOKU_SIZE * SUDOKU_SIZE> cellKey;
+
+	/// @brief Rank of each value among equally ranked values, lower first
+	std::array<uint8_t, SUDOKU_SIZE + 1> digitKey;
+
+	/**
+	 * @brief Copy the search settings of a solve into the members
+	 *
+	 * @param opts The options of the solve
+	 */
+	void inline configureSearch(const SolveOptions& opts);
+
+	/// @brief Draw new tie-breaking keys, or the natural order when ties are not randomized
+	void inline drawTieKeys();
+
+	/**
+	 * @brief Pick the next value to try at a level, following valueOrder
+	 *
+	 * @param f The frame of the level
+	 * @return A value of f.untried
+	 */
+	int inline nextValue(const Frame& f);
+
+	/**
+	 * @brief Number of failed guesses allowed by the Luby sequence 1, 1, 2, 1, 1, 2, 4, ... for a run
+	 *
+	 * @param run Index of the run, 0 for the first
+	 * @return The run's term of the sequence
+	 */
+	static uint64_t luby(uint64_t run);
+
+	/// @brief Drop the whole search tree and start again from the givens with fresh tie-breaking keys
+	void inline restart();
+
+	/// @brief Guesses responsible for the last contradiction found by propagation
+	LevelSet conflictLevels;
+
+	/// @brief valueReason[c] holds the guesses that imply the value of cell c, valid while the cell is set
+	std::array<LevelSet, SUDOKU_SIZE * SUDOKU_SIZE> valueReason;
+
+	/// @brief exclusionReason[c][v] holds the guesses that exclude v from cell c, valid while v is excluded
+	std::array<std::array<LevelSet, SUDOKU_SIZE + 1>, SUDOKU_SIZE * SUDOKU_SIZE> exclusionReason;
+
+	/// @brief Largest number of guesses in a stored nogood. Longer ones rarely apply again and slow down the checks
+	static const size_t MAX_NOGOOD_SIZE = 8;
+
+	/// @brief Number of nogoods kept. The oldest is replaced once the table is full
+	static const size_t NOGOOD_CAPACITY = 256;
+
+	/// @brief Guesses that cannot all hold together: at least one cell must differ
+	struct Nogood {
+		uint8_t size;
+		std::array<uint8_t, MAX_NOGOOD_SIZE> cell;
+		std::array<uint8_t, MAX_NOGOOD_SIZE> value;
+	};
+
+	/// @brief Learned nogoods, a ring of NOGOOD_CAPACITY entries
+	std::vector<Nogood> nogoods;
+
+	/// @brief Number of valid entries in nogoods
+	size_t nogoodCount = 0;
+
+	/// @brief Entry of nogoods overwritten by the next learned nogood
+	size_t nextNogood = 0;
+
+	/**
+	 * @brief Union of the reasons that excluded every value a cell can no longer take
+	 *
+	 * @param i The x coordinate
+	 * @param j The y coordinate
+	 * @return Guesses that narrowed the cell down to its remaining values
+	 */
+	LevelSet inline exclusionsOf(int i, int j) const;
+
+	/**
+	 * @brief Store the guesses of a conflict set as a nogood
+	 *
+	 * @param why Levels of the guesses that together lead to a contradiction
+	 */
+	void inline learnNogood(const LevelSet& why);
+
+	/**
+	 * @brief Check the learned nogoods against the cells until nothing changes
+	 *
+	 * A nogood whose guesses all hold is a contradiction. A nogood with a single
+	 * guess left open excludes that guess.
+	 *
+	 * @return false If a nogood is violated or an exclusion is inconsistent. The guesses to blame are in conflictLevels
+	 */
+	bool inline applyNogoods();
+
+	/// @brief After a solution, make every level blame all the levels above it so the search continues chronologically
+	void inline blameAllLevels();
+
 	/**
 	 * @brief Perform the Backtrack algorithm on the Sudoku array
 	 *
-	 * @param k The iterator to start at
-	 * @return true If the value can be set to any of its remaining possibilities based on the current state
-	 * @return false If the value cannot be set to a valid value based on the current state
+	 * Runs the search held in frames until it finds a solution, exhausts every
+	 * possibility, or is told to stop. The search state lives entirely in the
+	 * members, so a stopped search continues where it left off on the next call.
+	 *
+	 * When learning, every contradiction carries the set of guesses that caused
+	 * it. Once a level runs out of values the search jumps straight back to the
+	 * deepest guess in that set, and the set is stored as a nogood.
+	 *
+	 * Under a restart policy the search starts over once it has failed
+	 * restartLimit guesses since the last restart.
+	 *
+	 * @return true If every empty cell was filled
+	 * @return false If the search was exhausted or aborted
 	 */
-	bool inline backtrack(std::vector<std::pair<int, int>>::iterator k);
+	bool inline backtrack();
+
+	/**
+	 * @brief Run backtrack and turn its outcome into a status, writing the board when solved
+	 *
+	 * @param board Receives the solution
+	 * @return The outcome of the search
+	 */
+	SolveStatus inline runSearch(std::array<std::array<char, SUDOKU_SIZE>, SUDOKU_SIZE>& board);
+
+	/// @brief Number of backtrack nodes between two polls of the cancellation token and deadline
+	static const uint64_t POLL_INTERVAL = 64;
+
+	/// @brief Limits of the solve in progress, nullptr if the solve is unbounded
+	const SolveOptions* options = nullptr;
+
+	/// @brief Value of stats.nodes at which the current call runs out of node budget
+	uint64_t nodeLimit = 0;
+
+	/// @brief Counters of the current (or last) solve
+	SolveStats stats;
+
+	/// @brief Receives the deductions of the solve, nullptr when tracing is off
+	SolveTrace* trace = nullptr;
+
+	/// @brief True if deductions are recorded, always false without the tracing policy
+	bool tracing() const { return Instrumentation::tracing && trace != nullptr; }
+
+	/// @brief Set once the search has been told to stop. Holds the reason in abortStatus
+	bool aborted = false;
+
+	/// @brief Why the search stopped early
+	SolveStatus abortStatus = SolveStatus::Unsolvable;
+
+	/**
+	 * @brief Check the node budget, the cancellation token and the deadline before trying a node
+	 *
+	 * The node budget is checked on every node, the token and the clock only every POLL_INTERVAL nodes.
+	 *
+	 * @return true If the search must stop
+	 */
+	bool inline shouldAbort();
 
 	/// @brief Hold the current state of the board
 	std::array<std::array<Cell, SUDOKU_SIZE>, SUDOKU_SIZE> cells; // 9x9 vector of cell
@@ -114,5 +401,78 @@ public:
 	 * 
 	 * If the sudoku can't be solve, the board remains untouched
 	 */
-	void solveSudoku(std::array<std::array<char, Solution::SUDOKU_SIZE>, Solution::SUDOKU_SIZE>&board);
+	void solveSudoku(std::array<std::array<char, SUDOKU_SIZE>, SUDOKU_SIZE>&board);
+
+	/**
+	 * @brief Solve the Sudoku puzzle, giving up when cancelled or out of budget
+	 *
+	 * @param board The sudoku puzzle to solve
+	 * @param opts The cancellation token, deadline and node budget of the search
+	 * @return The outcome of the solve. The board is only written when Solved
+	 *
+	 * When the solve is Cancelled or BudgetExceeded the search is paused and can be
+	 * continued with resume. A paused Solution may be moved to another thread.
+	 * Under NoLimits the options still configure the search, but the limits are ignored.
+	 */
+	SolveStatus solveSudoku(std::array<std::array<char, SUDOKU_SIZE>, SUDOKU_SIZE>& board, const SolveOptions& opts);
+
+	/**
+	 * @brief Continue a paused search
+	 *
+	 * @param board Receives the solution. It is only written when Solved
+	 * @param opts New cancellation token, deadline and node budget. maxNodes counts the nodes of this call only
+	 * @return The outcome of the solve. The search may pause again
+	 * @throws std::logic_error If no search is paused
+	 */
+	SolveStatus resume(std::array<std::array<char, SUDOKU_SIZE>, SUDOKU_SIZE>& board, const SolveOptions& opts);
+
+	/**
+	 * @brief Check if a search stopped early and can be resumed
+	 * @return true If resume can be called
+	 */
+	bool isPaused() const;
+
+	/**
+	 * @brief Count the solutions of a puzzle, stopping once `limit` are found
+	 *
+	 * Use a limit of 2 to check that a puzzle has exactly one solution.
+	 *
+	 * @param board The sudoku puzzle. It is not modified
+	 * @param limit Stop counting after this many solutions
+	 * @return The number of solutions, at most `limit`
+	 */
+	uint32_t countSolutions(const std::array<std::array<char, SUDOKU_SIZE>, SUDOKU_SIZE>& board, uint32_t limit = 2);
+
+	/**
+	 * @brief Record the deductions of the following solves
+	 *
+	 * The trace is cleared at the start of every solve. After a solve it holds the
+	 * givens and deductions that led to the solution.
+	 *
+	 * @param t The trace to fill, nullptr to stop tracing
+	 * @throws std::logic_error If t is not nullptr and the instrumentation policy has no tracing
+	 */
+	void setTrace(SolveTrace* t);
+
+	/**
+	 * @brief Solve the following puzzles under other rules than the classic ones
+	 *
+	 * @param g The compiled rules. It must outlive the solves
+	 */
+	void setConstraints(const ConstraintGraph& g);
+
+	/**
+	 * @brief Get the counters of the last solve
+	 * @return Statistics of the last call to solveSudoku, partial if the solve was aborted. Only nodes, restarts and elapsed without the counters policy
+	 */
+	const SolveStats& getStats() const;
 };
+
+extern template class BasicSolution<DefaultPolicies>;
+extern template class BasicSolution<FastPolicies>;
+extern template class BasicSolution<StaticOrderPolicies>;
+extern template class BasicSolution<ForwardCheckingPolicies>;
+extern template class BasicSolution<LoggingPolicies>;
+
+/// @brief The solver with every feature configurable at run time
+using Solution = BasicSolution<DefaultPolicies>;
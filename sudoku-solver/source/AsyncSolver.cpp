@@ -0,0 +1,102 @@
+#include "AsyncSolver.h"
+
+#include "Timeline.h"
+#include "sudoku-solver.h"
+
+AsyncSolver::AsyncSolver(unsigned threadCount)
+{
+    if (threadCount == 0) {
+        threadCount = std::thread::hardware_concurrency();
+    }
+    if (threadCount == 0) {
+        threadCount = 1;
+    }
+
+    workers.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; i++) {
+        workers.emplace_back(&AsyncSolver::workerLoop, this);
+    }
+}
+
+AsyncSolver::~AsyncSolver()
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueReady.notify_all();
+
+    for (auto& t : workers) {
+        t.join();
+    }
+}
+
+std::future<AsyncSolveResult> AsyncSolver::submit(const Board& board, SolveOptions opts)
+{
+    // std::function needs a copyable target, so the promise lives in a shared_ptr
+    auto promise = std::make_shared<std::promise<AsyncSolveResult>>();
+    std::future<AsyncSolveResult> future = promise->get_future();
+
+    submit(board, std::move(opts), [promise](AsyncSolveResult& result) {
+        promise->set_value(result);
+    }, [promise](std::exception_ptr error) {
+        promise->set_exception(error);
+    });
+    return future;
+}
+
+void AsyncSolver::submit(const Board& board, SolveOptions opts, Callback onDone, ErrorCallback onError)
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        queue.push_back(Job{ board, std::move(opts), std::move(onDone), std::move(onError) });
+    }
+    queueReady.notify_one();
+}
+
+size_t AsyncSolver::threadCount() const
+{
+    return workers.size();
+}
+
+void AsyncSolver::workerLoop()
+{
+    Solution s;
+    SUDOKU_TIMELINE_THREAD("async worker");
+
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueReady.wait(lock, [this]() { return stopping || !queue.empty(); });
+            if (queue.empty()) return; // stopping and drained
+
+            job = std::move(queue.front());
+            queue.pop_front();
+        }
+
+        AsyncSolveResult result{ job.board, SolveStatus::Cancelled, SolveStats() };
+        std::exception_ptr error;
+        try {
+            if (!job.options.cancellation.isCancelled()) {
+                result.status = s.solveSudoku(result.board, job.options);
+                result.stats = s.getStats();
+            }
+        }
+        catch (...) {
+            error = std::current_exception();
+        }
+
+        // An exception escaping here would end the process, so a throwing callback only loses its own job
+        try {
+            if (!error) {
+                job.onDone(result);
+            }
+            else if (job.onError) {
+                job.onError(error);
+            }
+        }
+        catch (...) {
+        }
+    }
+}
@@ -0,0 +1,358 @@
+#include "BatchScheduler.h"
+
+#include "BitboardSolution.h"
+#include "Timeline.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/// Run `work` on `count` threads, passing each its index, and wait for all of them
+void runOnThreads(unsigned count, const std::function<void(unsigned)>& work)
+{
+    std::vector<std::thread> threads;
+    threads.reserve(count);
+    for (unsigned i = 0; i < count; i++) {
+        threads.emplace_back(work, i);
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+}
+
+/// Unsolved cell with the fewest candidates, -1 if every cell is solved
+int branchCell(const BitboardState& state)
+{
+    int best = -1;
+    int bestCount = 10;
+    for (int c = 0; c < 81; c++) {
+        if (state.solved.test(c)) continue;
+        int n = Bitboard81::popcount(state.candidatesAt(c));
+        if (n < bestCount) {
+            best = c;
+            bestCount = n;
+        }
+    }
+    return best;
+}
+
+/// A puzzle after the prediction step
+struct Prepared {
+    DifficultyEstimate estimate;
+    std::vector<BitboardState> pieces;
+};
+
+/// The pieces of one puzzle, shared by the workers solving them
+struct Group {
+    CancellationToken cancellation;
+    std::atomic<unsigned> remaining{ 0 };
+    std::atomic<bool> solved{ false };
+    std::atomic<bool> overBudget{ false };
+};
+
+/// One piece handed to a worker
+struct Job {
+    size_t puzzle;
+    size_t piece;
+};
+
+/// The puzzles [begin, end) of the batch, given to the workers of one node
+struct Shard {
+    size_t begin = 0;
+    size_t end = 0;
+
+    /// Memory of the node, grown by its first worker
+    NodeArena arena;
+
+    /// Copy of the boards of the shard in the arena, solved in place
+    BatchScheduler::Board* boards = nullptr;
+    std::once_flag allocated;
+
+    /// Next puzzle to prepare, relative to begin
+    std::atomic<size_t> cursor{ 0 };
+
+    std::vector<Job> jobs;
+    std::atomic<size_t> nextJob{ 0 };
+};
+
+}
+
+BatchScheduler::BatchScheduler(const BatchOptions& options)
+    : BatchScheduler(options, options.pinThreads || options.shardByNode ? NumaTopology::detect() : NumaTopology(std::vector<NumaNode>()))
+{
+}
+
+BatchScheduler::BatchScheduler(const BatchOptions& options, const NumaTopology& topology) : options(options)
+{
+    threadCount = options.threads;
+    if (threadCount == 0) {
+        threadCount = std::thread::hardware_concurrency();
+    }
+    if (threadCount == 0) {
+        threadCount = 1;
+    }
+
+    // Workers take the nodes in turn, so even a few threads span every socket
+    const std::vector<NumaNode>& nodes = topology.getNodes();
+    std::vector<size_t> shardOfNode(nodes.size(), SIZE_MAX);
+    for (unsigned t = 0; t < threadCount; t++) {
+        size_t node = t % nodes.size();
+        Placement place{ 0, -1 };
+        if (options.shardByNode) {
+            if (shardOfNode[node] == SIZE_MAX) {
+                shardOfNode[node] = shardThreads.size();
+                shardThreads.push_back(0);
+            }
+            place.shard = shardOfNode[node];
+        }
+        if (options.pinThreads) {
+            const std::vector<int>& cpus = nodes[node].cpus;
+            place.cpu = cpus[(t / nodes.size()) % cpus.size()];
+        }
+        placements.push_back(place);
+    }
+    if (shardThreads.empty()) {
+        shardThreads.push_back(0);
+    }
+    for (const Placement& place : placements) {
+        shardThreads[place.shard]++;
+    }
+}
+
+double BatchScheduler::score(const BitboardState& state)
+{
+    double total = 0;
+    for (int c = 0; c < 81; c++) {
+        if (!state.solved.test(c)) {
+            total += std::log2(static_cast<double>(Bitboard81::popcount(state.candidatesAt(c))));
+        }
+    }
+    return total;
+}
+
+DifficultyEstimate BatchScheduler::estimate(const Board& board)
+{
+    DifficultyEstimate e;
+    BitboardState state;
+    estimate(board, state, e);
+    return e;
+}
+
+bool BatchScheduler::estimate(const Board& board, BitboardState& state, DifficultyEstimate& e)
+{
+    e = DifficultyEstimate();
+    for (const auto& row : board) {
+        for (char c : row) {
+            if (c >= '1' && c <= '9') {
+                e.clues++;
+            }
+        }
+    }
+
+    if (!BitboardSolution::load(board, state)) return false;
+    e.unresolved = 81 - state.solved.count();
+    e.score = score(state);
+    return true;
+}
+
+void BatchScheduler::split(const BitboardState& state, std::vector<BitboardState>& pieces) const
+{
+    const size_t maxPieces = options.maxPieces != 0 ? options.maxPieces : 4 * static_cast<size_t>(threadCount);
+    pieces.assign(1, state);
+    std::vector<double> scores(1, score(state));
+
+    while (!pieces.empty()) {
+        size_t hardest = static_cast<size_t>(std::max_element(scores.begin(), scores.end()) - scores.begin());
+        if (scores[hardest] < options.splitScore) break;
+
+        const BitboardState parent = pieces[hardest];
+        int cell = branchCell(parent);
+        if (cell < 0) break; // Solved by propagation, nothing to split
+        uint16_t digits = parent.candidatesAt(cell);
+        if (pieces.size() - 1 + Bitboard81::popcount(digits) > maxPieces) break;
+
+        pieces.erase(pieces.begin() + hardest);
+        scores.erase(scores.begin() + hardest);
+        for (; digits != 0; digits &= digits - 1) {
+            BitboardState child = parent;
+            if (child.assign(cell, Bitboard81::countTrailingZeros(digits)) && child.propagate()) {
+                pieces.push_back(child);
+                scores.push_back(score(child));
+            }
+        }
+    }
+
+    // Hardest piece first, so it starts as early as possible
+    std::vector<size_t> order(pieces.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&scores](size_t a, size_t b) { return scores[a] > scores[b]; });
+    std::vector<BitboardState> sorted;
+    sorted.reserve(pieces.size());
+    for (size_t i : order) {
+        sorted.push_back(pieces[i]);
+    }
+    pieces.swap(sorted);
+}
+
+std::vector<SolveStatus> BatchScheduler::solve(std::vector<Board>& boards)
+{
+    Clock::time_point start = Clock::now();
+    stats = BatchStats();
+    stats.puzzles = boards.size();
+    stats.threads = threadCount;
+
+    const size_t n = boards.size();
+    const size_t shardCount = shardThreads.size();
+    stats.shards = static_cast<unsigned>(shardCount);
+    std::vector<SolveStatus> statuses(n, SolveStatus::Unsolvable);
+    std::vector<Prepared> prepared(n);
+
+    // Each shard gets a share of the batch proportional to its workers
+    std::unique_ptr<Shard[]> shards(new Shard[shardCount]);
+    unsigned threadsSoFar = 0;
+    for (size_t k = 0; k < shardCount; k++) {
+        shards[k].begin = k == 0 ? 0 : shards[k - 1].end;
+        threadsSoFar += shardThreads[k];
+        shards[k].end = n * threadsSoFar / threadCount;
+    }
+
+    // Predict and split in parallel, the loads cost about as much as an easy solve
+    runOnThreads(threadCount, [&](unsigned t) {
+        SUDOKU_TIMELINE_THREAD("batch worker");
+        const Placement& place = placements[t];
+        if (place.cpu >= 0) {
+            NumaTopology::pinThisThread(place.cpu);
+        }
+        Shard& s = shards[place.shard];
+        std::call_once(s.allocated, [&s]() { s.boards = s.arena.allocateArray<Board>(s.end - s.begin); });
+
+        for (size_t i = s.begin + s.cursor++; i < s.end; i = s.begin + s.cursor++) {
+            SUDOKU_TIMELINE_SCOPE("estimate");
+            Board& board = s.boards[i - s.begin];
+            board = boards[i];
+            Prepared& p = prepared[i];
+            BitboardState state;
+            if (!estimate(board, state, p.estimate)) continue; // Inconsistent givens, no piece
+            if (p.estimate.score >= options.splitScore) {
+                split(state, p.pieces);
+            }
+            else {
+                p.pieces.assign(1, state);
+            }
+        }
+    });
+
+    std::unique_ptr<Group[]> groups(new Group[n]);
+    for (size_t k = 0; k < shardCount; k++) {
+        Shard& s = shards[k];
+        std::vector<size_t> order;
+        for (size_t i = s.begin; i < s.end; i++) {
+            order.push_back(i);
+        }
+        if (options.longestFirst) {
+            std::stable_sort(order.begin(), order.end(), [&prepared](size_t a, size_t b) {
+                return prepared[a].estimate.score > prepared[b].estimate.score;
+            });
+        }
+
+        for (size_t i : order) {
+            groups[i].remaining = static_cast<unsigned>(prepared[i].pieces.size());
+            if (prepared[i].pieces.size() > 1) {
+                stats.splitPuzzles++;
+            }
+            for (size_t piece = 0; piece < prepared[i].pieces.size(); piece++) {
+                s.jobs.push_back(Job{ i, piece });
+            }
+        }
+        stats.pieces += s.jobs.size();
+    }
+
+    std::atomic<int64_t> work{ 0 };
+    std::atomic<int64_t> longest{ 0 };
+    std::atomic<unsigned> pinned{ 0 };
+    std::atomic<uint64_t> stolen{ 0 };
+    runOnThreads(threadCount, [&](unsigned t) {
+        SUDOKU_TIMELINE_THREAD("batch worker");
+        const Placement& place = placements[t];
+        if (place.cpu >= 0 && NumaTopology::pinThisThread(place.cpu)) {
+            pinned++;
+        }
+        BitboardSolution solver;
+
+        // The jobs of the own shard first, then help the others
+        for (size_t k = 0; k < shardCount; k++) {
+            Shard& s = shards[(place.shard + k) % shardCount];
+            for (size_t j = s.nextJob++; j < s.jobs.size(); j = s.nextJob++) {
+                const Job& job = s.jobs[j];
+                Group& g = groups[job.puzzle];
+
+                if (!g.solved.load(std::memory_order_acquire)) {
+                    SUDOKU_TIMELINE_SCOPE("piece");
+                    // A piece skipped because a sibling already won is no help
+                    if (k != 0) {
+                        stolen++;
+                    }
+                    SolveOptions opts;
+                    opts.cancellation = g.cancellation;
+                    opts.maxNodes = options.maxNodes;
+                    opts.deadline = options.deadline;
+
+                    Clock::time_point pieceStart = Clock::now();
+                    BitboardState& state = prepared[job.puzzle].pieces[job.piece];
+                    SolveStatus status = solver.solveState(state, opts);
+                    int64_t took = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - pieceStart).count();
+                    work += took;
+                    for (int64_t seen = longest.load(); took > seen && !longest.compare_exchange_weak(seen, took);) {
+                    }
+
+                    if (status == SolveStatus::Solved) {
+                        // The first solution wins and stops the siblings
+                        if (!g.solved.exchange(true)) {
+                            BitboardSolution::store(state, s.boards[job.puzzle - s.begin]);
+                            statuses[job.puzzle] = SolveStatus::Solved;
+                            g.cancellation.cancel();
+                        }
+                    }
+                    else if (status == SolveStatus::BudgetExceeded) {
+                        g.overBudget = true;
+                    }
+                }
+
+                if (g.remaining.fetch_sub(1) == 1 && !g.solved.load() && g.overBudget.load()) {
+                    statuses[job.puzzle] = SolveStatus::BudgetExceeded;
+                }
+            }
+        }
+    });
+
+    for (size_t k = 0; k < shardCount; k++) {
+        const Shard& s = shards[k];
+        for (size_t i = s.begin; i < s.end; i++) {
+            if (statuses[i] == SolveStatus::Solved) {
+                boards[i] = s.boards[i - s.begin];
+            }
+        }
+    }
+
+    stats.work = std::chrono::nanoseconds(work.load());
+    stats.longestPiece = std::chrono::nanoseconds(longest.load());
+    stats.pinnedThreads = pinned.load();
+    stats.stolenPieces = stolen.load();
+    stats.elapsed = Clock::now() - start;
+    return statuses;
+}
+
+const BatchStats& BatchScheduler::getStats() const
+{
+    return stats;
+}
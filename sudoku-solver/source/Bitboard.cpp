@@ -0,0 +1,185 @@
+#include "Bitboard.h"
+
+#include "SudokuGeometry.h"
+
+const uint64_t Bitboard81::HI_MASK;
+
+namespace {
+
+BitboardMasks buildMasks()
+{
+    BitboardMasks m;
+    const auto& units = SudokuGeometry::units();
+    for (size_t u = 0; u < SudokuGeometry::UNITS; u++) {
+        for (uint8_t c : units[u]) {
+            m.units[u].set(c);
+        }
+    }
+    for (int k = 0; k < 9; k++) {
+        m.rows[k] = m.units[k];
+        m.cols[k] = m.units[9 + k];
+        m.boxes[k] = m.units[18 + k];
+    }
+
+    const auto& peers = SudokuGeometry::peers();
+    for (size_t c = 0; c < SudokuGeometry::CELLS; c++) {
+        for (uint8_t p : peers[c]) {
+            m.peers[c].set(p);
+        }
+    }
+    return m;
+}
+
+}
+
+const BitboardMasks& BitboardMasks::get()
+{
+    static const BitboardMasks masks = buildMasks();
+    return masks;
+}
+
+BitboardState BitboardState::empty()
+{
+    BitboardState s;
+    s.candidates.fill(Bitboard81::all());
+    return s;
+}
+
+bool BitboardState::assign(int c, int digit)
+{
+    Bitboard81& plane = candidates[digit - 1];
+    if (!plane.test(c)) return false;
+
+    Bitboard81 bit = Bitboard81::cell(c);
+    for (auto& other : candidates) {
+        other = other.andNot(bit);
+    }
+    plane = plane.andNot(BitboardMasks::get().peers[c]) | bit;
+    solved |= bit;
+    return true;
+}
+
+int BitboardState::valueAt(int c) const
+{
+    if (!solved.test(c)) return 0;
+    for (int d = 0; d < 9; d++) {
+        if (candidates[d].test(c)) return d + 1;
+    }
+    return 0;
+}
+
+uint16_t BitboardState::candidatesAt(int c) const
+{
+    uint16_t mask = 0;
+    for (int d = 0; d < 9; d++) {
+        if (candidates[d].test(c)) {
+            mask = static_cast<uint16_t>(mask | (1u << (d + 1)));
+        }
+    }
+    return mask;
+}
+
+bool BitboardState::nakedSingles(bool& progress)
+{
+    // Bit-sliced counters: cells with at least one and at least two candidates
+    Bitboard81 atLeastOne;
+    Bitboard81 atLeastTwo;
+    for (const auto& plane : candidates) {
+        atLeastTwo |= atLeastOne & plane;
+        atLeastOne |= plane;
+    }
+    if (atLeastOne != Bitboard81::all()) return false; // A cell has no candidate
+
+    Bitboard81 singles = atLeastOne.andNot(atLeastTwo).andNot(solved);
+    while (singles.any()) {
+        int c = singles.first();
+        singles.reset(c);
+
+        // An earlier placement of this loop may have emptied the cell
+        int digit = 0;
+        for (int d = 0; d < 9 && digit == 0; d++) {
+            if (candidates[d].test(c)) digit = d + 1;
+        }
+        if (digit == 0 || !assign(c, digit)) return false;
+        progress = true;
+    }
+    return true;
+}
+
+bool BitboardState::hiddenSingles(bool& progress)
+{
+    const auto& masks = BitboardMasks::get();
+    for (int d = 0; d < 9; d++) {
+        for (const auto& unit : masks.units) {
+            Bitboard81 spots = candidates[d] & unit;
+            if (spots.none()) return false; // The digit cannot go anywhere in this unit
+            if (spots.count() != 1) continue;
+
+            int c = spots.first();
+            if (solved.test(c)) continue;
+            if (!assign(c, d + 1)) return false;
+            progress = true;
+        }
+    }
+    return true;
+}
+
+void BitboardState::boxLineInteractions(bool& progress)
+{
+    const auto& masks = BitboardMasks::get();
+    for (auto& plane : candidates) {
+        for (int b = 0; b < 9; b++) {
+            Bitboard81 inBox = plane & masks.boxes[b];
+            for (int k = 0; k < 3; k++) {
+                // Pointing: the digit is confined to one row (or column) of the box
+                const Bitboard81& row = masks.rows[(b / 3) * 3 + k];
+                const Bitboard81& col = masks.cols[(b % 3) * 3 + k];
+                Bitboard81 rowOutside = plane & row.andNot(masks.boxes[b]);
+                if (inBox.andNot(row).none() && rowOutside.any()) {
+                    plane = plane.andNot(rowOutside);
+                    progress = true;
+                }
+                Bitboard81 colOutside = plane & col.andNot(masks.boxes[b]);
+                if (inBox.andNot(col).none() && colOutside.any()) {
+                    plane = plane.andNot(colOutside);
+                    progress = true;
+                }
+            }
+        }
+
+        for (int line = 0; line < 9; line++) {
+            Bitboard81 inRow = plane & masks.rows[line];
+            Bitboard81 inCol = plane & masks.cols[line];
+            for (int k = 0; k < 3; k++) {
+                // Claiming: the digit is confined to one box along the row (or column)
+                const Bitboard81& rowBox = masks.boxes[(line / 3) * 3 + k];
+                const Bitboard81& colBox = masks.boxes[k * 3 + line / 3];
+                Bitboard81 rowBoxOutside = plane & rowBox.andNot(masks.rows[line]);
+                if (inRow.andNot(rowBox).none() && rowBoxOutside.any()) {
+                    plane = plane.andNot(rowBoxOutside);
+                    progress = true;
+                }
+                Bitboard81 colBoxOutside = plane & colBox.andNot(masks.cols[line]);
+                if (inCol.andNot(colBox).none() && colBoxOutside.any()) {
+                    plane = plane.andNot(colBoxOutside);
+                    progress = true;
+                }
+            }
+        }
+    }
+}
+
+bool BitboardState::propagate()
+{
+    for (;;) {
+        bool progress = false;
+        if (!nakedSingles(progress)) return false;
+        if (progress) continue;
+
+        if (!hiddenSingles(progress)) return false;
+        if (progress) continue;
+
+        boxLineInteractions(progress);
+        if (!progress) return true;
+    }
+}
@@ -0,0 +1,207 @@
+#include "BitboardSolution.h"
+
+#include "Timeline.h"
+
+const uint64_t BitboardSolution::POLL_INTERVAL;
+
+bool BitboardSolution::load(const Board& board, BitboardState& state)
+{
+    SUDOKU_TIMELINE_SCOPE("load");
+    state = BitboardState::empty();
+    for (int c = 0; c < 81; c++) {
+        char v = board[c / 9][c % 9];
+        if (v >= '1' && v <= '9') {
+            if (!state.assign(c, v - '0')) return false;
+        }
+    }
+    return state.propagate();
+}
+
+void BitboardSolution::store(const BitboardState& state, Board& board)
+{
+    for (int c = 0; c < 81; c++) {
+        int v = state.valueAt(c);
+        if (v != 0) {
+            board[c / 9][c % 9] = static_cast<char>('0' + v);
+        }
+    }
+}
+
+int BitboardSolution::pickCell(const BitboardState& state)
+{
+    // Bit-sliced counters find the cells with exactly two candidates without looking at each cell
+    Bitboard81 atLeastOne;
+    Bitboard81 atLeastTwo;
+    Bitboard81 atLeastThree;
+    for (const auto& plane : state.candidates) {
+        atLeastThree |= atLeastTwo & plane;
+        atLeastTwo |= atLeastOne & plane;
+        atLeastOne |= plane;
+    }
+    Bitboard81 pairs = atLeastTwo.andNot(atLeastThree).andNot(state.solved);
+    if (pairs.any()) return pairs.first();
+
+    int best = -1;
+    int bestCount = 10;
+    Bitboard81 open = Bitboard81::all().andNot(state.solved);
+    while (open.any()) {
+        int c = open.first();
+        open.reset(c);
+        int n = 0;
+        for (const auto& plane : state.candidates) {
+            if (plane.test(c)) n++;
+        }
+        if (n < bestCount) {
+            best = c;
+            bestCount = n;
+        }
+    }
+    return best;
+}
+
+inline bool BitboardSolution::shouldAbort(SolveStatus& why) const
+{
+    if (options == nullptr) return false;
+
+    if (stats.nodes >= options->maxNodes) {
+        why = SolveStatus::BudgetExceeded;
+        return true;
+    }
+    if (stats.nodes % POLL_INTERVAL != 0) return false;
+
+    if (options->cancellation.isCancelled()) {
+        why = SolveStatus::Cancelled;
+        return true;
+    }
+    if (SolveOptions::Clock::now() >= options->deadline) {
+        why = SolveStatus::BudgetExceeded;
+        return true;
+    }
+    return false;
+}
+
+void BitboardSolution::descend()
+{
+    Frame& f = frames[depth];
+    f.state = current;
+    f.cell = pickCell(current);
+    f.untried = current.candidatesAt(f.cell);
+    depth++;
+    if (depth > stats.maxDepth) {
+        stats.maxDepth = static_cast<uint32_t>(depth);
+    }
+}
+
+SolveStatus BitboardSolution::search()
+{
+    SUDOKU_TIMELINE_SCOPE("search");
+    for (;;) {
+        Frame& f = frames[depth - 1];
+        if (f.untried == 0) {
+            depth--;
+            if (depth == 0) return SolveStatus::Unsolvable;
+            stats.backtracks++;
+            continue;
+        }
+
+        SolveStatus why = SolveStatus::Unsolvable;
+        if (shouldAbort(why)) return why;
+        stats.nodes++;
+
+        int v = 1;
+        while ((f.untried & (1 << v)) == 0) {
+            v++;
+        }
+        f.untried = static_cast<uint16_t>(f.untried & (f.untried - 1));
+
+        current = f.state;
+        if (current.assign(f.cell, v) && current.propagate()) {
+            if (current.isComplete()) return SolveStatus::Solved;
+            descend();
+        }
+        else {
+            stats.backtracks++;
+        }
+    }
+}
+
+void BitboardSolution::solveSudoku(Board& board)
+{
+    solveSudoku(board, SolveOptions());
+}
+
+SolveStatus BitboardSolution::solveSudoku(Board& board, const SolveOptions& opts)
+{
+    auto startTime = SolveOptions::Clock::now();
+
+    BitboardState state;
+    SolveStatus status = SolveStatus::Unsolvable;
+    if (load(board, state)) {
+        status = solveState(state, opts);
+    }
+    else {
+        stats = SolveStats();
+    }
+
+    if (status == SolveStatus::Solved) {
+        store(state, board);
+    }
+    stats.elapsed = SolveOptions::Clock::now() - startTime;
+    return status;
+}
+
+SolveStatus BitboardSolution::solveState(BitboardState& state, const SolveOptions& opts)
+{
+    auto startTime = SolveOptions::Clock::now();
+    stats = SolveStats();
+    stats.cellsSetByPropagation = static_cast<uint32_t>(state.solved.count());
+    if (state.isComplete()) return SolveStatus::Solved;
+
+    options = &opts;
+    current = state;
+    if (frames.size() < 81) {
+        frames.resize(81);
+    }
+    depth = 0;
+    descend();
+    SolveStatus status = search();
+    options = nullptr;
+
+    if (status == SolveStatus::Solved) {
+        state = current;
+    }
+    stats.elapsed = SolveOptions::Clock::now() - startTime;
+    return status;
+}
+
+uint32_t BitboardSolution::countSolutions(const Board& board, uint32_t limit)
+{
+    auto startTime = SolveOptions::Clock::now();
+    stats = SolveStats();
+    options = nullptr;
+
+    uint32_t count = 0;
+    if (load(board, current)) {
+        if (current.isComplete()) {
+            count = 1;
+        }
+        else {
+            if (frames.size() < 81) {
+                frames.resize(81);
+            }
+            depth = 0;
+            descend();
+            while (count < limit && search() == SolveStatus::Solved) {
+                count++;
+            }
+        }
+    }
+
+    stats.elapsed = SolveOptions::Clock::now() - startTime;
+    return count;
+}
+
+const SolveStats& BitboardSolution::getStats() const
+{
+    return stats;
+}
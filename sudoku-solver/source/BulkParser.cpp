@@ -0,0 +1,298 @@
+#include "BulkParser.h"
+
+#include "Bitboard.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SUDOKU_PARSER_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+using Board = BulkParser::Board;
+
+static_assert(sizeof(Board) == 81, "A board is copied as 81 contiguous characters");
+
+/// Bytes classified at once when reading a bracketed board
+const size_t WINDOW = 64;
+
+/// A bracketed cell is three bytes, so a window only trusts what its last two bytes can't start
+const size_t WINDOW_STEP = WINDOW - 2;
+
+/// Classes of the bytes of a window, bit i for byte i
+struct Classes {
+    uint64_t quote = 0;
+    /// Digits and '.'
+    uint64_t cell = 0;
+    /// Whitespace and commas
+    uint64_t separator = 0;
+    uint64_t open = 0;
+    uint64_t close = 0;
+};
+
+inline bool isCellChar(char c)
+{
+    return c == '.' || (c >= '0' && c <= '9');
+}
+
+inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+#ifdef SUDOKU_PARSER_SSE2
+
+inline __m128i isByte(__m128i v, char c)
+{
+    return _mm_cmpeq_epi8(v, _mm_set1_epi8(c));
+}
+
+/// Bytes that are '.' or a digit. Bytes of 0x80 and up are negative, so below '0'
+inline __m128i isCell(__m128i v)
+{
+    __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8('9' + 1)));
+    return _mm_or_si128(digit, isByte(v, '.'));
+}
+
+Classes classify(const char* window)
+{
+    Classes k;
+    for (int i = 0; i < 4; i++) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(window + 16 * i));
+        auto bits = [i](__m128i m) {
+            return static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(m))) << (16 * i);
+        };
+        __m128i space = _mm_or_si128(_mm_or_si128(isByte(v, ' '), isByte(v, '\n')), _mm_or_si128(isByte(v, '\r'), isByte(v, '\t')));
+        k.quote |= bits(isByte(v, '"'));
+        k.cell |= bits(isCell(v));
+        k.separator |= bits(_mm_or_si128(space, isByte(v, ',')));
+        k.open |= bits(isByte(v, '['));
+        k.close |= bits(isByte(v, ']'));
+    }
+    return k;
+}
+
+/// Copy the 81 cells of a line, '0' turned into '.'. Returns the index of the first bad one, or 81
+size_t copyLine(const char* line, char* cells)
+{
+    for (size_t i = 0; i < 80; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(line + i));
+        int valid = _mm_movemask_epi8(isCell(v));
+        if (valid != 0xFFFF) return i + Bitboard81::countTrailingZeros(static_cast<uint64_t>(~valid));
+        __m128i zero = isByte(v, '0');
+        v = _mm_or_si128(_mm_andnot_si128(zero, v), _mm_and_si128(zero, _mm_set1_epi8('.')));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(cells + i), v);
+    }
+    if (!isCellChar(line[80])) return 80;
+    cells[80] = line[80] == '0' ? '.' : line[80];
+    return 81;
+}
+
+#else
+
+Classes classify(const char* window)
+{
+    Classes k;
+    for (size_t i = 0; i < WINDOW; i++) {
+        uint64_t bit = uint64_t(1) << i;
+        char c = window[i];
+        if (c == '"') k.quote |= bit;
+        if (isCellChar(c)) k.cell |= bit;
+        if (isSpace(c) || c == ',') k.separator |= bit;
+        if (c == '[') k.open |= bit;
+        if (c == ']') k.close |= bit;
+    }
+    return k;
+}
+
+size_t copyLine(const char* line, char* cells)
+{
+    for (size_t i = 0; i < 81; i++) {
+        if (!isCellChar(line[i])) return i;
+        cells[i] = line[i] == '0' ? '.' : line[i];
+    }
+    return 81;
+}
+
+#endif
+
+std::string describe(char c)
+{
+    if (c == '\n') return "a line break";
+    if (static_cast<unsigned char>(c) < 0x20 || static_cast<unsigned char>(c) >= 0x7F) return "a control or non-ASCII byte";
+    return std::string("'") + c + "'";
+}
+
+/// Reads bracketed boards window by window
+class BracketedReader {
+public:
+    BracketedReader(const char* data, size_t size) : data(data), size(size) {}
+
+    /**
+     * Read the board starting at the '[' at `start`
+     * @return One past its last ']', or 0 with `error` set
+     */
+    size_t read(size_t start, Board& board, ParseError& error);
+
+private:
+    const char* data;
+    size_t size;
+    char padded[WINDOW];
+};
+
+size_t BracketedReader::read(size_t start, Board& board, ParseError& error)
+{
+    char* out = board[0].data();
+    int depth = 0;
+    int cells = 0;
+    int rowStart = 0;
+    uint64_t carry = 0; // Leading bytes already consumed by a cell of the previous window
+
+    auto fail = [&error](size_t offset, std::string message) {
+        error.offset = offset;
+        error.message = std::move(message);
+        return size_t(0);
+    };
+
+    for (size_t cursor = start; cursor < size;) {
+        const size_t remaining = size - cursor;
+        const char* window = data + cursor;
+        size_t trusted = WINDOW_STEP;
+        if (remaining < WINDOW) {
+            // Spaces after the end never complete a cell nor count as an error
+            std::memcpy(padded, window, remaining);
+            std::memset(padded + remaining, ' ', WINDOW - remaining);
+            window = padded;
+            trusted = remaining;
+        }
+        const uint64_t inWindow = (uint64_t(1) << trusted) - 1;
+
+        // A cell is a quote, a digit or '.', and a quote
+        const Classes k = classify(window);
+        const uint64_t starts = k.quote & (k.cell >> 1) & (k.quote >> 2) & ~carry & inWindow;
+        const uint64_t covered = carry | starts | (starts << 1) | (starts << 2);
+        const uint64_t bad = ~(k.separator | k.open | k.close | covered) & inWindow;
+        const uint64_t beforeBad = bad == 0 ? inWindow : (uint64_t(1) << Bitboard81::countTrailingZeros(bad)) - 1;
+
+        // Cells and brackets in order, up to the first bad byte
+        for (uint64_t events = (starts | k.open | k.close) & beforeBad; events != 0; events &= events - 1) {
+            const int p = Bitboard81::countTrailingZeros(events);
+            const size_t offset = cursor + p;
+            const uint64_t bit = uint64_t(1) << p;
+            if (starts & bit) {
+                if (depth != 2) return fail(offset, "Cell outside of a row");
+                if (cells == 81) return fail(offset, "More than 81 cells");
+                char c = window[p + 1];
+                out[cells++] = c == '0' ? '.' : c;
+            }
+            else if (k.open & bit) {
+                if (++depth > 2) return fail(offset, "Brackets nested deeper than rows");
+                rowStart = cells;
+            }
+            else {
+                if (depth == 2 && cells - rowStart != 9) return fail(offset, "Row of " + std::to_string(cells - rowStart) + " cells");
+                if (--depth == 0) {
+                    if (cells != 81) return fail(offset, "Board of " + std::to_string(cells) + " cells");
+                    return offset + 1;
+                }
+            }
+        }
+        if (bad != 0) {
+            const int p = Bitboard81::countTrailingZeros(bad);
+            if (window[p] == '"' && p + 2 < static_cast<int>(WINDOW) && window[p + 2] == '"') {
+                return fail(cursor + p + 1, "Unexpected " + describe(window[p + 1]) + " in a cell");
+            }
+            return fail(cursor + p, "Unexpected " + describe(window[p]));
+        }
+
+        carry = covered >> trusted;
+        cursor += trusted;
+    }
+    return fail(size, "Board not closed");
+}
+
+}
+
+ParseResult BulkParser::parse(const char* data, size_t size)
+{
+    ParseResult result;
+    BracketedReader bracketed(data, size);
+    Board board;
+    size_t i = 0;
+
+    auto skipLine = [data, size](size_t from) {
+        const void* nl = from < size ? std::memchr(data + from, '\n', size - from) : nullptr;
+        return nl == nullptr ? size : static_cast<size_t>(static_cast<const char*>(nl) - data) + 1;
+    };
+
+    while (i < size) {
+        const char c = data[i];
+        if (isSpace(c)) {
+            i++;
+        }
+        else if (c == '#') {
+            i = skipLine(i);
+        }
+        else if (c == '[') {
+            ParseError error;
+            size_t end = bracketed.read(i, board, error);
+            if (end != 0) {
+                result.boards.push_back(board);
+                result.offsets.push_back(i);
+                i = end;
+                continue;
+            }
+            result.errors.push_back(error);
+
+            // Resume after the closing brackets of the broken board
+            const char close[] = "]]";
+            const char* next = std::search(data + std::min(error.offset, static_cast<uint64_t>(size)), data + size, close, close + 2);
+            i = next == data + size ? size : static_cast<size_t>(next - data) + 2;
+        }
+        else if (isCellChar(c)) {
+            const size_t next = skipLine(i);
+            size_t length = next - i;
+            if (data[next - 1] == '\n') length--;
+
+            if (length >= 81) {
+                const size_t bad = copyLine(data + i, board[0].data());
+                if (bad == 81) {
+                    result.boards.push_back(board);
+                    result.offsets.push_back(i);
+                }
+                else {
+                    result.errors.push_back(ParseError{ i + bad, "Unexpected " + describe(data[i + bad]) + " in a line board" });
+                }
+            }
+            else {
+                const size_t cells = static_cast<size_t>(std::find_if(data + i, data + i + length, [](char x) { return !isCellChar(x); }) - (data + i));
+                const bool lineEnd = cells == length || (cells + 1 == length && data[i + cells] == '\r');
+                if (lineEnd) result.errors.push_back(ParseError{ i + cells, "Line board of " + std::to_string(cells) + " cells" });
+                else result.errors.push_back(ParseError{ i + cells, "Unexpected " + describe(data[i + cells]) + " in a line board" });
+            }
+            i = next;
+        }
+        else {
+            result.errors.push_back(ParseError{ i, "Unexpected " + describe(c) + " at the start of a record" });
+            i = skipLine(i);
+        }
+    }
+    return result;
+}
+
+ParseResult BulkParser::parseFile(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) throw std::runtime_error("Unable to read " + path);
+    std::string content(static_cast<size_t>(in.tellg()), '\0');
+    in.seekg(0);
+    if (!content.empty() && !in.read(&content[0], static_cast<std::streamsize>(content.size()))) {
+        throw std::runtime_error("Unable to read " + path);
+    }
+    return parse(content.data(), content.size());
+}
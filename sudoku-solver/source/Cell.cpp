@@ -84,6 +84,11 @@ std::list<int> Cell::getRemainingPossiblities() const
     return retVect;
 }
 
+uint16_t Cell::getRemainingPossibilitiesMask() const
+{
+    return static_cast<uint16_t>(~constraints.to_ulong() & 0x3FE);
+}
+
 void Cell::setCellValue(int i)
 {
     if(valueIsSet()) {
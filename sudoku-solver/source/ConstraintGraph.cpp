@@ -0,0 +1,181 @@
+#include "ConstraintGraph.h"
+
+#include "SudokuGeometry.h"
+
+#include <algorithm>
+#include <bitset>
+#include <map>
+#include <stdexcept>
+
+const size_t ConstraintGraph::CELLS;
+
+namespace {
+
+const uint16_t ALL_DIGITS = 0x3FE;
+
+/// Every set of distinct digits, as masks with bit d for digit d, grouped by size and sum
+struct Combinations {
+    /// Offsets into masks of the sets of each (size, sum), size 0-9 and sum 0-45
+    std::array<std::array<uint16_t, 47>, 10> start;
+    std::vector<uint16_t> masks;
+
+    Combinations()
+    {
+        std::array<std::array<std::vector<uint16_t>, 46>, 10> groups;
+        for (uint16_t bits = 0; bits < 512; bits++) {
+            uint16_t mask = static_cast<uint16_t>(bits << 1);
+            int size = 0;
+            int sum = 0;
+            for (int d = 1; d <= 9; d++) {
+                if ((mask >> d) & 1) {
+                    size++;
+                    sum += d;
+                }
+            }
+            groups[size][sum].push_back(mask);
+        }
+        for (int size = 0; size <= 9; size++) {
+            for (int sum = 0; sum <= 45; sum++) {
+                start[size][sum] = static_cast<uint16_t>(masks.size());
+                masks.insert(masks.end(), groups[size][sum].begin(), groups[size][sum].end());
+            }
+            start[size][46] = static_cast<uint16_t>(masks.size());
+        }
+    }
+
+    static const Combinations& get()
+    {
+        static const Combinations table;
+        return table;
+    }
+};
+
+/// Check that `cells` are distinct cells of the board
+void checkCells(const uint8_t* first, const uint8_t* last, const char* what)
+{
+    std::bitset<ConstraintGraph::CELLS> seen;
+    for (const uint8_t* c = first; c != last; c++) {
+        if (*c >= ConstraintGraph::CELLS) throw std::invalid_argument(std::string(what) + " names a cell outside the board");
+        if (seen.test(*c)) throw std::invalid_argument(std::string(what) + " names a cell twice");
+        seen.set(*c);
+    }
+}
+
+}
+
+RuleSet RuleSet::classic()
+{
+    RuleSet rules;
+    const auto& units = SudokuGeometry::units();
+    rules.units.assign(units.begin(), units.end());
+    return rules;
+}
+
+RuleSet RuleSet::diagonal()
+{
+    RuleSet rules = classic();
+    std::array<uint8_t, 9> main;
+    std::array<uint8_t, 9> anti;
+    for (int k = 0; k < 9; k++) {
+        main[k] = static_cast<uint8_t>(k * 9 + k);
+        anti[k] = static_cast<uint8_t>(k * 9 + 8 - k);
+    }
+    rules.units.push_back(main);
+    rules.units.push_back(anti);
+    return rules;
+}
+
+RuleSet RuleSet::jigsaw(const std::string& regions)
+{
+    if (regions.size() != ConstraintGraph::CELLS) throw std::invalid_argument("A jigsaw layout has 81 cells");
+
+    std::map<char, std::vector<uint8_t>> cellsOf;
+    for (size_t c = 0; c < regions.size(); c++) {
+        cellsOf[regions[c]].push_back(static_cast<uint8_t>(c));
+    }
+    if (cellsOf.size() != 9) throw std::invalid_argument("A jigsaw layout has nine regions");
+
+    RuleSet rules;
+    const auto& units = SudokuGeometry::units();
+    rules.units.assign(units.begin(), units.begin() + 18); // Rows and columns
+    for (const auto& region : cellsOf) {
+        if (region.second.size() != 9) throw std::invalid_argument("Every jigsaw region has nine cells");
+        std::array<uint8_t, 9> unit;
+        std::copy(region.second.begin(), region.second.end(), unit.begin());
+        rules.units.push_back(unit);
+    }
+    return rules;
+}
+
+RuleSet RuleSet::killer(std::vector<Cage> cages)
+{
+    RuleSet rules = classic();
+    rules.cages = std::move(cages);
+    return rules;
+}
+
+ConstraintGraph::ConstraintGraph(const RuleSet& rules) : units(rules.units)
+{
+    // Who shares a constraint with whom
+    std::array<std::bitset<CELLS>, CELLS> related;
+    for (const auto& unit : units) {
+        checkCells(unit.data(), unit.data() + unit.size(), "A unit");
+        for (uint8_t a : unit) {
+            for (uint8_t b : unit) {
+                related[a].set(b);
+            }
+        }
+    }
+
+    std::vector<std::vector<uint16_t>> cagesOfCell(CELLS);
+    for (const Cage& c : rules.cages) {
+        checkCells(c.cells.data(), c.cells.data() + c.cells.size(), "A cage");
+        if (c.cells.empty() || c.cells.size() > 9 || c.sum < 1 || c.sum > 45 || cageDigits(static_cast<int>(c.cells.size()), c.sum, 0, ALL_DIGITS) == 0) {
+            throw std::invalid_argument("No set of distinct digits fills a cage of " + std::to_string(c.cells.size()) + " cells summing to " + std::to_string(c.sum));
+        }
+
+        const uint16_t k = static_cast<uint16_t>(cages.size());
+        cages.push_back(CompiledCage{ static_cast<uint16_t>(cageCellList.size()), static_cast<uint8_t>(c.cells.size()), static_cast<uint8_t>(c.sum) });
+        cageCellList.insert(cageCellList.end(), c.cells.begin(), c.cells.end());
+        for (uint8_t a : c.cells) {
+            cagesOfCell[a].push_back(k);
+            for (uint8_t b : c.cells) {
+                related[a].set(b);
+            }
+        }
+    }
+
+    for (size_t c = 0; c < CELLS; c++) {
+        peerStart[c] = static_cast<uint16_t>(peerList.size());
+        for (size_t p = 0; p < CELLS; p++) {
+            if (p != c && related[c].test(p)) {
+                peerList.push_back(static_cast<uint8_t>(p));
+            }
+        }
+        cageStart[c] = static_cast<uint16_t>(cageIndex.size());
+        cageIndex.insert(cageIndex.end(), cagesOfCell[c].begin(), cagesOfCell[c].end());
+    }
+    peerStart[CELLS] = static_cast<uint16_t>(peerList.size());
+    cageStart[CELLS] = static_cast<uint16_t>(cageIndex.size());
+}
+
+const ConstraintGraph& ConstraintGraph::classic()
+{
+    static const ConstraintGraph graph(RuleSet::classic());
+    return graph;
+}
+
+uint16_t ConstraintGraph::cageDigits(int count, int sum, uint16_t used, uint16_t available)
+{
+    if (count < 0 || count > 9 || sum < 0 || sum > 45) return 0;
+
+    const Combinations& table = Combinations::get();
+    uint16_t digits = 0;
+    for (uint16_t i = table.start[count][sum]; i < table.start[count][sum + 1]; i++) {
+        uint16_t mask = table.masks[i];
+        if ((mask & used) == 0 && (mask & ~available) == 0) {
+            digits |= mask;
+        }
+    }
+    return digits;
+}
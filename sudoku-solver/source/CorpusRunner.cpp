@@ -0,0 +1,519 @@
+#include "CorpusRunner.h"
+
+#include "BatchScheduler.h"
+#include "PuzzleFormat.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#if defined(_WIN32)
+#include <direct.h>
+#include <windows.h>
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const char* PLAN_HEADER = "sudoku-corpus-plan 1";
+
+void makeDirectory(const std::string& path)
+{
+#if defined(_WIN32)
+    int failed = _mkdir(path.c_str());
+#else
+    int failed = mkdir(path.c_str(), 0777);
+#endif
+    if (failed != 0 && errno != EEXIST) throw std::runtime_error("Unable to create " + path);
+}
+
+bool fileExists(const std::string& path)
+{
+    return std::ifstream(path).good();
+}
+
+/// Size of a file, 0 if it is missing
+uint64_t fileSize(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    return in ? static_cast<uint64_t>(in.tellg()) : 0;
+}
+
+/// Move `from` over `to` in one step, so readers see the old or the new file and nothing in between
+void replaceFile(const std::string& from, const std::string& to)
+{
+#if defined(_WIN32)
+    bool moved = MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    bool moved = std::rename(from.c_str(), to.c_str()) == 0;
+#endif
+    if (!moved) throw std::runtime_error("Unable to replace " + to);
+}
+
+/// Move `from` to `to` unless `to` exists. Unlike replaceFile, a file created there meanwhile is never overwritten
+bool moveIfAbsent(const std::string& from, const std::string& to)
+{
+#if defined(_WIN32)
+    return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    // link fails if the target exists, where rename would replace it
+    if (link(from.c_str(), to.c_str()) != 0) return false;
+    std::remove(from.c_str());
+    return true;
+#endif
+}
+
+/// Write a whole file through a temporary one named after the writer
+void writeAtomically(const std::string& path, const std::string& content, const std::string& writer)
+{
+    const std::string temporary = path + ".tmp-" + writer;
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        out << content;
+        out.flush();
+        if (!out) throw std::runtime_error("Unable to write " + temporary);
+    }
+    replaceFile(temporary, path);
+}
+
+/// Create a file that must not exist yet. Exactly one of several racing creators succeeds
+bool createExclusively(const std::string& path, const std::string& content)
+{
+    std::FILE* f = std::fopen(path.c_str(), "wx");
+    if (f == nullptr) return false;
+    bool written = std::fputs(content.c_str(), f) >= 0;
+    written = std::fclose(f) == 0 && written;
+    if (!written) throw std::runtime_error("Unable to write " + path);
+    return true;
+}
+
+int64_t nowSeconds()
+{
+    return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+bool readClaim(const std::string& path, std::string& owner, int64_t& stamp)
+{
+    std::ifstream in(path);
+    return static_cast<bool>(in >> owner >> stamp);
+}
+
+std::string randomWorkerName()
+{
+    std::random_device device;
+    std::ostringstream name;
+    name << "worker-" << std::hex << device() << device();
+    return name.str();
+}
+
+/// Calls `refresh` every `interval` on a thread of its own until destroyed
+class LeaseKeeper {
+public:
+    LeaseKeeper(std::chrono::milliseconds interval, std::function<void()> refresh)
+        : thread([this, interval, refresh]() {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (!wake.wait_for(lock, interval, [this]() { return stopping; })) {
+                refresh();
+            }
+        })
+    {
+    }
+
+    ~LeaseKeeper()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        thread.join();
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+    std::thread thread; // Last, so it starts once the others exist
+};
+
+void writeStats(std::ostream& out, const CorpusStats& s)
+{
+    out << "puzzles " << s.puzzles << '\n'
+        << "solved " << s.solved << '\n'
+        << "unsolvable " << s.unsolvable << '\n'
+        << "budget " << s.overBudget << '\n'
+        << "invalid " << s.invalid << '\n'
+        << "nanos " << s.solveTime.count() << '\n';
+}
+
+}
+
+CorpusStats& CorpusStats::operator+=(const CorpusStats& o)
+{
+    puzzles += o.puzzles;
+    solved += o.solved;
+    unsolvable += o.unsolvable;
+    overBudget += o.overBudget;
+    invalid += o.invalid;
+    solveTime += o.solveTime;
+    return *this;
+}
+
+CorpusRunner::CorpusRunner(const std::string& directory, const CorpusOptions& options) : directory(directory), options(options)
+{
+    if (this->options.worker.empty()) {
+        this->options.worker = randomWorkerName();
+    }
+    if (this->options.checkpointEvery == 0) {
+        this->options.checkpointEvery = 1;
+    }
+}
+
+CorpusPlan CorpusRunner::plan(const std::string& input, const std::string& directory, uint64_t linesPerShard)
+{
+    if (linesPerShard == 0) throw std::invalid_argument("A shard needs at least one line");
+
+    std::ifstream in(input, std::ios::binary);
+    if (!in) throw std::runtime_error("Unable to read " + input);
+
+    CorpusPlan plan;
+    plan.input = input;
+    std::string line;
+    uint64_t offset = 0;
+    while (std::getline(in, line)) {
+        if (plan.shards.empty() || plan.shards.back().lines == linesPerShard) {
+            CorpusShard shard;
+            shard.offset = offset;
+            plan.shards.push_back(shard);
+        }
+        plan.shards.back().lines++;
+        offset += line.size() + 1;
+    }
+
+    makeDirectory(directory);
+    std::ostringstream text;
+    text << PLAN_HEADER << '\n' << "input " << input << '\n';
+    for (const auto& shard : plan.shards) {
+        text << "shard " << shard.offset << ' ' << shard.lines << '\n';
+    }
+    if (!createExclusively(directory + "/plan", text.str())) {
+        throw std::runtime_error(directory + " already holds a plan");
+    }
+    return plan;
+}
+
+CorpusPlan CorpusRunner::loadPlan() const
+{
+    std::ifstream in(directory + "/plan");
+    std::string line;
+    if (!std::getline(in, line) || line != PLAN_HEADER) throw std::runtime_error("No plan in " + directory);
+
+    CorpusPlan plan;
+    if (!std::getline(in, line) || line.compare(0, 6, "input ") != 0) throw std::runtime_error("Corrupt plan in " + directory);
+    plan.input = line.substr(6);
+
+    std::string word;
+    CorpusShard shard;
+    while (in >> word >> shard.offset >> shard.lines) {
+        if (word != "shard") throw std::runtime_error("Corrupt plan in " + directory);
+        plan.shards.push_back(shard);
+    }
+    return plan;
+}
+
+std::string CorpusRunner::pathOf(size_t shard, const char* suffix) const
+{
+    return directory + "/shard-" + std::to_string(shard) + suffix;
+}
+
+bool CorpusRunner::claim(size_t shard)
+{
+    const std::string path = pathOf(shard, ".claim");
+    const std::string content = options.worker + ' ' + std::to_string(nowSeconds()) + '\n';
+    if (createExclusively(path, content)) return true;
+
+    std::string owner;
+    int64_t stamp = 0;
+    if (!readClaim(path, owner, stamp)) return false; // Being written, so alive
+    if (owner == options.worker) return true;         // Left by an earlier run of this worker
+    if (nowSeconds() - stamp < options.lease.count()) return false;
+
+    // The owner stopped refreshing. Only one of the workers noticing can move its claim away
+    const std::string stale = path + ".stale-" + options.worker;
+    if (std::rename(path.c_str(), stale.c_str()) != 0) return false;
+
+    // Another worker that saw the same stamp may have taken the shard over in
+    // between, in which case its fresh claim was moved: put it back. A third
+    // worker may have claimed the free shard meanwhile, its claim then stands
+    // and the moved one is void
+    std::string movedOwner;
+    int64_t movedStamp = 0;
+    if (!readClaim(stale, movedOwner, movedStamp) || movedOwner != owner || movedStamp != stamp) {
+        if (!moveIfAbsent(stale, path)) {
+            std::remove(stale.c_str());
+        }
+        return false;
+    }
+    std::remove(stale.c_str());
+    return createExclusively(path, content);
+}
+
+void CorpusRunner::refreshClaim(size_t shard)
+{
+    writeAtomically(pathOf(shard, ".claim"), options.worker + ' ' + std::to_string(nowSeconds()) + '\n', options.worker);
+}
+
+bool CorpusRunner::ownsClaim(size_t shard) const
+{
+    std::string owner;
+    int64_t stamp = 0;
+    return readClaim(pathOf(shard, ".claim"), owner, stamp) && owner == options.worker;
+}
+
+bool CorpusRunner::readProgress(const std::string& path, Progress& progress)
+{
+    std::ifstream in(path);
+    if (!in) return false;
+
+    Progress p;
+    std::string key;
+    int64_t nanos = 0;
+    for (uint64_t value = 0; in >> key >> value;) {
+        if (key == "next") p.next = value;
+        else if (key == "bytes") p.bytes = value;
+        else if (key == "puzzles") p.stats.puzzles = value;
+        else if (key == "solved") p.stats.solved = value;
+        else if (key == "unsolvable") p.stats.unsolvable = value;
+        else if (key == "budget") p.stats.overBudget = value;
+        else if (key == "invalid") p.stats.invalid = value;
+        else if (key == "nanos") nanos = static_cast<int64_t>(value);
+    }
+    p.stats.solveTime = std::chrono::nanoseconds(nanos);
+    progress = p;
+    return true;
+}
+
+void CorpusRunner::writeProgress(const std::string& path, const Progress& progress) const
+{
+    std::ostringstream text;
+    text << "next " << progress.next << '\n' << "bytes " << progress.bytes << '\n';
+    writeStats(text, progress.stats);
+    writeAtomically(path, text.str(), options.worker);
+}
+
+bool CorpusRunner::solveShard(size_t shard, const CorpusShard& range, const std::string& input)
+{
+    const std::string progressPath = pathOf(shard, ".progress");
+    const std::string outPath = pathOf(shard, ".out");
+
+    // Replacing the output unlinks the file the owner appends to, so a worker
+    // whose claim was taken over right after claiming must leave it alone
+    if (!ownsClaim(shard)) return false;
+
+    Progress progress;
+    readProgress(progressPath, progress);
+
+    // Drop the results written after the last checkpoint. The output is always
+    // replaced, so a former owner still holding the old file open writes into
+    // a file nobody reads
+    uint64_t size = fileSize(outPath);
+    if (size < progress.bytes) {
+        progress = Progress(); // Output lost, start the shard again
+    }
+    {
+        std::string kept(static_cast<size_t>(progress.bytes), '\0');
+        std::ifstream old(outPath, std::ios::binary);
+        old.read(&kept[0], static_cast<std::streamsize>(kept.size()));
+        if (!ownsClaim(shard)) return false;
+        writeAtomically(outPath, kept, options.worker);
+    }
+    const std::chrono::milliseconds refreshEvery = std::max(std::chrono::milliseconds(1), std::chrono::duration_cast<std::chrono::milliseconds>(options.lease) / 4);
+
+    std::ifstream in(input, std::ios::binary);
+    if (!in) throw std::runtime_error("Unable to read " + input);
+    in.seekg(static_cast<std::streamoff>(range.offset));
+    std::string line;
+    for (uint64_t i = 0; i < progress.next; i++) {
+        std::getline(in, line);
+    }
+
+    std::ofstream out(outPath, std::ios::binary | std::ios::app);
+    BatchOptions batchOptions;
+    batchOptions.threads = options.threads;
+    batchOptions.maxNodes = options.maxNodes;
+    BatchScheduler scheduler(batchOptions);
+
+    std::vector<BatchScheduler::Board> boards;
+    std::vector<bool> parsed; // One entry per result line, false for an invalid line
+    std::string text;
+    while (progress.next < range.lines) {
+        boards.clear();
+        parsed.clear();
+        while (progress.next < range.lines && boards.size() < options.checkpointEvery) {
+            if (!std::getline(in, line)) throw std::runtime_error(input + " is shorter than planned");
+            progress.next++;
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            if (line.empty() || line[0] == '#') continue;
+
+            BatchScheduler::Board board;
+            parsed.push_back(PuzzleFormat::fromLine(line, board));
+            if (parsed.back()) {
+                boards.push_back(board);
+            }
+        }
+
+        const std::vector<BatchScheduler::Board> puzzles = boards;
+        Clock::time_point start = Clock::now();
+        std::vector<SolveStatus> statuses;
+        {
+            // A chunk may take longer than the lease, so keep the claim fresh while solving
+            LeaseKeeper keeper(refreshEvery, [this, shard]() {
+                if (ownsClaim(shard)) {
+                    refreshClaim(shard);
+                }
+            });
+            statuses = scheduler.solve(boards);
+        }
+        progress.stats.solveTime += Clock::now() - start;
+
+        text.clear();
+        size_t b = 0;
+        for (bool valid : parsed) {
+            progress.stats.puzzles++;
+            if (!valid) {
+                progress.stats.invalid++;
+                text += "invalid\n";
+                continue;
+            }
+            switch (statuses[b]) {
+            case SolveStatus::Solved:
+                progress.stats.solved++;
+                text += PuzzleFormat::toLine(boards[b]);
+                break;
+            case SolveStatus::Unsolvable:
+                progress.stats.unsolvable++;
+                text += PuzzleFormat::toLine(puzzles[b]) + " unsolvable";
+                break;
+            default:
+                progress.stats.overBudget++;
+                text += PuzzleFormat::toLine(puzzles[b]) + " budget";
+                break;
+            }
+            text += '\n';
+            b++;
+        }
+
+        // A worker that outlived its lease lets the new owner redo the chunk, and leaves the output alone
+        if (!ownsClaim(shard)) return false;
+        out.write(text.data(), static_cast<std::streamsize>(text.size()));
+        out.flush();
+        if (!out) throw std::runtime_error("Unable to write " + outPath);
+        progress.bytes += text.size();
+
+        writeProgress(progressPath, progress);
+        refreshClaim(shard);
+    }
+
+    writeProgress(pathOf(shard, ".done"), progress);
+    std::remove(progressPath.c_str());
+    std::remove(pathOf(shard, ".claim").c_str());
+    return true;
+}
+
+size_t CorpusRunner::work()
+{
+    const CorpusPlan plan = loadPlan();
+    size_t finished = 0;
+    for (size_t k = 0; k < plan.shards.size(); k++) {
+        if (fileExists(pathOf(k, ".done")) || !claim(k)) continue;
+
+        // Finished by another worker between the two checks
+        if (fileExists(pathOf(k, ".done"))) {
+            std::remove(pathOf(k, ".claim").c_str());
+            continue;
+        }
+        if (solveShard(k, plan.shards[k], plan.input)) {
+            finished++;
+        }
+    }
+    return finished;
+}
+
+std::vector<ShardState> CorpusRunner::status() const
+{
+    const CorpusPlan plan = loadPlan();
+    std::vector<ShardState> states(plan.shards.size(), ShardState::Pending);
+    for (size_t k = 0; k < states.size(); k++) {
+        if (fileExists(pathOf(k, ".done"))) {
+            states[k] = ShardState::Done;
+        }
+        else if (fileExists(pathOf(k, ".claim"))) {
+            states[k] = ShardState::Claimed;
+        }
+    }
+    return states;
+}
+
+CorpusStats CorpusRunner::finishedStats() const
+{
+    const CorpusPlan plan = loadPlan();
+    CorpusStats total;
+    for (size_t k = 0; k < plan.shards.size(); k++) {
+        Progress done;
+        if (readProgress(pathOf(k, ".done"), done)) {
+            total += done.stats;
+        }
+    }
+    return total;
+}
+
+CorpusStats CorpusRunner::merge(const std::string& output) const
+{
+    const CorpusPlan plan = loadPlan();
+    CorpusStats total;
+    const std::string temporary = output + ".tmp-merge";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        for (size_t k = 0; k < plan.shards.size(); k++) {
+            Progress done;
+            if (!readProgress(pathOf(k, ".done"), done)) {
+                out.close();
+                std::remove(temporary.c_str());
+                throw std::runtime_error("Shard " + std::to_string(k) + " is not done");
+            }
+            total += done.stats;
+
+            // Only the bytes the last checkpoint vouches for
+            std::ifstream in(pathOf(k, ".out"), std::ios::binary);
+            std::vector<char> buffer(1 << 16);
+            for (uint64_t left = done.bytes; left > 0;) {
+                const size_t chunk = static_cast<size_t>(std::min<uint64_t>(left, buffer.size()));
+                if (!in.read(buffer.data(), static_cast<std::streamsize>(chunk))) {
+                    out.close();
+                    std::remove(temporary.c_str());
+                    throw std::runtime_error("Output of shard " + std::to_string(k) + " is shorter than checkpointed");
+                }
+                out.write(buffer.data(), static_cast<std::streamsize>(chunk));
+                left -= chunk;
+            }
+        }
+        out.flush();
+        if (!out) throw std::runtime_error("Unable to write " + temporary);
+    }
+    replaceFile(temporary, output);
+    return total;
+}
@@ -0,0 +1,80 @@
+#include "LatencyHistogram.h"
+
+#include "Bitboard.h"
+
+#include <cmath>
+#include <stdexcept>
+
+LatencyHistogram::LatencyHistogram(uint64_t highest, int significantDigits) : highest(highest)
+{
+    if (significantDigits < 1 || significantDigits > 5) throw std::invalid_argument("A histogram keeps 1 to 5 significant digits");
+    if (highest < 2) throw std::invalid_argument("A histogram needs a highest value of at least 2");
+
+    // Enough sub-buckets per power of two that neighbouring values differ by less than one unit of the last digit
+    uint64_t largestSingleUnit = 2 * static_cast<uint64_t>(std::pow(10.0, significantDigits));
+    int subBucketCountMagnitude = static_cast<int>(std::ceil(std::log2(static_cast<double>(largestSingleUnit))));
+    subBucketHalfCountMagnitude = subBucketCountMagnitude - 1;
+    subBucketHalfCount = uint64_t(1) << subBucketHalfCountMagnitude;
+    subBucketMask = (uint64_t(1) << subBucketCountMagnitude) - 1;
+
+    counts.assign(indexOf(highest) + 1, 0);
+}
+
+size_t LatencyHistogram::indexOf(uint64_t value) const
+{
+    // Values below the first power of two past the sub-buckets share bucket 0 at full resolution
+    int bucket = 64 - Bitboard81::countLeadingZeros(value | subBucketMask) - (subBucketHalfCountMagnitude + 1);
+    uint64_t subBucket = value >> bucket;
+    return static_cast<size_t>((static_cast<uint64_t>(bucket + 1) << subBucketHalfCountMagnitude) + subBucket - subBucketHalfCount);
+}
+
+uint64_t LatencyHistogram::highestValueAt(size_t index) const
+{
+    int bucket = static_cast<int>(index >> subBucketHalfCountMagnitude) - 1;
+    uint64_t subBucket = (index & (subBucketHalfCount - 1)) + subBucketHalfCount;
+    if (bucket < 0) {
+        bucket = 0;
+        subBucket -= subBucketHalfCount;
+    }
+    uint64_t lowest = subBucket << bucket;
+    return lowest + (uint64_t(1) << bucket) - 1;
+}
+
+void LatencyHistogram::add(const LatencyHistogram& o)
+{
+    if (o.highest != highest || o.subBucketMask != subBucketMask) throw std::invalid_argument("Histograms of different ranges can't be added");
+    for (size_t i = 0; i < counts.size(); i++) {
+        counts[i] += o.counts[i];
+    }
+    total += o.total;
+    sum += o.sum;
+    if (o.smallest < smallest) smallest = o.smallest;
+    if (o.largest > largest) largest = o.largest;
+}
+
+void LatencyHistogram::reset()
+{
+    counts.assign(counts.size(), 0);
+    total = 0;
+    sum = 0;
+    smallest = UINT64_MAX;
+    largest = 0;
+}
+
+uint64_t LatencyHistogram::valueAtPercentile(double percentile) const
+{
+    if (total == 0) return 0;
+    if (percentile > 100.0) percentile = 100.0;
+
+    uint64_t rank = static_cast<uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(total)));
+    if (rank == 0) rank = 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); i++) {
+        seen += counts[i];
+        if (seen >= rank) {
+            uint64_t value = highestValueAt(i);
+            return value < largest ? value : largest;
+        }
+    }
+    return largest;
+}
@@ -0,0 +1,95 @@
+#include "LoadReplay.h"
+
+#include "AsyncSolver.h"
+#include "sudoku-solver.h"
+
+#include <cmath>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+void count(ReplayStats& stats, SolveStatus status)
+{
+    switch (status) {
+    case SolveStatus::Solved:
+        stats.solved++;
+        break;
+    case SolveStatus::Unsolvable:
+        stats.unsolvable++;
+        break;
+    default:
+        stats.overBudget++;
+        break;
+    }
+}
+
+}
+
+LoadReplay::LoadReplay(const ReplayConfig& config) : config(config)
+{
+    if (!(config.rate > 0)) throw std::invalid_argument("The arrival rate must be positive");
+}
+
+ReplayStats LoadReplay::run(const std::vector<Board>& corpus)
+{
+    ReplayStats stats;
+    if (corpus.empty()) return stats;
+
+    const uint64_t requests = config.requests == 0 ? corpus.size() : config.requests;
+    const double interval = 1e9 / config.rate;
+    SolveOptions opts;
+    opts.maxNodes = config.maxNodesPerPuzzle;
+
+    // Computed from the start rather than accumulated, so rounding never drifts the schedule
+    const Clock::time_point start = Clock::now();
+    auto dueTime = [start, interval](uint64_t i) {
+        return start + std::chrono::nanoseconds(static_cast<int64_t>(std::llround(static_cast<double>(i) * interval)));
+    };
+
+    // Sleep until the arrival is due, or send at once to catch up if already late
+    auto waitFor = [&stats](Clock::time_point due) {
+        Clock::time_point now = Clock::now();
+        if (now < due) {
+            std::this_thread::sleep_until(due);
+        }
+        else if (now - due > stats.maxSendLag) {
+            stats.maxSendLag = now - due;
+        }
+    };
+
+    if (config.mode == ReplayMode::Inline) {
+        Solution s;
+        for (uint64_t i = 0; i < requests; i++) {
+            const Clock::time_point due = dueTime(i);
+            waitFor(due);
+            Board board = corpus[i % corpus.size()];
+            count(stats, s.solveSudoku(board, opts));
+            stats.response.record(Clock::now() - due);
+            stats.service.record(s.getStats().elapsed);
+        }
+    }
+    else {
+        std::mutex statsMutex;
+        AsyncSolver pool(config.threads);
+        for (uint64_t i = 0; i < requests; i++) {
+            const Clock::time_point due = dueTime(i);
+            waitFor(due);
+            pool.submit(corpus[i % corpus.size()], opts, [&stats, &statsMutex, due](AsyncSolveResult& result) {
+                const Clock::time_point done = Clock::now();
+                std::lock_guard<std::mutex> lock(statsMutex);
+                count(stats, result.status);
+                stats.response.record(done - due);
+                stats.service.record(result.stats.elapsed);
+            });
+        }
+        // Leaving the scope drains the queue before joining the workers
+    }
+
+    stats.sent = requests;
+    stats.elapsed = Clock::now() - start;
+    return stats;
+}
@@ -0,0 +1,208 @@
+#include "LockstepSolver.h"
+
+#include "SudokuGeometry.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SUDOKU_LOCKSTEP_SSE2 1
+#include <emmintrin.h>
+#endif
+
+const size_t LockstepSolver::LANES;
+
+namespace {
+
+const uint16_t ALL_DIGITS = 0x3FE;
+
+#ifdef SUDOKU_LOCKSTEP_SSE2
+
+/// @brief The eight lanes of a cell in one SSE2 register
+struct LaneVector {
+    __m128i v;
+
+    static LaneVector load(const std::array<uint16_t, 8>& a) { return { _mm_load_si128(reinterpret_cast<const __m128i*>(a.data())) }; }
+    void store(std::array<uint16_t, 8>& a) const { _mm_store_si128(reinterpret_cast<__m128i*>(a.data()), v); }
+    static LaneVector zero() { return { _mm_setzero_si128() }; }
+
+    LaneVector operator&(LaneVector o) const { return { _mm_and_si128(v, o.v) }; }
+    LaneVector operator|(LaneVector o) const { return { _mm_or_si128(v, o.v) }; }
+    LaneVector operator^(LaneVector o) const { return { _mm_xor_si128(v, o.v) }; }
+    /// @brief this & ~o
+    LaneVector andNot(LaneVector o) const { return { _mm_andnot_si128(o.v, v) }; }
+
+    /// @brief All ones in the lanes equal to zero
+    LaneVector isZero() const { return { _mm_cmpeq_epi16(v, _mm_setzero_si128()) }; }
+    /// @brief All ones in the lanes holding at most one bit
+    LaneVector isSingleOrZero() const { return { _mm_cmpeq_epi16(_mm_and_si128(v, _mm_sub_epi16(v, _mm_set1_epi16(1))), _mm_setzero_si128()) }; }
+    bool any() const { return _mm_movemask_epi8(_mm_cmpeq_epi16(v, _mm_setzero_si128())) != 0xFFFF; }
+};
+
+#else
+
+/// @brief The eight lanes of a cell, for targets without SSE2. Loops over the lanes are left to the compiler
+struct LaneVector {
+    std::array<uint16_t, 8> v;
+
+    static LaneVector load(const std::array<uint16_t, 8>& a) { return { a }; }
+    void store(std::array<uint16_t, 8>& a) const { a = v; }
+    static LaneVector zero() { return { {} }; }
+
+    template <typename F>
+    LaneVector map(F f) const {
+        LaneVector r;
+        for (size_t l = 0; l < 8; l++) r.v[l] = static_cast<uint16_t>(f(v[l], l));
+        return r;
+    }
+
+    LaneVector operator&(LaneVector o) const { return map([&o](uint16_t x, size_t l) { return x & o.v[l]; }); }
+    LaneVector operator|(LaneVector o) const { return map([&o](uint16_t x, size_t l) { return x | o.v[l]; }); }
+    LaneVector operator^(LaneVector o) const { return map([&o](uint16_t x, size_t l) { return x ^ o.v[l]; }); }
+    LaneVector andNot(LaneVector o) const { return map([&o](uint16_t x, size_t l) { return x & ~o.v[l]; }); }
+
+    LaneVector isZero() const { return map([](uint16_t x, size_t) { return x == 0 ? 0xFFFF : 0; }); }
+    LaneVector isSingleOrZero() const { return map([](uint16_t x, size_t) { return (x & (x - 1)) == 0 ? 0xFFFF : 0; }); }
+    bool any() const {
+        uint16_t r = 0;
+        for (uint16_t x : v) r |= x;
+        return r != 0;
+    }
+};
+
+#endif
+
+}
+
+void LockstepSolver::load(const Board* boards, size_t count)
+{
+    for (size_t c = 0; c < 81; c++) {
+        for (size_t l = 0; l < LANES; l++) {
+            uint16_t mask = ALL_DIGITS;
+            if (l < count) {
+                char v = boards[l][c / 9][c % 9];
+                if (v >= '1' && v <= '9') {
+                    mask = static_cast<uint16_t>(1u << (v - '0'));
+                }
+            }
+            candidates[c][l] = mask;
+            propagated[c][l] = 0;
+        }
+    }
+}
+
+bool LockstepSolver::eliminateSingles()
+{
+    const auto& peers = SudokuGeometry::peers();
+    bool changed = false;
+
+    for (size_t c = 0; c < 81; c++) {
+        LaneVector v = LaneVector::load(candidates[c]);
+        LaneVector done = LaneVector::load(propagated[c]);
+        LaneVector single = (v & v.isSingleOrZero()).andNot(done);
+        if (!single.any()) continue;
+
+        (done | single).store(propagated[c]);
+        changed = true;
+        for (uint8_t p : peers[c]) {
+            LaneVector::load(candidates[p]).andNot(single).store(candidates[p]);
+        }
+    }
+    return changed;
+}
+
+bool LockstepSolver::placeHiddenSingles()
+{
+    const auto& units = SudokuGeometry::units();
+    LaneVector diff = LaneVector::zero();
+
+    for (const auto& unit : units) {
+        LaneVector once = LaneVector::zero();
+        LaneVector twice = LaneVector::zero();
+        for (uint8_t c : unit) {
+            LaneVector v = LaneVector::load(candidates[c]);
+            twice = twice | (once & v);
+            once = once | v;
+        }
+        LaneVector hiddenDigits = once.andNot(twice);
+
+        for (uint8_t c : unit) {
+            LaneVector v = LaneVector::load(candidates[c]);
+            LaneVector hidden = v & hiddenDigits;
+            // A cell holding two hidden singles is a contradiction, it is left for the final check
+            LaneVector take = hidden.isSingleOrZero().andNot(hidden.isZero());
+            LaneVector next = (hidden & take) | v.andNot(take);
+            diff = diff | (next ^ v);
+            next.store(candidates[c]);
+        }
+    }
+    return diff.any();
+}
+
+void LockstepSolver::solve(Board* boards, size_t count, SolveStatus* statuses)
+{
+    for (size_t first = 0; first < count; first += LANES) {
+        size_t lanes = count - first < LANES ? count - first : LANES;
+        load(boards + first, lanes);
+
+        bool changed = true;
+        while (changed) {
+            changed = eliminateSingles();
+            if (placeHiddenSingles()) {
+                changed = true;
+            }
+        }
+
+        for (size_t l = 0; l < lanes; l++) {
+            Board& board = boards[first + l];
+            bool contradiction = false;
+            bool complete = true;
+            for (size_t c = 0; c < 81; c++) {
+                uint16_t v = candidates[c][l];
+                contradiction = contradiction || v == 0;
+                complete = complete && (v & (v - 1)) == 0;
+            }
+
+            if (contradiction) {
+                statuses[first + l] = SolveStatus::Unsolvable;
+                stats.unsolvableInLockstep++;
+                continue;
+            }
+
+            // Singles are written as givens, either as the answer or as the start of the scalar search
+            Board partial = board;
+            for (size_t c = 0; c < 81; c++) {
+                uint16_t v = candidates[c][l];
+                if ((v & (v - 1)) == 0) {
+                    int d = 1;
+                    while (v != (1u << d)) {
+                        d++;
+                    }
+                    partial[c / 9][c % 9] = static_cast<char>('0' + d);
+                }
+            }
+
+            if (complete) {
+                board = partial;
+                statuses[first + l] = SolveStatus::Solved;
+                stats.solvedInLockstep++;
+                continue;
+            }
+
+            stats.fellBack++;
+            statuses[first + l] = scalar.solveSudoku(partial, SolveOptions());
+            if (statuses[first + l] == SolveStatus::Solved) {
+                board = partial;
+            }
+        }
+    }
+}
+
+std::vector<SolveStatus> LockstepSolver::solve(std::vector<Board>& boards)
+{
+    std::vector<SolveStatus> statuses(boards.size());
+    solve(boards.data(), boards.size(), statuses.data());
+    return statuses;
+}
+
+const LockstepStats& LockstepSolver::getStats() const
+{
+    return stats;
+}
@@ -0,0 +1,128 @@
+#include "MinimalityChecker.h"
+
+#include "Timeline.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace {
+
+/// Assign the kept clues of a range on top of a state and propagate them
+void addClues(const uint8_t* clues, size_t count, const Bitboard81& kept, const std::array<uint8_t, 81>& solution, BitboardState& state)
+{
+    for (size_t i = 0; i < count; i++) {
+        if (kept.test(clues[i])) {
+            state.assign(clues[i], solution[clues[i]]);
+        }
+    }
+    // The clues all agree with the solution, so this never finds a contradiction
+    state.propagate();
+}
+
+}
+
+MinimalityResult MinimalityChecker::run(const Board& puzzle, MinimalityMode mode)
+{
+    SUDOKU_TIMELINE_SCOPE("minimality");
+    MinimalityResult r;
+    r.puzzle = puzzle;
+    r.solutions = solver.countSolutions(puzzle, 2);
+    if (r.solutions != 1) return r;
+
+    BitboardState solved;
+    BitboardSolution::load(puzzle, solved);
+    solver.solveState(solved, SolveOptions());
+
+    std::vector<uint8_t> clues;
+    kept = Bitboard81();
+    for (int c = 0; c < 81; c++) {
+        solution[c] = static_cast<uint8_t>(solved.valueAt(c));
+        char v = puzzle[c / 9][c % 9];
+        if (v >= '1' && v <= '9') {
+            clues.push_back(static_cast<uint8_t>(c));
+            kept.set(c);
+        }
+    }
+
+    this->mode = mode;
+    result = &r;
+    if (!clues.empty()) {
+        tryClues(clues.data(), clues.size(), BitboardState::empty());
+    }
+    result = nullptr;
+
+    if (mode == MinimalityMode::Reduce) {
+        for (uint8_t c : r.redundant) {
+            r.puzzle[c / 9][c % 9] = '.';
+        }
+    }
+    return r;
+}
+
+void MinimalityChecker::tryClues(const uint8_t* clues, size_t count, const BitboardState& base)
+{
+    if (count == 1) {
+        if (!hasOtherSolution(clues[0], base)) {
+            result->redundant.push_back(clues[0]);
+            if (mode == MinimalityMode::Reduce) {
+                kept.reset(clues[0]);
+            }
+        }
+        return;
+    }
+
+    // The first half is tried with the second one in place, then the second
+    // half with whatever the first one kept
+    const size_t half = count / 2;
+    BitboardState state = base;
+    addClues(clues + half, count - half, kept, solution, state);
+    tryClues(clues, half, state);
+
+    state = base;
+    addClues(clues, half, kept, solution, state);
+    tryClues(clues + half, count - half, state);
+}
+
+bool MinimalityChecker::hasOtherSolution(int cell, const BitboardState& base)
+{
+    static const SolveOptions unbounded;
+
+    // Any other solution differs from the known one at the removed clue
+    BitboardState state = base;
+    state.candidates[solution[cell] - 1].reset(cell);
+    result->trials++;
+    if (!state.propagate()) return false;
+
+    SolveStatus status = solver.solveState(state, unbounded);
+    result->nodes += solver.getStats().nodes;
+    return status == SolveStatus::Solved;
+}
+
+std::vector<MinimalityResult> MinimalityChecker::runAll(const std::vector<Board>& puzzles, MinimalityMode mode, unsigned threads)
+{
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+    }
+    threads = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threads, puzzles.size())));
+
+    std::vector<MinimalityResult> results(puzzles.size());
+    std::atomic<size_t> next(0);
+    auto work = [&]() {
+        SUDOKU_TIMELINE_THREAD("minimality");
+        MinimalityChecker checker;
+        for (size_t i = next++; i < puzzles.size(); i = next++) {
+            results[i] = checker.run(puzzles[i], mode);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (unsigned t = 0; t < threads; t++) {
+        workers.emplace_back(work);
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    return results;
+}
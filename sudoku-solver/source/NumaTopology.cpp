@@ -0,0 +1,203 @@
+#include "NumaTopology.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <thread>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace {
+
+bool readLine(const std::string& path, std::string& line)
+{
+    std::ifstream in(path);
+    return static_cast<bool>(std::getline(in, line));
+}
+
+/// CPUs the process may run on, in increasing order
+std::vector<int> allowedCpus()
+{
+    std::vector<int> cpus;
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &set)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+#endif
+    if (cpus.empty()) {
+        unsigned n = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned cpu = 0; cpu < n; cpu++) {
+            cpus.push_back(static_cast<int>(cpu));
+        }
+    }
+    return cpus;
+}
+
+}
+
+NumaTopology::NumaTopology(std::vector<NumaNode> nodes)
+{
+    for (auto& node : nodes) {
+        if (!node.cpus.empty()) {
+            this->nodes.push_back(std::move(node));
+        }
+    }
+    if (this->nodes.empty()) {
+        NumaNode only;
+        only.cpus.push_back(0);
+        this->nodes.push_back(only);
+    }
+}
+
+NumaTopology NumaTopology::detect()
+{
+    const std::vector<int> allowed = allowedCpus();
+    std::vector<NumaNode> nodes;
+
+    std::string line;
+    std::vector<int> ids;
+    if (readLine("/sys/devices/system/node/online", line) && parseCpuList(line, ids)) {
+        for (int id : ids) {
+            NumaNode node;
+            node.id = id;
+            std::vector<int> cpus;
+            if (readLine("/sys/devices/system/node/node" + std::to_string(id) + "/cpulist", line) && parseCpuList(line, cpus)) {
+                for (int cpu : cpus) {
+                    if (std::binary_search(allowed.begin(), allowed.end(), cpu)) {
+                        node.cpus.push_back(cpu);
+                    }
+                }
+            }
+            nodes.push_back(node);
+        }
+    }
+
+    bool found = false;
+    for (const auto& node : nodes) {
+        found = found || !node.cpus.empty();
+    }
+    if (!found) {
+        // No NUMA information, the machine is one node
+        NumaNode whole;
+        whole.cpus = allowed;
+        nodes.assign(1, whole);
+    }
+    return NumaTopology(nodes);
+}
+
+const std::vector<NumaNode>& NumaTopology::getNodes() const
+{
+    return nodes;
+}
+
+size_t NumaTopology::cpuCount() const
+{
+    size_t n = 0;
+    for (const auto& node : nodes) {
+        n += node.cpus.size();
+    }
+    return n;
+}
+
+bool NumaTopology::parseCpuList(const std::string& text, std::vector<int>& cpus)
+{
+    cpus.clear();
+    const char* p = text.c_str();
+    while (*p != '\0' && *p != '\n') {
+        char* end = nullptr;
+        long first = std::strtol(p, &end, 10);
+        if (end == p || first < 0) return false;
+        long last = first;
+        p = end;
+        if (*p == '-') {
+            last = std::strtol(p + 1, &end, 10);
+            if (end == p + 1 || last < first) return false;
+            p = end;
+        }
+        for (long cpu = first; cpu <= last; cpu++) {
+            cpus.push_back(static_cast<int>(cpu));
+        }
+        if (*p == ',') {
+            p++;
+        }
+        else if (*p != '\0' && *p != '\n') {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool NumaTopology::pinThisThread(int cpu)
+{
+#if defined(__linux__)
+    if (cpu < 0 || cpu >= CPU_SETSIZE) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+NodeArena::NodeArena(size_t blockSize) : blockSize(blockSize)
+{
+}
+
+NodeArena::~NodeArena()
+{
+    release();
+}
+
+void* NodeArena::allocate(size_t bytes, size_t alignment)
+{
+    if (bytes == 0) return nullptr; // An empty shard must not cost a block
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!blocks.empty()) {
+        size_t offset = (used + alignment - 1) & ~(alignment - 1);
+        if (offset + bytes <= blocks.back().size) {
+            used = offset + bytes;
+            return blocks.back().data + offset;
+        }
+    }
+
+    // malloc aligns to max_align_t, so a fresh block starts aligned
+    size_t size = std::max(blockSize, bytes);
+    char* data = static_cast<char*>(std::malloc(size));
+    if (data == nullptr) throw std::bad_alloc();
+    std::memset(data, 0, size); // First touch, from the thread that will use it
+    blocks.push_back(Block{ data, size });
+    used = bytes;
+    return data;
+}
+
+void NodeArena::release()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& b : blocks) {
+        std::free(b.data);
+    }
+    blocks.clear();
+    used = 0;
+}
+
+size_t NodeArena::reserved() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t n = 0;
+    for (const auto& b : blocks) {
+        n += b.size;
+    }
+    return n;
+}
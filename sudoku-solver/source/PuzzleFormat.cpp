@@ -0,0 +1,31 @@
+#include "PuzzleFormat.h"
+
+const size_t PuzzleFormat::LINE_LENGTH;
+
+std::string PuzzleFormat::toLine(const Board& board)
+{
+    std::string line;
+    line.reserve(LINE_LENGTH);
+    for (const auto& row : board) {
+        for (char c : row) {
+            line.push_back(c);
+        }
+    }
+    return line;
+}
+
+bool PuzzleFormat::fromLine(const std::string& line, Board& board)
+{
+    if (line.size() < LINE_LENGTH) return false;
+
+    for (size_t k = 0; k < LINE_LENGTH; k++) {
+        char c = line[k];
+        if (c == '0') {
+            c = '.';
+        }
+        if (c != '.' && (c < '1' || c > '9')) return false;
+
+        board[k / 9][k % 9] = c;
+    }
+    return true;
+}
@@ -0,0 +1,201 @@
+#include "PuzzleGenerator.h"
+
+#include "sudoku-solver.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/// Upper bounds on backtrack nodes for each grade. Anything above Hard is Expert
+const uint64_t MEDIUM_MAX_NODES = 5;
+const uint64_t HARD_MAX_NODES = 50;
+
+}
+
+PuzzleGenerator::PuzzleGenerator(uint64_t seed) : rng(seed)
+{
+}
+
+int PuzzleGenerator::randomBelow(int n)
+{
+    return std::uniform_int_distribution<int>(0, n - 1)(rng);
+}
+
+PuzzleGenerator::Board PuzzleGenerator::randomSolvedGrid()
+{
+    // Any permutation of the digits on the first row can be completed
+    Board grid;
+    for (auto& row : grid) {
+        row.fill('.');
+    }
+    std::array<char, 9> digits = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+    std::shuffle(digits.begin(), digits.end(), rng);
+    grid[0] = digits;
+
+    Solution s;
+    s.solveSudoku(grid);
+
+    // The solver is deterministic, so shuffle the grid with symmetries that keep it valid
+    std::array<char, 9> relabel = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+    std::shuffle(relabel.begin(), relabel.end(), rng);
+
+    std::array<int, 9> rows;
+    std::array<int, 9> cols;
+    std::array<int, 3> bands = { 0, 1, 2 };
+    std::array<int, 3> stacks = { 0, 1, 2 };
+    std::shuffle(bands.begin(), bands.end(), rng);
+    std::shuffle(stacks.begin(), stacks.end(), rng);
+    for (int b = 0; b < 3; b++) {
+        std::array<int, 3> inBand = { 0, 1, 2 };
+        std::array<int, 3> inStack = { 0, 1, 2 };
+        std::shuffle(inBand.begin(), inBand.end(), rng);
+        std::shuffle(inStack.begin(), inStack.end(), rng);
+        for (int k = 0; k < 3; k++) {
+            rows[b * 3 + k] = bands[b] * 3 + inBand[k];
+            cols[b * 3 + k] = stacks[b] * 3 + inStack[k];
+        }
+    }
+    bool transpose = randomBelow(2) == 1;
+
+    Board shuffled;
+    for (int i = 0; i < 9; i++) {
+        for (int j = 0; j < 9; j++) {
+            char c = transpose ? grid[cols[j]][rows[i]] : grid[rows[i]][cols[j]];
+            shuffled[i][j] = relabel[c - '1'];
+        }
+    }
+    return shuffled;
+}
+
+GeneratedPuzzle PuzzleGenerator::generate()
+{
+    return carve(Difficulty::Expert);
+}
+
+GeneratedPuzzle PuzzleGenerator::carve(Difficulty ceiling)
+{
+    GeneratedPuzzle result;
+    result.solution = randomSolvedGrid();
+    result.puzzle = result.solution;
+    result.clues = 81;
+
+    std::array<int, 81> order;
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), rng);
+
+    Solution s;
+    for (int k : order) {
+        char& cell = result.puzzle[k / 9][k % 9];
+        char removed = cell;
+        cell = '.';
+        if (s.countSolutions(result.puzzle, 2) == 1 && (ceiling == Difficulty::Expert || grade(result.puzzle) <= ceiling)) {
+            result.clues--;
+        }
+        else {
+            cell = removed;
+        }
+    }
+
+    SolveStats stats;
+    result.difficulty = grade(result.puzzle, &stats);
+    result.nodes = stats.nodes;
+    return result;
+}
+
+bool PuzzleGenerator::generate(Difficulty target, unsigned maxAttempts, GeneratedPuzzle& result)
+{
+    for (unsigned attempt = 0; attempt < maxAttempts; attempt++) {
+        result = carve(target);
+        if (result.difficulty == target) return true;
+    }
+    return false;
+}
+
+Difficulty PuzzleGenerator::grade(const Board& puzzle, SolveStats* stats)
+{
+    Board board = puzzle;
+    Solution s;
+    // Grades are defined on the chronological search, so they do not move when learning improves
+    SolveOptions opts;
+    opts.learnFromConflicts = false;
+    s.solveSudoku(board, opts);
+    if (stats != nullptr) {
+        *stats = s.getStats();
+    }
+
+    uint64_t nodes = s.getStats().nodes;
+    if (nodes == 0) return Difficulty::Easy;
+    if (nodes <= MEDIUM_MAX_NODES) return Difficulty::Medium;
+    if (nodes <= HARD_MAX_NODES) return Difficulty::Hard;
+    return Difficulty::Expert;
+}
+
+uint64_t PuzzleGenerator::generateParallel(uint64_t count, Difficulty target, unsigned threadCount, uint64_t seed,
+                                           const std::function<void(const GeneratedPuzzle&)>& sink, uint64_t maxAttempts)
+{
+    if (threadCount == 0) {
+        threadCount = std::thread::hardware_concurrency();
+    }
+    if (threadCount == 0) {
+        threadCount = 1;
+    }
+
+    std::atomic<uint64_t> claimed(0);
+    std::atomic<uint64_t> attempted(0);
+    std::mutex sinkMutex;
+    uint64_t delivered = 0;
+
+    auto worker = [&](unsigned index) {
+        // Spread the seeds so neighbouring workers do not share a sequence
+        PuzzleGenerator generator(seed + 0x9E3779B97F4A7C15ULL * (index + 1));
+        GeneratedPuzzle p;
+        while (claimed.fetch_add(1) < count) {
+            // One attempt at a time against the shared budget, every attempt starts from a new grid
+            do {
+                if (attempted.fetch_add(1) >= maxAttempts) return;
+            } while (!generator.generate(target, 1, p));
+            std::lock_guard<std::mutex> lock(sinkMutex);
+            sink(p);
+            delivered++;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < threadCount; i++) {
+        threads.emplace_back(worker, i);
+    }
+    worker(0);
+    for (auto& t : threads) {
+        t.join();
+    }
+    return delivered;
+}
+
+const char* PuzzleGenerator::difficultyName(Difficulty d)
+{
+    switch (d) {
+    case Difficulty::Easy: return "easy";
+    case Difficulty::Medium: return "medium";
+    case Difficulty::Hard: return "hard";
+    case Difficulty::Expert: return "expert";
+    }
+    return "unknown";
+}
+
+bool PuzzleGenerator::parseDifficulty(const char* name, Difficulty& d)
+{
+    const Difficulty all[] = { Difficulty::Easy, Difficulty::Medium, Difficulty::Hard, Difficulty::Expert };
+    for (Difficulty candidate : all) {
+        if (std::strcmp(name, difficultyName(candidate)) == 0) {
+            d = candidate;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,293 @@
+#include "SolutionEnumerator.h"
+
+#include "Bitboard.h"
+#include "BitboardSolution.h"
+#include "Timeline.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+const size_t SolutionEnumerator::BINARY_SIZE;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/// Solutions a worker encodes before handing them to the sink
+const uint64_t BLOCK_SOLUTIONS = 1024;
+
+/// The root of a subtree: a digit per cell, 0 when empty
+using Piece = std::array<uint8_t, 81>;
+
+inline int squareOf(int c)
+{
+    return (c / 27) * 3 + (c % 9) / 3;
+}
+
+/// Digit masks of the rows, columns and squares, and the empty cells, of one subtree
+struct Masks {
+    std::array<uint16_t, 27> used;
+    std::array<uint8_t, 81> empty;
+    int emptyCount;
+
+    explicit Masks(const Piece& piece) : used(), empty(), emptyCount(0)
+    {
+        for (int c = 0; c < 81; c++) {
+            if (piece[c] == 0) empty[emptyCount++] = static_cast<uint8_t>(c);
+            else place(c, static_cast<uint16_t>(1u << piece[c]));
+        }
+    }
+
+    uint16_t candidates(int c) const
+    {
+        return static_cast<uint16_t>(0x3FE & ~(used[c / 9] | used[9 + c % 9] | used[18 + squareOf(c)]));
+    }
+
+    void place(int c, uint16_t bit)
+    {
+        used[c / 9] |= bit;
+        used[9 + c % 9] |= bit;
+        used[18 + squareOf(c)] |= bit;
+    }
+
+    void unplace(int c, uint16_t bit)
+    {
+        used[c / 9] &= static_cast<uint16_t>(~bit);
+        used[9 + c % 9] &= static_cast<uint16_t>(~bit);
+        used[18 + squareOf(c)] &= static_cast<uint16_t>(~bit);
+    }
+
+    /// Move the empty cell with the fewest candidates, from position `from` on, to `from`
+    uint16_t pick(int from)
+    {
+        int best = from;
+        int bestCount = 10;
+        uint16_t bestMask = 0;
+        for (int i = from; i < emptyCount && bestCount > 1; i++) {
+            uint16_t mask = candidates(empty[i]);
+            int n = Bitboard81::popcount(mask);
+            if (n < bestCount) {
+                best = i;
+                bestCount = n;
+                bestMask = mask;
+            }
+        }
+        std::swap(empty[from], empty[best]);
+        return bestMask;
+    }
+};
+
+/// Cut the tree breadth first until there are `target` subtrees or nothing is left to cut
+std::vector<Piece> cutPieces(const Piece& root, size_t target)
+{
+    std::vector<Piece> level{ root };
+    std::vector<Piece> next;
+    while (level.size() < target) {
+        bool grew = false;
+        next.clear();
+        for (const Piece& p : level) {
+            Masks m(p);
+            if (m.emptyCount == 0) {
+                next.push_back(p);
+                continue;
+            }
+            uint16_t digits = m.pick(0);
+            for (int d = 1; d <= 9; d++) {
+                if ((digits >> d) & 1) {
+                    next.push_back(p);
+                    next.back()[m.empty[0]] = static_cast<uint8_t>(d);
+                }
+            }
+            grew = true;
+        }
+        level.swap(next);
+        if (!grew) break;
+    }
+    return level;
+}
+
+void encode(const Piece& values, SolutionFormat format, std::vector<char>& out)
+{
+    if (format == SolutionFormat::Line) {
+        for (int c = 0; c < 81; c++) {
+            out.push_back(static_cast<char>('0' + values[c]));
+        }
+        out.push_back('\n');
+        return;
+    }
+    for (int c = 0; c < 81; c += 2) {
+        int high = c + 1 < 81 ? values[c + 1] : 0;
+        out.push_back(static_cast<char>(values[c] | (high << 4)));
+    }
+}
+
+/// Shared by the workers of one run
+struct Run {
+    SolutionSink& sink;
+    const EnumerateOptions& options;
+    std::vector<Piece> pieces;
+    std::atomic<size_t> nextPiece{ 0 };
+    std::atomic<bool> stop{ false };
+    std::atomic<uint64_t> nodes{ 0 };
+
+    std::mutex sinkMutex;
+    uint64_t written = 0;
+    std::exception_ptr error;
+
+    Run(SolutionSink& sink, const EnumerateOptions& options) : sink(sink), options(options) {}
+
+    /// Hand a block to the sink, cut to the limit
+    void flush(std::vector<char>& block, uint64_t count)
+    {
+        std::lock_guard<std::mutex> lock(sinkMutex);
+        uint64_t take = std::min(count, options.limit - written);
+        if (take != 0) {
+            size_t bytes = static_cast<size_t>(block.size() / count * take);
+            try {
+                sink.write(block.data(), bytes, take);
+            }
+            catch (...) {
+                if (!error) error = std::current_exception();
+                stop = true;
+            }
+            written += take;
+        }
+        if (written >= options.limit) {
+            stop = true;
+        }
+        block.clear();
+    }
+
+    void work()
+    {
+        SUDOKU_TIMELINE_THREAD("enumerator");
+        const uint64_t blockSize = std::min<uint64_t>(BLOCK_SOLUTIONS, options.limit);
+        const size_t recordSize = options.format == SolutionFormat::Line ? 82 : SolutionEnumerator::BINARY_SIZE;
+        std::vector<char> block;
+        block.reserve(static_cast<size_t>(blockSize) * recordSize);
+        uint64_t inBlock = 0;
+        uint64_t tried = 0;
+
+        std::array<uint16_t, 81> untried;
+        std::array<uint16_t, 81> placed;
+        for (size_t i = nextPiece++; i < pieces.size() && !stop.load(std::memory_order_relaxed); i = nextPiece++) {
+            SUDOKU_TIMELINE_SCOPE("subtree");
+            Piece values = pieces[i];
+            Masks m(values);
+
+            // Depth-first over the empty cells, undoing each digit on the way back
+            int depth = 0;
+            bool descend = true;
+            for (;;) {
+                if (descend) {
+                    if (depth == m.emptyCount) {
+                        encode(values, options.format, block);
+                        if (++inBlock == blockSize) {
+                            flush(block, inBlock);
+                            inBlock = 0;
+                            if (stop.load(std::memory_order_relaxed)) break;
+                        }
+                        if (depth == 0) break;
+                        depth--;
+                        descend = false;
+                        continue;
+                    }
+                    untried[depth] = m.pick(depth);
+                }
+                else {
+                    m.unplace(m.empty[depth], placed[depth]);
+                }
+
+                if (untried[depth] == 0) {
+                    if (depth == 0) break;
+                    depth--;
+                    descend = false;
+                    continue;
+                }
+                uint16_t bit = static_cast<uint16_t>(untried[depth] & (0u - untried[depth]));
+                untried[depth] = static_cast<uint16_t>(untried[depth] & ~bit);
+                placed[depth] = bit;
+                m.place(m.empty[depth], bit);
+                values[m.empty[depth]] = static_cast<uint8_t>(Bitboard81::countTrailingZeros(bit));
+                tried++;
+                depth++;
+                descend = true;
+            }
+        }
+        if (inBlock != 0) {
+            flush(block, inBlock);
+        }
+        nodes += tried;
+    }
+};
+
+}
+
+void StreamSolutionSink::write(const char* data, size_t size, uint64_t)
+{
+    out.write(data, static_cast<std::streamsize>(size));
+}
+
+SolutionEnumerator::SolutionEnumerator(const EnumerateOptions& options) : options(options)
+{
+    if (this->options.threads == 0) {
+        this->options.threads = std::thread::hardware_concurrency();
+    }
+    if (this->options.threads == 0) {
+        this->options.threads = 1;
+    }
+    if (this->options.piecesPerThread == 0) {
+        this->options.piecesPerThread = 1;
+    }
+}
+
+EnumerateStats SolutionEnumerator::run(const Board& puzzle, SolutionSink& sink)
+{
+    const Clock::time_point start = Clock::now();
+    EnumerateStats stats;
+
+    // Singles and box/line eliminations first, so the cut starts from a smaller tree
+    BitboardState state;
+    if (options.limit == 0 || !BitboardSolution::load(puzzle, state)) {
+        stats.elapsed = Clock::now() - start;
+        return stats;
+    }
+    Piece root;
+    for (int c = 0; c < 81; c++) {
+        root[c] = static_cast<uint8_t>(state.valueAt(c));
+    }
+
+    Run run(sink, options);
+    run.pieces = cutPieces(root, static_cast<size_t>(options.threads) * options.piecesPerThread);
+
+    const unsigned threadCount = static_cast<unsigned>(std::min<size_t>(options.threads, run.pieces.size()));
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount);
+    for (unsigned t = 0; t < threadCount; t++) {
+        threads.emplace_back(&Run::work, &run);
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    if (run.error) std::rethrow_exception(run.error);
+
+    stats.solutions = run.written;
+    stats.nodes = run.nodes;
+    stats.pieces = run.pieces.size();
+    stats.elapsed = Clock::now() - start;
+    return stats;
+}
+
+void SolutionEnumerator::decodeBinary(const char* record, Board& board)
+{
+    for (int c = 0; c < 81; c++) {
+        uint8_t byte = static_cast<uint8_t>(record[c / 2]);
+        int digit = c % 2 == 0 ? byte & 0xF : byte >> 4;
+        board[c / 9][c % 9] = static_cast<char>('0' + digit);
+    }
+}
@@ -0,0 +1,437 @@
+#include "SolvePipeline.h"
+
+#include "BitboardSolution.h"
+#include "PuzzleFormat.h"
+#include "RingBuffer.h"
+#include "SudokuValidator.h"
+#include "Timeline.h"
+
+#include <algorithm>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+int64_t nanosSince(Clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+}
+
+/// Spin politely first, then sleep, so a stalled stage does not burn a core
+class Backoff {
+public:
+    void wait()
+    {
+        if (spins < 64) {
+            spins++;
+            std::this_thread::yield();
+        }
+        else {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+
+private:
+    unsigned spins = 0;
+};
+
+/// Flush the writer's buffer once it holds this many bytes
+const size_t WRITE_CHUNK = 64 * 1024;
+
+/// @brief What happened to a puzzle so far
+enum class PipelineOutcome : uint8_t {
+    Pending,
+    Solved,
+    Unsolvable,
+    OverBudget,
+    Invalid,
+    Rejected
+};
+
+/// @brief Element of the queues: one puzzle and its result
+struct PipelineItem {
+    uint64_t index = 0;
+    PipelineOutcome outcome = PipelineOutcome::Pending;
+    SolvePipeline::Board puzzle;
+    SolvePipeline::Board board;
+};
+
+}
+
+struct SolvePipeline::Run {
+    explicit Run(size_t capacity) : parsed(capacity), solved(capacity), validated(capacity) {}
+
+    RingBuffer<PipelineItem> parsed;
+    RingBuffer<PipelineItem> solved;
+    RingBuffer<PipelineItem> validated;
+
+    std::atomic<bool> readDone{ false };
+    std::atomic<bool> solveDone{ false };
+    std::atomic<bool> validateDone{ false };
+    std::atomic<unsigned> solversRunning{ 0 };
+
+    /// Results written so far, read by the reader to stay within the reorder window
+    std::atomic<uint64_t> written{ 0 };
+
+    /// Puzzles allowed between the last one written and the next one read, 0 for no limit
+    uint64_t window = 0;
+
+    std::istream* in = nullptr;
+    std::ostream* out = nullptr;
+
+    /// Push, waiting while the queue is full
+    static void push(RingBuffer<PipelineItem>& q, PipelineItem& item, QueueCounters& qc, StageCounters& sc)
+    {
+        if (!q.tryPush(item)) {
+            Clock::time_point start = Clock::now();
+            Backoff backoff;
+            do {
+                backoff.wait();
+            } while (!q.tryPush(item));
+            sc.blocked += nanosSince(start);
+        }
+
+        size_t depth = q.sizeApprox();
+        qc.depth.store(depth, std::memory_order_relaxed);
+        qc.pushes++;
+        qc.occupancySum += depth;
+    }
+
+    /// Pop, waiting while the queue is empty
+    /// @return false Once the queue is empty and its producers are done
+    static bool pop(RingBuffer<PipelineItem>& q, PipelineItem& item, const std::atomic<bool>& upstreamDone, QueueCounters& qc, StageCounters& sc)
+    {
+        if (!q.tryPop(item)) {
+            Clock::time_point start = Clock::now();
+            Backoff backoff;
+            for (;;) {
+                if (q.tryPop(item)) break;
+                // The flag is set after the last push, so one more try after seeing it is enough
+                if (upstreamDone.load(std::memory_order_acquire)) {
+                    if (q.tryPop(item)) break;
+                    sc.starved += nanosSince(start);
+                    return false;
+                }
+                backoff.wait();
+            }
+            sc.starved += nanosSince(start);
+        }
+
+        qc.depth.store(q.sizeApprox(), std::memory_order_relaxed);
+        return true;
+    }
+};
+
+void SolvePipeline::StageCounters::reset()
+{
+    items = 0;
+    busy = 0;
+    blocked = 0;
+    starved = 0;
+}
+
+StageStats SolvePipeline::StageCounters::snapshot() const
+{
+    StageStats s;
+    s.items = items.load(std::memory_order_relaxed);
+    s.busy = std::chrono::nanoseconds(busy.load(std::memory_order_relaxed));
+    s.blocked = std::chrono::nanoseconds(blocked.load(std::memory_order_relaxed));
+    s.starved = std::chrono::nanoseconds(starved.load(std::memory_order_relaxed));
+    return s;
+}
+
+void SolvePipeline::QueueCounters::reset(size_t queueCapacity)
+{
+    capacity = queueCapacity;
+    depth = 0;
+    pushes = 0;
+    occupancySum = 0;
+}
+
+QueueStats SolvePipeline::QueueCounters::snapshot() const
+{
+    QueueStats s;
+    s.capacity = capacity;
+    s.depth = depth.load(std::memory_order_relaxed);
+    uint64_t n = pushes.load(std::memory_order_relaxed);
+    s.meanOccupancy = n == 0 ? 0 : static_cast<double>(occupancySum.load(std::memory_order_relaxed)) / n;
+    return s;
+}
+
+SolvePipeline::SolvePipeline(const PipelineConfig& config) : config(config)
+{
+    size_t capacity = config.queueCapacity;
+    if (capacity < 2 || (capacity & (capacity - 1)) != 0) {
+        throw std::invalid_argument("The queue capacity must be a power of two");
+    }
+
+    solverThreads = config.solverThreads;
+    if (solverThreads == 0) {
+        // The reader, the validator and the writer each keep a thread busy
+        unsigned cores = std::thread::hardware_concurrency();
+        solverThreads = cores > 4 ? cores - 3 : 1;
+    }
+}
+
+PipelineStats SolvePipeline::run(std::istream& in, std::ostream& out)
+{
+    for (StageCounters* c : { &readerCounters, &solverCounters, &validatorCounters, &writerCounters }) {
+        c->reset();
+    }
+    for (QueueCounters* q : { &parsedQueue, &solvedQueue, &validatedQueue }) {
+        q->reset(config.queueCapacity);
+    }
+    for (std::atomic<uint64_t>* n : { &solvedPuzzles, &unsolvablePuzzles, &overBudgetPuzzles, &invalidLines, &rejectedSolutions }) {
+        *n = 0;
+    }
+
+    Clock::time_point start = Clock::now();
+    elapsed = 0;
+
+    Run r(config.queueCapacity);
+    r.in = &in;
+    r.out = &out;
+    // Roomy enough to cover every queue, so the window only bites behind a slow puzzle
+    r.window = config.preserveOrder ? 4 * config.queueCapacity : 0;
+    r.solversRunning = solverThreads;
+
+    std::thread reader(&SolvePipeline::readStage, this, std::ref(r));
+    std::vector<std::thread> solvers;
+    solvers.reserve(solverThreads);
+    for (unsigned i = 0; i < solverThreads; i++) {
+        solvers.emplace_back(&SolvePipeline::solveStage, this, std::ref(r));
+    }
+    std::thread validator(&SolvePipeline::validateStage, this, std::ref(r));
+
+    writeStage(r);
+
+    reader.join();
+    for (auto& t : solvers) {
+        t.join();
+    }
+    validator.join();
+
+    elapsed = nanosSince(start);
+    return stats();
+}
+
+void SolvePipeline::readStage(Run& r)
+{
+    std::string line;
+    uint64_t index = 0;
+    PipelineItem item;
+    SUDOKU_TIMELINE_THREAD("reader");
+
+    for (;;) {
+        Clock::time_point start = Clock::now();
+        if (!std::getline(*r.in, line)) break;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty() || line[0] == '#') continue;
+
+        {
+            SUDOKU_TIMELINE_SCOPE("parse");
+            item.index = index++;
+            if (PuzzleFormat::fromLine(line, item.puzzle)) {
+                item.outcome = PipelineOutcome::Pending;
+            }
+            else {
+                item.outcome = PipelineOutcome::Invalid;
+            }
+        }
+        readerCounters.busy += nanosSince(start);
+
+        if (r.window != 0 && item.index >= r.written.load(std::memory_order_acquire) + r.window) {
+            Clock::time_point blockedSince = Clock::now();
+            Backoff backoff;
+            while (item.index >= r.written.load(std::memory_order_acquire) + r.window) {
+                backoff.wait();
+            }
+            readerCounters.blocked += nanosSince(blockedSince);
+        }
+
+        Run::push(r.parsed, item, parsedQueue, readerCounters);
+        readerCounters.items++;
+    }
+
+    r.readDone.store(true, std::memory_order_release);
+}
+
+void SolvePipeline::solveStage(Run& r)
+{
+    BitboardSolution solver;
+    SolveOptions opts;
+    opts.maxNodes = config.maxNodesPerPuzzle;
+    PipelineItem item;
+    SUDOKU_TIMELINE_THREAD("solver");
+
+    while (Run::pop(r.parsed, item, r.readDone, parsedQueue, solverCounters)) {
+        Clock::time_point start = Clock::now();
+        if (item.outcome == PipelineOutcome::Pending) {
+            SUDOKU_TIMELINE_SCOPE("solve");
+            item.board = item.puzzle;
+            switch (solver.solveSudoku(item.board, opts)) {
+            case SolveStatus::Solved:
+                item.outcome = PipelineOutcome::Solved;
+                break;
+            case SolveStatus::Unsolvable:
+                item.outcome = PipelineOutcome::Unsolvable;
+                break;
+            default:
+                item.outcome = PipelineOutcome::OverBudget;
+                break;
+            }
+        }
+        solverCounters.busy += nanosSince(start);
+
+        Run::push(r.solved, item, solvedQueue, solverCounters);
+        solverCounters.items++;
+    }
+
+    // The last solver out closes the queue
+    if (r.solversRunning.fetch_sub(1) == 1) {
+        r.solveDone.store(true, std::memory_order_release);
+    }
+}
+
+void SolvePipeline::validateStage(Run& r)
+{
+    PipelineItem item;
+    SUDOKU_TIMELINE_THREAD("validator");
+
+    while (Run::pop(r.solved, item, r.solveDone, solvedQueue, validatorCounters)) {
+        Clock::time_point start = Clock::now();
+        switch (item.outcome) {
+        case PipelineOutcome::Solved: {
+            SUDOKU_TIMELINE_SCOPE("validate");
+            bool keepsGivens = true;
+            for (int i = 0; i < 9; i++) {
+                for (int j = 0; j < 9; j++) {
+                    if (item.puzzle[i][j] != '.' && item.puzzle[i][j] != item.board[i][j]) {
+                        keepsGivens = false;
+                    }
+                }
+            }
+            if (keepsGivens && SudokuValidator::isSudokuValid(item.board)) {
+                solvedPuzzles++;
+            }
+            else {
+                item.outcome = PipelineOutcome::Rejected;
+                rejectedSolutions++;
+            }
+            break;
+        }
+        case PipelineOutcome::Unsolvable:
+            unsolvablePuzzles++;
+            break;
+        case PipelineOutcome::OverBudget:
+            overBudgetPuzzles++;
+            break;
+        default:
+            invalidLines++;
+            break;
+        }
+        validatorCounters.busy += nanosSince(start);
+
+        Run::push(r.validated, item, validatedQueue, validatorCounters);
+        validatorCounters.items++;
+    }
+
+    r.validateDone.store(true, std::memory_order_release);
+}
+
+void SolvePipeline::writeStage(Run& r)
+{
+    std::string text;
+    text.reserve(WRITE_CHUNK + 128);
+
+    auto format = [&text](const PipelineItem& item) {
+        switch (item.outcome) {
+        case PipelineOutcome::Solved:
+            text += PuzzleFormat::toLine(item.board);
+            break;
+        case PipelineOutcome::Unsolvable:
+            text += PuzzleFormat::toLine(item.puzzle);
+            text += " unsolvable";
+            break;
+        case PipelineOutcome::OverBudget:
+            text += PuzzleFormat::toLine(item.puzzle);
+            text += " budget";
+            break;
+        case PipelineOutcome::Rejected:
+            text += PuzzleFormat::toLine(item.puzzle);
+            text += " rejected";
+            break;
+        default:
+            text += "invalid";
+            break;
+        }
+        text += '\n';
+    };
+
+    // Results that arrived before an earlier one, indexed by their position in the window
+    std::vector<PipelineItem> pending(static_cast<size_t>(r.window));
+    std::vector<bool> present(static_cast<size_t>(r.window), false);
+    uint64_t next = 0;
+    PipelineItem item;
+    SUDOKU_TIMELINE_THREAD("writer");
+
+    while (Run::pop(r.validated, item, r.validateDone, validatedQueue, writerCounters)) {
+        Clock::time_point start = Clock::now();
+        if (r.window == 0) {
+            format(item);
+            writerCounters.items++;
+        }
+        else {
+            size_t slot = static_cast<size_t>(item.index % r.window);
+            pending[slot] = item;
+            present[slot] = true;
+
+            for (slot = static_cast<size_t>(next % r.window); present[slot]; slot = static_cast<size_t>(next % r.window)) {
+                format(pending[slot]);
+                present[slot] = false;
+                next++;
+                writerCounters.items++;
+            }
+            r.written.store(next, std::memory_order_release);
+        }
+
+        if (text.size() >= WRITE_CHUNK) {
+            SUDOKU_TIMELINE_SCOPE("output");
+            r.out->write(text.data(), text.size());
+            text.clear();
+        }
+        writerCounters.busy += nanosSince(start);
+    }
+
+    SUDOKU_TIMELINE_SCOPE("output");
+    r.out->write(text.data(), text.size());
+    r.out->flush();
+}
+
+PipelineStats SolvePipeline::stats() const
+{
+    PipelineStats s;
+    s.reader = readerCounters.snapshot();
+    s.solver = solverCounters.snapshot();
+    s.validator = validatorCounters.snapshot();
+    s.writer = writerCounters.snapshot();
+    s.parsed = parsedQueue.snapshot();
+    s.solved = solvedQueue.snapshot();
+    s.validated = validatedQueue.snapshot();
+    s.solverThreads = solverThreads;
+    s.solvedPuzzles = solvedPuzzles.load(std::memory_order_relaxed);
+    s.unsolvablePuzzles = unsolvablePuzzles.load(std::memory_order_relaxed);
+    s.overBudgetPuzzles = overBudgetPuzzles.load(std::memory_order_relaxed);
+    s.invalidLines = invalidLines.load(std::memory_order_relaxed);
+    s.rejectedSolutions = rejectedSolutions.load(std::memory_order_relaxed);
+    s.elapsed = std::chrono::nanoseconds(elapsed.load(std::memory_order_relaxed));
+    return s;
+}
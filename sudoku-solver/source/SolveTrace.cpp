@@ -0,0 +1,60 @@
+#include "SolveTrace.h"
+
+const size_t SolveTrace::CAPACITY;
+
+size_t SolveTrace::countOf(Technique technique) const
+{
+    size_t n = 0;
+    for (const auto& e : *this) {
+        if (e.technique == technique) n++;
+    }
+    return n;
+}
+
+Technique SolveTrace::hardestTechnique() const
+{
+    Technique hardest = Technique::Given;
+    for (const auto& e : *this) {
+        if (e.technique > hardest) hardest = e.technique;
+    }
+    return hardest;
+}
+
+std::string SolveTrace::toCompactString() const
+{
+    static const char letters[] = { 'C', 'N', 'G' };
+
+    std::string out;
+    out.reserve(size() * 4);
+    for (const auto& e : *this) {
+        out.push_back(static_cast<char>('1' + e.row));
+        out.push_back(static_cast<char>('1' + e.col));
+        out.push_back(static_cast<char>('0' + e.digit));
+        out.push_back(letters[static_cast<int>(e.technique)]);
+    }
+    return out;
+}
+
+std::string SolveTrace::describe(const TraceEvent& e)
+{
+    std::string out = "r";
+    out += static_cast<char>('1' + e.row);
+    out += 'c';
+    out += static_cast<char>('1' + e.col);
+    out += " = ";
+    out += static_cast<char>('0' + e.digit);
+    out += " (";
+    out += techniqueName(e.technique);
+    out += ")";
+    return out;
+}
+
+const char* SolveTrace::techniqueName(Technique technique)
+{
+    switch (technique) {
+    case Technique::Given: return "given";
+    case Technique::NakedSingle: return "naked single";
+    case Technique::Guess: return "guess";
+    }
+    return "unknown";
+}
@@ -0,0 +1,41 @@
+#include "SolverRegistry.h"
+
+#include "BitboardSolution.h"
+#include "sudoku-solver.h"
+
+namespace {
+
+template <class Engine>
+void solveAllWith(SolverEngine::Board* boards, size_t count, const SolveOptions& opts, SolveStatus* statuses)
+{
+    Engine engine;
+    for (size_t i = 0; i < count; i++) {
+        SolveStatus status = engine.solveSudoku(boards[i], opts);
+        if (statuses != nullptr) {
+            statuses[i] = status;
+        }
+    }
+}
+
+}
+
+const std::vector<SolverEngine>& SolverRegistry::engines()
+{
+    static const std::vector<SolverEngine> all = {
+        { "cells", "Solution: conflict learning, every SolveOptions setting, traces and limits", &solveAllWith<Solution> },
+        { "bitboard", "BitboardSolution: hidden singles and box/line reductions on digit planes", &solveAllWith<BitboardSolution> },
+        { "cells-fast", "Naked singles and MRV only, no counters, trace or limits", &solveAllWith<BasicSolution<FastPolicies>> },
+        { "cells-static", "cells-fast with the cell order fixed after the givens", &solveAllWith<BasicSolution<StaticOrderPolicies>> },
+        { "cells-forward", "Forward checking only, the weakest propagation", &solveAllWith<BasicSolution<ForwardCheckingPolicies>> },
+        { "cells-log", "cells printing every step of the search", &solveAllWith<BasicSolution<LoggingPolicies>> },
+    };
+    return all;
+}
+
+const SolverEngine* SolverRegistry::find(const std::string& name)
+{
+    for (const SolverEngine& engine : engines()) {
+        if (name == engine.name) return &engine;
+    }
+    return nullptr;
+}
@@ -0,0 +1,54 @@
+#include "SudokuGeometry.h"
+
+const size_t SudokuGeometry::CELLS;
+const size_t SudokuGeometry::UNITS;
+const size_t SudokuGeometry::PEERS;
+
+namespace {
+
+std::array<std::array<uint8_t, 9>, SudokuGeometry::UNITS> buildUnits()
+{
+    std::array<std::array<uint8_t, 9>, SudokuGeometry::UNITS> units;
+    for (int u = 0; u < 9; u++) {
+        for (int k = 0; k < 9; k++) {
+            units[u][k] = static_cast<uint8_t>(u * 9 + k);                                  // row u
+            units[9 + u][k] = static_cast<uint8_t>(k * 9 + u);                              // column u
+            units[18 + u][k] = static_cast<uint8_t>(((u / 3) * 3 + k / 3) * 9 + (u % 3) * 3 + k % 3); // square u
+        }
+    }
+    return units;
+}
+
+std::array<std::array<uint8_t, SudokuGeometry::PEERS>, SudokuGeometry::CELLS> buildPeers()
+{
+    std::array<std::array<uint8_t, SudokuGeometry::PEERS>, SudokuGeometry::CELLS> peers;
+    for (int c = 0; c < 81; c++) {
+        int r = c / 9;
+        int col = c % 9;
+        size_t n = 0;
+        for (int p = 0; p < 81; p++) {
+            if (p == c) continue;
+            bool sameRow = p / 9 == r;
+            bool sameCol = p % 9 == col;
+            bool sameSquare = (p / 27) == (c / 27) && (p % 9) / 3 == col / 3;
+            if (sameRow || sameCol || sameSquare) {
+                peers[c][n++] = static_cast<uint8_t>(p);
+            }
+        }
+    }
+    return peers;
+}
+
+}
+
+const std::array<std::array<uint8_t, 9>, SudokuGeometry::UNITS>& SudokuGeometry::units()
+{
+    static const auto table = buildUnits();
+    return table;
+}
+
+const std::array<std::array<uint8_t, SudokuGeometry::PEERS>, SudokuGeometry::CELLS>& SudokuGeometry::peers()
+{
+    static const auto table = buildPeers();
+    return table;
+}
@@ -0,0 +1,127 @@
+#include "SudokuSession.h"
+
+#include <stdexcept>
+
+SudokuSession::SudokuSession()
+{
+    for (auto& row : board) {
+        row.fill('.');
+    }
+    state = BitboardState::empty();
+}
+
+SudokuSession::SudokuSession(const Board& givens) : board(givens)
+{
+    // load reads any other character as empty, assign expects '.'
+    for (auto& row : board) {
+        for (char& c : row) {
+            if (c < '1' || c > '9') {
+                c = '.';
+            }
+        }
+    }
+    consistent = BitboardSolution::load(board, state);
+}
+
+void SudokuSession::throwIfOutOfRange(int row, int col)
+{
+    if (row < 0 || row > 8 || col < 0 || col > 8) {
+        throw std::out_of_range("Invalid coordinate for a sudoku cell");
+    }
+}
+
+void SudokuSession::apply(int cell, int digit)
+{
+    if (consistent) {
+        consistent = state.assign(cell, digit) && state.propagate();
+    }
+    board[cell / 9][cell % 9] = static_cast<char>('0' + digit);
+    solvableKnown = false;
+}
+
+bool SudokuSession::assign(int row, int col, int digit)
+{
+    throwIfOutOfRange(row, col);
+    if (digit < 1 || digit > 9) throw std::out_of_range("Invalid value for a sudoku cell");
+    if (board[row][col] != '.') throw std::logic_error("The cell already holds a digit");
+
+    int cell = row * 9 + col;
+    history.push_back(Edit{ cell, digit, state, consistent });
+    apply(cell, digit);
+    return consistent;
+}
+
+bool SudokuSession::undo()
+{
+    if (history.empty()) return false;
+
+    const Edit& last = history.back();
+    state = last.before;
+    consistent = last.consistentBefore;
+    board[last.cell / 9][last.cell % 9] = '.';
+    history.pop_back();
+    solvableKnown = false;
+    return true;
+}
+
+bool SudokuSession::erase(int row, int col)
+{
+    throwIfOutOfRange(row, col);
+    int cell = row * 9 + col;
+
+    size_t k = 0;
+    while (k < history.size() && history[k].cell != cell) {
+        k++;
+    }
+    if (k == history.size()) return false;
+
+    std::vector<Edit> later(history.begin() + k + 1, history.end());
+    while (history.size() > k) {
+        undo();
+    }
+    for (const Edit& e : later) {
+        history.push_back(Edit{ e.cell, e.digit, state, consistent });
+        apply(e.cell, e.digit);
+    }
+    return true;
+}
+
+bool SudokuSession::isConsistent() const
+{
+    return consistent;
+}
+
+bool SudokuSession::isSolvable()
+{
+    if (!consistent) return false;
+    if (!solvableKnown) {
+        BitboardState copy = state;
+        solvable = solver.solveState(copy, unlimited) == SolveStatus::Solved;
+        solvableKnown = true;
+    }
+    return solvable;
+}
+
+uint16_t SudokuSession::candidates(int row, int col) const
+{
+    throwIfOutOfRange(row, col);
+    if (!consistent) return 0;
+    return state.candidatesAt(row * 9 + col);
+}
+
+int SudokuSession::value(int row, int col) const
+{
+    throwIfOutOfRange(row, col);
+    if (!consistent) return 0;
+    return state.valueAt(row * 9 + col);
+}
+
+const SudokuSession::Board& SudokuSession::entries() const
+{
+    return board;
+}
+
+size_t SudokuSession::historySize() const
+{
+    return history.size();
+}
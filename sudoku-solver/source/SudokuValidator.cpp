@@ -1,53 +1,37 @@
 #include "SudokuValidator.h"
 
-#include <set>
-
 bool SudokuValidator::isSudokuValid(std::array<std::array<char, 9>, 9>& board)
 {
-    const std::set<char> correctSet = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
-
-    // Check each row
-    std::set<char> currentRow;
-    for(int i = 0; i < 9; i++) {
-        currentRow.clear();
-
-        for(int j = 0; j < 9; j++) {
-            auto& v = board[i][j];
-            currentRow.insert(v);
-        }
-
-        if(correctSet != currentRow) return false;
-    }
-
-    std::set<char> currentCol;
-    for(int i = 0; i < 9; i++) {
-        currentCol.clear();
+    return isValid(board, ConstraintGraph::classic());
+}
 
-        for(int j = 0; j < 9; j++) {
-            auto& v = board[j][i];
-            currentCol.insert(v);
+bool SudokuValidator::isValid(const std::array<std::array<char, 9>, 9>& board, const ConstraintGraph& graph)
+{
+    auto at = [&board](uint8_t c) { return board[c / 9][c % 9]; };
+
+    for (const auto& unit : graph.getUnits()) {
+        uint16_t seen = 0;
+        for (uint8_t c : unit) {
+            char v = at(c);
+            if (v < '1' || v > '9') return false;
+            seen |= static_cast<uint16_t>(1 << (v - '0'));
         }
-
-        if(correctSet != currentCol) return false;
+        if (seen != 0x3FE) return false;
     }
 
-    std::set<char> currentBlock;
-    for(int i = 0; i < 3; i++) {
-        int rowOffset = i*3;
-        for(int j = 0; j < 3; j++) {
-            int colOffset = j*3;
-            currentBlock.clear();
-            
-            for(int x = rowOffset; x < rowOffset+3; x++) {
-                for(int y = colOffset; y < 3+colOffset; y++) {
-                    auto& v = board[x][y];
-                    currentBlock.insert(v);
-                }
-            }
-
-            if(correctSet != currentBlock) return false;
+    for (size_t k = 0; k < graph.cageCount(); k++) {
+        int sum = 0;
+        uint16_t seen = 0;
+        for (uint8_t c : graph.cageCells(k)) {
+            char v = at(c);
+            if (v < '1' || v > '9') return false;
+            uint16_t bit = static_cast<uint16_t>(1 << (v - '0'));
+            if (seen & bit) return false;
+            seen |= bit;
+            sum += v - '0';
         }
+        if (sum != graph.cage(k).sum) return false;
     }
 
     return true;
-}
\ No newline at end of file
+}
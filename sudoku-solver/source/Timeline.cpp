@@ -0,0 +1,232 @@
+#include "Timeline.h"
+
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+std::atomic<bool> Timeline::enabled{ false };
+
+namespace {
+
+using SteadyClock = std::chrono::steady_clock;
+
+struct Event {
+    const char* name;
+    uint64_t start;
+    uint64_t end;
+};
+
+/// Events of one thread. Only the owning thread writes, the exporter reads up to `size`
+struct ThreadBuffer {
+    uint32_t tid = 0;
+    std::string name;
+    std::unique_ptr<Event[]> events;
+    size_t capacity = 0;
+    std::atomic<size_t> size{ 0 };
+    std::atomic<uint64_t> dropped{ 0 };
+
+    /// Held by a running thread. Guarded by the registry mutex
+    bool inUse = false;
+};
+
+/// Every buffer ever created, and the clock pair taken at enable to convert ticks
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    size_t capacity = size_t(1) << 16;
+    uint64_t baseTicks = 0;
+    SteadyClock::time_point baseTime;
+
+    static Registry& get()
+    {
+        static Registry registry;
+        return registry;
+    }
+};
+
+/// The name of a thread and, once it has recorded, its buffer, handed back to the registry when the thread exits
+struct ThreadSlot {
+    ThreadBuffer* buffer = nullptr;
+    std::string name;
+
+    ~ThreadSlot()
+    {
+        if (buffer != nullptr) {
+            Registry& r = Registry::get();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            buffer->inUse = false;
+        }
+    }
+};
+
+thread_local ThreadSlot threadSlot;
+
+ThreadBuffer& bufferOfThisThread()
+{
+    ThreadSlot& slot = threadSlot;
+    if (slot.buffer == nullptr) {
+        Registry& r = Registry::get();
+        std::lock_guard<std::mutex> lock(r.mutex);
+
+        // The buffer of an exited thread of the same name, keeping its events, or an empty one
+        ThreadBuffer* reused = nullptr;
+        for (auto& b : r.buffers) {
+            if (b->inUse) continue;
+            if (b->name == slot.name) {
+                reused = b.get();
+                break;
+            }
+            if (reused == nullptr && b->size.load(std::memory_order_relaxed) == 0) {
+                reused = b.get();
+            }
+        }
+        if (reused == nullptr) {
+            std::unique_ptr<ThreadBuffer> b(new ThreadBuffer);
+            b->tid = static_cast<uint32_t>(r.buffers.size() + 1);
+            b->capacity = r.capacity;
+            b->events.reset(new Event[r.capacity]);
+            reused = b.get();
+            r.buffers.push_back(std::move(b));
+        }
+        reused->inUse = true;
+        reused->name = slot.name;
+        slot.buffer = reused;
+    }
+    return *slot.buffer;
+}
+
+void writeEscaped(std::ostream& out, const std::string& s)
+{
+    out << '"';
+    for (char c : s) {
+        if (c == '"' || c == '\\') out << '\\';
+        out << c;
+    }
+    out << '"';
+}
+
+}
+
+void Timeline::enable(size_t eventsPerThread)
+{
+    Registry& r = Registry::get();
+    {
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.capacity = eventsPerThread;
+        for (auto& b : r.buffers) {
+            if (b->capacity != eventsPerThread) {
+                b->events.reset(new Event[eventsPerThread]);
+                b->capacity = eventsPerThread;
+            }
+            b->size = 0;
+            b->dropped = 0;
+        }
+        r.baseTime = SteadyClock::now();
+        r.baseTicks = now();
+    }
+    enabled.store(true, std::memory_order_release);
+}
+
+void Timeline::disable()
+{
+    enabled.store(false, std::memory_order_release);
+}
+
+void Timeline::setThreadName(const char* name)
+{
+    // Only the name is kept until the thread records, so threads that never do cost no buffer
+    ThreadSlot& slot = threadSlot;
+    slot.name = name;
+    if (slot.buffer != nullptr) {
+        Registry& r = Registry::get();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        slot.buffer->name = name;
+    }
+}
+
+void Timeline::record(const char* name, uint64_t start, uint64_t end)
+{
+    ThreadBuffer& b = bufferOfThisThread();
+    size_t n = b.size.load(std::memory_order_relaxed);
+    if (n == b.capacity) {
+        b.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    b.events[n] = Event{ name, start, end };
+    b.size.store(n + 1, std::memory_order_release);
+}
+
+uint64_t Timeline::recordedEvents()
+{
+    Registry& r = Registry::get();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    uint64_t total = 0;
+    for (const auto& b : r.buffers) {
+        total += b->size.load(std::memory_order_acquire);
+    }
+    return total;
+}
+
+size_t Timeline::threadBuffers()
+{
+    Registry& r = Registry::get();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    return r.buffers.size();
+}
+
+uint64_t Timeline::droppedEvents()
+{
+    Registry& r = Registry::get();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    uint64_t total = 0;
+    for (const auto& b : r.buffers) {
+        total += b->dropped.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void Timeline::writeChromeTrace(std::ostream& out)
+{
+    Registry& r = Registry::get();
+    std::lock_guard<std::mutex> lock(r.mutex);
+
+    // Ticks per microsecond, measured over the whole recording
+    double ticksPerMicro = 1000.0;
+#if defined(SUDOKU_TIMELINE_TSC)
+    double micros = std::chrono::duration<double, std::micro>(SteadyClock::now() - r.baseTime).count();
+    uint64_t ticks = now() - r.baseTicks;
+    if (micros > 0 && ticks > 0) {
+        ticksPerMicro = static_cast<double>(ticks) / micros;
+    }
+#endif
+
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    std::ios::fmtflags flags = out.flags();
+    out << std::fixed << std::setprecision(3);
+
+    for (const auto& b : r.buffers) {
+        out << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << b->tid << ",\"args\":{\"name\":";
+        writeEscaped(out, b->name.empty() ? "thread " + std::to_string(b->tid) : b->name);
+        out << "}}";
+        first = false;
+
+        size_t n = b->size.load(std::memory_order_acquire);
+        for (size_t i = 0; i < n; i++) {
+            const Event& e = b->events[i];
+            // Events from before the last enable were dropped with the buffer, so start >= baseTicks
+            double ts = static_cast<double>(e.start - r.baseTicks) / ticksPerMicro;
+            double dur = static_cast<double>(e.end - e.start) / ticksPerMicro;
+            out << ",\n{\"name\":";
+            writeEscaped(out, e.name);
+            out << ",\"cat\":\"sudoku\",\"ph\":\"X\",\"pid\":1,\"tid\":" << b->tid << ",\"ts\":" << ts << ",\"dur\":" << dur << "}";
+        }
+    }
+
+    out << "\n]}\n";
+    out.flags(flags);
+}
@@ -0,0 +1,217 @@
+#include "sudoku-solver-c.h"
+
+#include "BitboardSolution.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/// Puzzles a thread claims at a time, enough to keep the shared cursor off the hot path
+const size_t CHUNK = 16;
+
+/// Search stack and options of one thread, kept between batches
+struct Context {
+    BitboardSolution solver;
+    SolveOptions options;
+};
+
+}
+
+struct sudoku_solver {
+    /// Index 0 belongs to the calling thread, the others to `threads`
+    std::vector<std::unique_ptr<Context>> contexts;
+    std::vector<std::thread> threads;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    uint64_t generation = 0;
+    unsigned running = 0;
+    bool stopping = false;
+
+    // The batch in progress
+    const char* puzzles = nullptr;
+    char* solutions = nullptr;
+    int32_t* statuses = nullptr;
+    size_t count = 0;
+    std::atomic<size_t> cursor{ 0 };
+    std::atomic<int64_t> solved{ 0 };
+    std::atomic<bool> failed{ false };
+
+    void workerLoop(Context& context);
+    void solveClaimed(Context& context);
+};
+
+namespace {
+
+/**
+ * Solve one puzzle straight from its bytes, without building a Board
+ * @return The sudoku_status of the puzzle
+ */
+int32_t solveOne(Context& context, const char* in, char* out)
+{
+    BitboardState state = BitboardState::empty();
+    bool consistent = true;
+    for (int c = 0; c < SUDOKU_CELLS; c++) {
+        char b = in[c];
+        if (b >= '1' && b <= '9') {
+            consistent = consistent && state.assign(c, b - '0');
+        }
+        else if (b != '.' && b != '0') {
+            std::memmove(out, in, SUDOKU_CELLS);
+            return SUDOKU_INVALID;
+        }
+    }
+
+    SolveStatus status = SolveStatus::Unsolvable;
+    if (consistent && state.propagate()) {
+        status = context.solver.solveState(state, context.options);
+    }
+
+    if (status != SolveStatus::Solved) {
+        std::memmove(out, in, SUDOKU_CELLS);
+        return status == SolveStatus::Unsolvable ? SUDOKU_UNSOLVABLE : SUDOKU_BUDGET_EXCEEDED;
+    }
+    for (int c = 0; c < SUDOKU_CELLS; c++) {
+        out[c] = static_cast<char>('0' + state.valueAt(c));
+    }
+    return SUDOKU_SOLVED;
+}
+
+}
+
+void sudoku_solver::solveClaimed(Context& context)
+{
+    try {
+        int64_t n = 0;
+        for (size_t first = cursor.fetch_add(CHUNK); first < count; first = cursor.fetch_add(CHUNK)) {
+            size_t last = first + CHUNK < count ? first + CHUNK : count;
+            for (size_t i = first; i < last; i++) {
+                statuses[i] = solveOne(context, puzzles + SUDOKU_CELLS * i, solutions + SUDOKU_CELLS * i);
+                n += statuses[i] == SUDOKU_SOLVED;
+            }
+        }
+        solved += n;
+    }
+    catch (...) {
+        // Only the first growth of a search stack allocates
+        failed = true;
+        cursor = count;
+    }
+}
+
+void sudoku_solver::workerLoop(Context& context)
+{
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this, seen]() { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+
+        solveClaimed(context);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--running == 0) {
+            finished.notify_one();
+        }
+    }
+}
+
+int sudoku_api_version(void)
+{
+    return SUDOKU_C_API_VERSION;
+}
+
+sudoku_solver* sudoku_solver_create(unsigned threads)
+{
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+    }
+    if (threads == 0) {
+        threads = 1;
+    }
+
+    sudoku_solver* solver = new (std::nothrow) sudoku_solver;
+    if (solver == nullptr) return nullptr;
+    try {
+        for (unsigned i = 0; i < threads; i++) {
+            solver->contexts.emplace_back(new Context);
+        }
+        for (unsigned i = 1; i < threads; i++) {
+            Context& context = *solver->contexts[i];
+            solver->threads.emplace_back([solver, &context]() { solver->workerLoop(context); });
+        }
+    }
+    catch (...) {
+        sudoku_solver_destroy(solver);
+        return nullptr;
+    }
+    return solver;
+}
+
+void sudoku_solver_destroy(sudoku_solver* solver)
+{
+    if (solver == nullptr) return;
+    {
+        std::lock_guard<std::mutex> lock(solver->mutex);
+        solver->stopping = true;
+    }
+    solver->wake.notify_all();
+    for (auto& t : solver->threads) {
+        t.join();
+    }
+    delete solver;
+}
+
+void sudoku_solver_set_max_nodes(sudoku_solver* solver, uint64_t max_nodes)
+{
+    if (solver == nullptr) return;
+    for (auto& context : solver->contexts) {
+        context->options.maxNodes = max_nodes != 0 ? max_nodes : std::numeric_limits<uint64_t>::max();
+    }
+}
+
+int64_t sudoku_solve_batch(sudoku_solver* solver, const char* puzzles, char* solutions, int32_t* statuses, size_t count)
+{
+    if (solver == nullptr || ((puzzles == nullptr || solutions == nullptr || statuses == nullptr) && count != 0)) {
+        return SUDOKU_ERROR_ARGUMENT;
+    }
+
+    solver->puzzles = puzzles;
+    solver->solutions = solutions;
+    solver->statuses = statuses;
+    solver->count = count;
+    solver->cursor = 0;
+    solver->solved = 0;
+    solver->failed = false;
+
+    // A batch that fits in one chunk is not worth waking the workers
+    unsigned helpers = count > CHUNK ? static_cast<unsigned>(solver->threads.size()) : 0;
+    if (helpers != 0) {
+        {
+            std::lock_guard<std::mutex> lock(solver->mutex);
+            solver->running = helpers;
+            solver->generation++;
+        }
+        solver->wake.notify_all();
+    }
+
+    solver->solveClaimed(*solver->contexts[0]);
+
+    if (helpers != 0) {
+        std::unique_lock<std::mutex> lock(solver->mutex);
+        solver->finished.wait(lock, [solver]() { return solver->running == 0; });
+    }
+    return solver->failed ? static_cast<int64_t>(SUDOKU_ERROR_RESOURCES) : solver->solved.load();
+}
@@ -1,10 +1,15 @@
 ﻿#include "sudoku-solver.h"
 
+#include "Timeline.h"
+
 #include <iostream>
 #include <cassert>
 #include <algorithm>
+#include <limits>
+#include <stdexcept>
 
-inline void Solution::printVectorState(std::array<std::array<Cell,Solution::SUDOKU_SIZE>, Solution::SUDOKU_SIZE>& vect) {
+template <class Policies>
+inline void BasicSolution<Policies>::printVectorState(std::array<std::array<Cell,SUDOKU_SIZE>, SUDOKU_SIZE>& vect) {
 	if (!loggingEnabled) return;
 	std::cout << "[" << std::endl;
 	for (int i = 0; i < SUDOKU_SIZE; i++) {
@@ -17,13 +22,29 @@ inline void Solution::printVectorState(std::array<std::array<Cell,Solution::SUDO
 	std::cout << "]" << std::endl;
 }
 
-inline void Solution::initialize() {
+template <class Policies>
+inline void BasicSolution<Policies>::initialize() {
+	paused = false;
+	for (auto& row : cells) {
+		row.fill(Cell());
+	}
+	stats = SolveStats();
+	aborted = false;
+	nogoodCount = 0;
+	nextNogood = 0;
+	failuresSinceRestart = 0;
+	if (tracing()) {
+		trace->clear();
+	}
+	abortStatus = SolveStatus::Unsolvable;
+
 	if (loggingEnabled) {
 		std::cout << "Initialzied all cells" << std::endl;
 	}
 }
 
-inline bool Solution::setValue(int i, int j, int value) {
+template <class Policies>
+inline bool BasicSolution<Policies>::setValue(int i, int j, int value, Technique technique, const LevelSet& reason) {
 	if (loggingEnabled) {
 		std::cout << "Setting value at: [" << i << "," << j << "]: " << intToChar(value) << std::endl;
 	}
@@ -42,6 +63,9 @@ inline bool Solution::setValue(int i, int j, int value) {
 		if (loggingEnabled) {
 			std::cout << "Cannot set, this violates the constraints from earlier..." << std::endl;
 		}
+		if (learns()) {
+			conflictLevels = reason | (c.valueIsSet() ? valueReason[i * SUDOKU_SIZE + j] : exclusionReason[i * SUDOKU_SIZE + j][value]);
+		}
 		return false;
 	}
 
@@ -50,46 +74,37 @@ inline bool Solution::setValue(int i, int j, int value) {
 	}
 
 	c.setCellValue(value);
+	if (learns()) {
+		valueReason[i * SUDOKU_SIZE + j] = reason;
+	}
+	if (tracing()) {
+		trace->record(i, j, value, technique);
+	}
 
-	for (int k = 0; k < SUDOKU_SIZE; k++) {
-		// Apply constraints to the row
-		if (i != k) {
-			if (!updateConstraints(k, j, value)) {
-				if (loggingEnabled) {
-					std::cout << "Unable to apply the constraints on the row" << std::endl;
-				}
-				return false; // Unable to update the constraints on the row
-			}
-		}
+	if (!propagateValue(i, j, value, reason)) return false;
 
-		// Apply constraints to the column
-		if (j != k) {
-			if (!updateConstraints(i, k, value)) {
-				if (loggingEnabled) {
-					std::cout << "Unable to apply the constraints on the column" << std::endl;
-				}
-				return false; // Unable to update the constraints on the column
-			}
-		}
+	for (uint16_t k : graph->cagesOf(i * SUDOKU_SIZE + j)) {
+		if (!applyCage(k)) return false;
+	}
+	return true;
+}
 
-		// To the 3x3 square
-		// Index of corners of the square.
-		int ix = (i / 3) * 3 + k / 3;
-		int jx = (j / 3) * 3 + k % 3;
-		if (ix != i && jx != j) {
-			if (!updateConstraints(ix, jx, value)) {
-				if (loggingEnabled) {
-					std::cout << "Unable to apply the constraints on the square" << std::endl;
-				}
-				return false; // Unable to update the constraints on the 3x3 square.
+template <class Policies>
+inline bool BasicSolution<Policies>::propagateValue(int i, int j, int value, const LevelSet& reason) {
+	for (uint8_t peer : graph->peers(i * SUDOKU_SIZE + j)) {
+		if (!updateConstraints(peer / SUDOKU_SIZE, peer % SUDOKU_SIZE, value, reason)) {
+			if (loggingEnabled) {
+				std::cout << "Unable to apply the constraints on the peers" << std::endl;
 			}
+			return false; // Unable to update the constraints on a row, column, square or cage
 		}
 	}
 
 	return true;
 }
 
-inline bool Solution::updateConstraints(int i, int j, int excludedValue) {
+template <class Policies>
+inline bool BasicSolution<Policies>::updateConstraints(int i, int j, int excludedValue, const LevelSet& reason) {
 	if (loggingEnabled) {
 		std::cout << "Attempting to exclude the value " << intToChar(excludedValue) << " at [" << i << "," << j << "]" << std::endl;
 	}
@@ -105,105 +120,631 @@ inline bool Solution::updateConstraints(int i, int j, int excludedValue) {
 		if (loggingEnabled) {
 			std::cout << "Can't constrain field. Value already set" << std::endl;
 		}
+		if (learns()) {
+			conflictLevels = reason | valueReason[i * SUDOKU_SIZE + j];
+		}
 		return false; // We were wrong in our attempt
 	}
 
 	// If the value could be valid, AND the constraints don't have this excluded, let's remove it from the constraints
 	c.excludeValue(excludedValue);
+	if (learns()) {
+		exclusionReason[i * SUDOKU_SIZE + j][excludedValue] = reason;
+	}
 
 	if (c.getNumberOfRemainingPossibilities() > 1) return true; // If we haven't reached the last number of possibilities
 
-	
-	return setValue(i,j,c.getRemainingPossibility());
+	if (!Propagation::nakedSingles) {
+		// Without naked singles a cell with one candidate left waits to be guessed, and only an empty one fails
+		if (c.getNumberOfRemainingPossibilities() == 1) return true;
+		if (learns()) {
+			conflictLevels = exclusionsOf(i, j);
+		}
+		return false;
+	}
+
+	// The last value is forced by everything that excluded the others
+	return setValue(i,j,c.getRemainingPossibility(), Technique::NakedSingle, learns() ? exclusionsOf(i, j) : reason);
 
 	// This should never happen
 	// throw std::logic_error("Somehow the Cell has 1 possibility remaining, but none available in the set function");
 	return false;
 }
 
-inline void Solution::sortBt(const std::vector<std::pair<int, int>>::iterator& it) {
+template <class Policies>
+inline bool BasicSolution<Policies>::applyCage(size_t k) {
+	const ConstraintGraph::CompiledCage& cage = graph->cage(k);
+	int sum = cage.sum;
+	int empty = 0;
+	uint16_t used = 0;
+	uint16_t available = 0;
+	LevelSet why;
+	for (uint8_t c : graph->cageCells(k)) {
+		const Cell& cell = cells[c / SUDOKU_SIZE][c % SUDOKU_SIZE];
+		if (cell.valueIsSet()) {
+			sum -= cell.getValue();
+			used |= static_cast<uint16_t>(1 << cell.getValue());
+			if (learns()) {
+				why |= valueReason[c];
+			}
+		}
+		else {
+			empty++;
+			available |= cell.getRemainingPossibilitiesMask();
+			if (learns()) {
+				why |= exclusionsOf(c / SUDOKU_SIZE, c % SUDOKU_SIZE);
+			}
+		}
+	}
+
+	const uint16_t digits = empty == 0 ? 0 : ConstraintGraph::cageDigits(empty, sum, used, available);
+	if (empty == 0 ? sum != 0 : digits == 0) {
+		if (learns()) {
+			conflictLevels = why;
+		}
+		return false;
+	}
+
+	// Propagation may fill cells of the cage while the loop runs, updateConstraints copes with that
+	for (uint8_t c : graph->cageCells(k)) {
+		const Cell& cell = cells[c / SUDOKU_SIZE][c % SUDOKU_SIZE];
+		if (cell.valueIsSet()) continue;
+		for (uint16_t m = cell.getRemainingPossibilitiesMask() & ~digits; m != 0; m &= m - 1) {
+			if (!updateConstraints(c / SUDOKU_SIZE, c % SUDOKU_SIZE, Bitboard81::countTrailingZeros(m), why)) return false;
+		}
+	}
+	return true;
+}
+
+template <class Policies>
+inline void BasicSolution<Policies>::sortBt(const std::vector<std::pair<int, int>>::iterator& it) {
+	if (randomizeTies) {
+		std::sort(it, bt.end(), [this](const std::pair<int, int>& a, const std::pair<int, int>& b) {
+			const uint8_t na = cells[a.first][a.second].getNumberOfRemainingPossibilities();
+			const uint8_t nb = cells[b.first][b.second].getNumberOfRemainingPossibilities();
+			if (na != nb) return na < nb;
+			return cellKey[a.first * SUDOKU_SIZE + a.second] < cellKey[b.first * SUDOKU_SIZE + b.second];
+			});
+		return;
+	}
+
 	// Sort the list by the number of possibilites remaining in each cell
 	std::sort(it, bt.end(), [this](const std::pair<int, int>& a, const std::pair<int, int>& b) {
 		return cells[a.first][a.second].getNumberOfRemainingPossibilities() < cells[b.first][b.second].getNumberOfRemainingPossibilities();
 		});
 }
 
-inline bool Solution::findValuesForEmptyCells() {
-	bt.clear();
+template <class Policies>
+inline bool BasicSolution<Policies>::findValuesForEmptyCells() {
+	{
+		SUDOKU_TIMELINE_SCOPE("find empty cells");
+		bt.clear();
 
-	for (int i = 0; i < SUDOKU_SIZE; i++) {
-		for (int j = 0; j < SUDOKU_SIZE; j++) {
-			if (!cells[i][j].valueIsSet()) {
-				bt.emplace_back(i, j);
+		for (int i = 0; i < SUDOKU_SIZE; i++) {
+			for (int j = 0; j < SUDOKU_SIZE; j++) {
+				if (!cells[i][j].valueIsSet()) {
+					bt.emplace_back(i, j);
+				}
 			}
 		}
+
+		// Sort the list by the number of possibilites remaining in each cell
+		drawTieKeys();
+		sortBt(bt.begin());
 	}
 
-	// Sort the list by the number of possibilites remaining in each cell
-	sortBt(bt.begin());
-	return backtrack(bt.begin());
+	// The stack never gets deeper than one frame per empty cell
+	if (frames.size() < SUDOKU_SIZE * SUDOKU_SIZE) {
+		frames.resize(SUDOKU_SIZE * SUDOKU_SIZE);
+		snapshots.resize(SUDOKU_SIZE * SUDOKU_SIZE);
+	}
+	if (learns() && nogoods.size() < NOGOOD_CAPACITY) {
+		nogoods.resize(NOGOOD_CAPACITY);
+	}
+	depth = 0;
+	nextPosition = 0;
+	descending = true;
+	restartLimit = restartBase;
+	return backtrack();
 }
 
-inline bool Solution::backtrack(std::vector<std::pair<int, int>>::iterator k) {
-	if (k == bt.end()) return true;
+template <class Policies>
+inline void BasicSolution<Policies>::restoreLevel(size_t level) {
+	cells = snapshots[level];
+	if (tracing()) {
+		trace->truncate(frames[level].traceSize);
+	}
+}
 
-	auto i = (*k).first;
-	auto j = (*k).second;
+template <class Policies>
+inline typename BasicSolution<Policies>::LevelSet BasicSolution<Policies>::exclusionsOf(int i, int j) const {
+	LevelSet why;
+	uint16_t excluded = ~cells[i][j].getRemainingPossibilitiesMask() & 0x3FE;
+	for (; excluded != 0; excluded &= excluded - 1) {
+		why |= exclusionReason[i * SUDOKU_SIZE + j][Bitboard81::countTrailingZeros(excluded)];
+	}
+	return why;
+}
 
-	// Fast path
-	if (cells[i][j].valueIsSet()) {
-		if (loggingEnabled) {
-			std::cout << "BSorting: " << std::distance(k + 1, bt.end()) << " elements" << std::endl;
+template <class Policies>
+inline void BasicSolution<Policies>::learnNogood(const LevelSet& why) {
+	const int size = why.count();
+	if (size == 0 || size > static_cast<int>(MAX_NOGOOD_SIZE)) return;
+
+	Nogood& n = nogoods[nextNogood];
+	n.size = 0;
+	for (LevelSet rest = why; rest.any(); ) {
+		const int level = rest.first();
+		rest.reset(level);
+		// Positions of the frames still on the stack are never re-sorted
+		const auto& p = bt[frames[level].position];
+		n.cell[n.size] = static_cast<uint8_t>(p.first * SUDOKU_SIZE + p.second);
+		n.value[n.size] = frames[level].value;
+		n.size++;
+	}
+
+	nextNogood = (nextNogood + 1) % NOGOOD_CAPACITY;
+	if (nogoodCount < NOGOOD_CAPACITY) {
+		nogoodCount++;
+	}
+	if (Instrumentation::counters) {
+		stats.nogoodsLearned++;
+	}
+}
+
+template <class Policies>
+inline bool BasicSolution<Policies>::applyNogoods() {
+	// Candidates of every cell, a set cell keeping only its value
+	std::array<uint16_t, SUDOKU_SIZE * SUDOKU_SIZE> remaining;
+
+	bool changed = learns() && nogoodCount > 0;
+	while (changed) {
+		changed = false;
+		for (int c = 0; c < SUDOKU_SIZE * SUDOKU_SIZE; c++) {
+			remaining[c] = cells[c / SUDOKU_SIZE][c % SUDOKU_SIZE].getRemainingPossibilitiesMask();
+		}
+
+		for (size_t n = 0; n < nogoodCount && !changed; n++) {
+			const Nogood& g = nogoods[n];
+			int open = -1;
+			bool satisfied = false;
+
+			for (int k = 0; k < g.size; k++) {
+				const uint16_t bit = static_cast<uint16_t>(1 << g.value[k]);
+				const uint16_t r = remaining[g.cell[k]];
+				if ((r & bit) == 0 || (r != bit && open >= 0)) {
+					// Excluded, or two guesses open so nothing follows yet
+					satisfied = true;
+					break;
+				}
+				if (r != bit) {
+					open = k;
+				}
+			}
+			if (satisfied) continue;
+
+			LevelSet why;
+			for (int k = 0; k < g.size; k++) {
+				if (k != open) {
+					why |= valueReason[g.cell[k]];
+				}
+			}
+			if (open < 0) {
+				conflictLevels = why;
+				return false;
+			}
+			if (!updateConstraints(g.cell[open] / SUDOKU_SIZE, g.cell[open] % SUDOKU_SIZE, g.value[open], why)) return false;
+			// The exclusion may have set other cells, so look at the board again
+			changed = true;
 		}
-		//sortBt(k + 1);
-		return backtrack(k + 1);
 	}
+	return true;
+}
+
+template <class Policies>
+inline void BasicSolution<Policies>::blameAllLevels() {
+	LevelSet above;
+	for (size_t level = 0; level < depth; level++) {
+		frames[level].conflict |= above;
+		above.set(static_cast<int>(level));
+	}
+}
 
-	auto possibilities = cells[i][j].getRemainingPossiblities();
+template <class Policies>
+inline void BasicSolution<Policies>::configureSearch(const SolveOptions& opts) {
+	learning = opts.learnFromConflicts;
+	valueOrder = opts.valueOrder;
+	randomizeTies = opts.randomizeTies;
+	restartPolicy = opts.restarts;
+	restartBase = std::max<uint64_t>(opts.restartBase, 1);
+	restartGrowth = std::max(opts.restartGrowth, 1.0);
+	rng.seed(opts.seed);
+}
 
-	auto snapshot = cells; // Create a copy of the array as a backup
+template <class Policies>
+inline void BasicSolution<Policies>::drawTieKeys() {
+	for (size_t c = 0; c < cellKey.size(); c++) {
+		cellKey[c] = static_cast<uint8_t>(c);
+	}
+	for (size_t v = 0; v < digitKey.size(); v++) {
+		digitKey[v] = static_cast<uint8_t>(v);
+	}
+	if (randomizeTies) {
+		std::shuffle(cellKey.begin(), cellKey.end(), rng);
+		std::shuffle(digitKey.begin() + 1, digitKey.end(), rng);
+	}
+}
 
-	for(auto v : possibilities) {
-		if (setValue(i, j, v)) {
-			if (loggingEnabled) {
-				std::cout << "ASorting: " << std::distance(k + 1, bt.end()) << " elements" << std::endl;
+template <class Policies>
+inline int BasicSolution<Policies>::nextValue(const Frame& f) {
+	if (!ValueOrdering::configurable || (valueOrder == ValueOrder::Ascending && !randomizeTies)) {
+		return Bitboard81::countTrailingZeros(f.untried);
+	}
+
+	// Rank of every digit under valueOrder, lower is tried first
+	std::array<int, SUDOKU_SIZE + 1> rank = {};
+	const auto& p = bt[f.position];
+	if (valueOrder == ValueOrder::LeastConstraining) {
+		for (uint8_t peer : graph->peers(p.first * SUDOKU_SIZE + p.second)) {
+			const Cell& c = cells[peer / SUDOKU_SIZE][peer % SUDOKU_SIZE];
+			if (c.valueIsSet()) continue;
+			for (uint16_t m = c.getRemainingPossibilitiesMask() & f.untried; m != 0; m &= m - 1) {
+				rank[Bitboard81::countTrailingZeros(m)]++;
 			}
-			sortBt(k + 1);
-			if (backtrack(k + 1)) {
-				return true;
+		}
+	}
+	else if (valueOrder == ValueOrder::DigitFrequency) {
+		for (const auto& row : cells) {
+			for (const auto& c : row) {
+				if (c.valueIsSet()) {
+					rank[c.getValue()]--;
+				}
 			}
 		}
-		cells = snapshot;
 	}
-	return false;
+
+	int best = 0;
+	for (uint16_t m = f.untried; m != 0; m &= m - 1) {
+		const int v = Bitboard81::countTrailingZeros(m);
+		if (best == 0 || rank[v] < rank[best] || (rank[v] == rank[best] && digitKey[v] < digitKey[best])) {
+			best = v;
+		}
+	}
+	return best;
+}
+
+template <class Policies>
+uint64_t BasicSolution<Policies>::luby(uint64_t run) {
+	// Find the complete subsequence of length 2^k - 1 holding the run, then descend into it
+	uint64_t size = 1;
+	int exponent = 0;
+	while (size < run + 1) {
+		size = 2 * size + 1;
+		exponent++;
+	}
+	while (size - 1 != run) {
+		size = (size - 1) >> 1;
+		exponent--;
+		run = run % size;
+	}
+	return uint64_t(1) << exponent;
+}
+
+template <class Policies>
+inline void BasicSolution<Policies>::restart() {
+	stats.restarts++;
+	restoreLevel(0);
+	depth = 0;
+	nextPosition = 0;
+	descending = true;
+	failuresSinceRestart = 0;
+
+	if (restartPolicy == RestartPolicy::Luby) {
+		restartLimit = restartBase * luby(stats.restarts);
+	}
+	else {
+		// Grow by at least one guess, or a small limit would never move and the search never finish
+		const double grown = static_cast<double>(restartLimit) * restartGrowth;
+		if (grown >= static_cast<double>(std::numeric_limits<uint64_t>::max())) {
+			restartLimit = std::numeric_limits<uint64_t>::max();
+		}
+		else {
+			restartLimit = std::max(restartLimit + 1, static_cast<uint64_t>(grown));
+		}
+	}
+
+	drawTieKeys();
+	sortBt(bt.begin());
+}
+
+template <class Policies>
+inline bool BasicSolution<Policies>::shouldAbort() {
+	if (!Limits::enforced || options == nullptr) return false;
+
+	if (stats.nodes >= nodeLimit) {
+		aborted = true;
+		abortStatus = SolveStatus::BudgetExceeded;
+		return true;
+	}
+
+	if (stats.nodes % POLL_INTERVAL != 0) return false;
+
+	if (options->cancellation.isCancelled()) {
+		aborted = true;
+		abortStatus = SolveStatus::Cancelled;
+	}
+	else if (SolveOptions::Clock::now() >= options->deadline) {
+		aborted = true;
+		abortStatus = SolveStatus::BudgetExceeded;
+	}
+	return aborted;
+}
+
+template <class Policies>
+inline bool BasicSolution<Policies>::backtrack() {
+	SUDOKU_TIMELINE_SCOPE("backtrack");
+	for (;;) {
+		if (restartPolicy != RestartPolicy::None && depth > 0 && failuresSinceRestart >= restartLimit) {
+			restart();
+		}
+
+		if (descending) {
+			// Fast path: skip the cells that propagation already filled
+			while (nextPosition < bt.size() && cells[bt[nextPosition].first][bt[nextPosition].second].valueIsSet()) {
+				nextPosition++;
+			}
+			if (nextPosition == bt.size()) return true;
+
+			const auto& p = bt[nextPosition];
+			frames[depth] = Frame{ nextPosition, cells[p.first][p.second].getRemainingPossibilitiesMask(), tracing() ? trace->size() : 0, 0, LevelSet() };
+			if (learns()) {
+				// Values excluded before this level count as failures caused by their reasons
+				frames[depth].conflict = exclusionsOf(p.first, p.second);
+			}
+			snapshots[depth] = cells; // Create a copy of the array as a backup
+			depth++;
+			descending = false;
+
+			if (Instrumentation::counters && depth > stats.maxDepth) {
+				stats.maxDepth = static_cast<uint32_t>(depth);
+			}
+		}
+
+		Frame& f = frames[depth - 1];
+		const int level = static_cast<int>(depth) - 1;
+		if (f.untried == 0) {
+			// Every value failed at this level, so a guess further up was wrong
+			int target = level - 1;
+			if (learns()) {
+				// Only the guesses in the conflict set can be to blame, the ones in between are skipped
+				learnNogood(f.conflict);
+				target = f.conflict.last();
+				if (target >= 0) {
+					if (Instrumentation::counters) {
+						stats.levelsSkipped += level - 1 - target;
+					}
+					frames[target].conflict |= f.conflict.andNot(LevelSet::cell(target));
+				}
+			}
+			if (target < 0) {
+				depth = 0;
+				return false;
+			}
+
+			depth = target + 1;
+			if (Instrumentation::counters) {
+				stats.backtracks++;
+			}
+			failuresSinceRestart++;
+			restoreLevel(target);
+			continue;
+		}
+
+		// Checked before the value is consumed so a paused search retries it
+		if (shouldAbort()) return false;
+		stats.nodes++;
+
+		const int v = nextValue(f);
+		f.untried &= ~(1 << v);
+		f.value = static_cast<uint8_t>(v);
+
+		const auto& p = bt[f.position];
+		if (setValue(p.first, p.second, v, Technique::Guess, LevelSet::cell(level)) && applyNogoods()) {
+			if (CellSelection::resortAfterGuess) {
+				if (loggingEnabled) {
+					std::cout << "ASorting: " << bt.size() - f.position - 1 << " elements" << std::endl;
+				}
+				sortBt(bt.begin() + f.position + 1);
+			}
+			nextPosition = f.position + 1;
+			descending = true;
+		}
+		else {
+			if (Instrumentation::counters) {
+				stats.backtracks++;
+			}
+			failuresSinceRestart++;
+			if (learns()) {
+				f.conflict |= conflictLevels.andNot(LevelSet::cell(level));
+			}
+			restoreLevel(level);
+		}
+	}
+}
+
+template <class Policies>
+inline SolveStatus BasicSolution<Policies>::runSearch(std::array<std::array<char, SUDOKU_SIZE>, SUDOKU_SIZE>& board) {
+	aborted = false;
+	bool solved = paused ? backtrack() : findValuesForEmptyCells();
+	paused = aborted;
+
+	if (!solved) {
+		return aborted ? abortStatus : SolveStatus::Unsolvable;
+	}
+
+	for (int i = 0; i < SUDOKU_SIZE; i++) {
+		for (int j = 0; j < SUDOKU_SIZE; j++) {
+			if (cells[i][j].valueIsSet()) {
+				board[i][j] = intToChar(cells[i][j].getValue());
+			}
+		}
+	}
+
+	printVectorState(cells);
+	return SolveStatus::Solved;
 }
 
-void Solution::solveSudoku(std::array<std::array<char, Solution::SUDOKU_SIZE>, Solution::SUDOKU_SIZE>& board) {
+template <class Policies>
+inline bool BasicSolution<Policies>::applyGivens(const std::array<std::array<char, SUDOKU_SIZE>, SUDOKU_SIZE>& board) {
+	SUDOKU_TIMELINE_SCOPE("propagate givens");
 	initialize();
 
+	// Place every given before propagating, so deductions never claim a given cell
 	for (int i = 0; i < SUDOKU_SIZE; i++) {
 		for (int j = 0; j < SUDOKU_SIZE; j++) {
 			if (board[i][j] != '.') {
-				if (!setValue(i, j, charToInt(board[i][j])))
+				cells[i][j].setCellValue(charToInt(board[i][j]));
+				valueReason[i * SUDOKU_SIZE + j] = LevelSet();
+				if (tracing()) {
+					trace->record(i, j, charToInt(board[i][j]), Technique::Given);
+				}
+			}
+		}
+	}
+
+	for (int i = 0; i < SUDOKU_SIZE; i++) {
+		for (int j = 0; j < SUDOKU_SIZE; j++) {
+			if (board[i][j] != '.') {
+				if (!propagateValue(i, j, charToInt(board[i][j]), LevelSet()))
 				{
 					if (loggingEnabled) {
 						std::cout << "Unable to initialize, Either invalid, or unsolvable" << std::endl;
 					}
-					return; // unsolvable. Can't set the values that we were given
+					return false; // unsolvable. Can't set the values that we were given
 				}
 			}
 		}
 	}
 
-	if (!findValuesForEmptyCells()) return; // unsolvable.
+	// Cages without a given only narrow their cells here
+	for (size_t k = 0; k < graph->cageCount(); k++) {
+		if (!applyCage(k)) return false;
+	}
 
-	for (int i = 0; i < SUDOKU_SIZE; i++) {
-		for (int j = 0; j < SUDOKU_SIZE; j++) {
-			if (cells[i][j].valueIsSet()) {
-				board[i][j] = intToChar(cells[i][j].getValue());
+	if (Instrumentation::counters) {
+		for (const auto& row : cells) {
+			for (const auto& c : row) {
+				if (c.valueIsSet()) {
+					stats.cellsSetByPropagation++;
+				}
 			}
 		}
 	}
+	return true;
+}
 
-	printVectorState(cells);
+template <class Policies>
+inline SolveStatus BasicSolution<Policies>::solveBoard(std::array<std::array<char, SUDOKU_SIZE>, SUDOKU_SIZE>& board) {
+	if (!applyGivens(board)) return SolveStatus::Unsolvable;
+
+	return runSearch(board);
 }
+
+template <class Policies>
+void BasicSolution<Policies>::solveSudoku(std::array<std::array<char, SUDOKU_SIZE>, SUDOKU_SIZE>& board) {
+	auto startTime = SolveOptions::Clock::now();
+	options = nullptr;
+	configureSearch(SolveOptions());
+	solveBoard(board);
+	stats.elapsed = SolveOptions::Clock::now() - startTime;
+}
+
+template <class Policies>
+SolveStatus BasicSolution<Policies>::solveSudoku(std::array<std::array<char, SUDOKU_SIZE>, SUDOKU_SIZE>& board, const SolveOptions& opts) {
+	auto startTime = SolveOptions::Clock::now();
+	options = &opts;
+	nodeLimit = opts.maxNodes;
+	configureSearch(opts);
+	SolveStatus status = solveBoard(board);
+	options = nullptr;
+	stats.elapsed = SolveOptions::Clock::now() - startTime;
+	return status;
+}
+
+template <class Policies>
+SolveStatus BasicSolution<Policies>::resume(std::array<std::array<char, SUDOKU_SIZE>, SUDOKU_SIZE>& board, const SolveOptions& opts) {
+	if (!paused) throw std::logic_error("There is no paused search to resume");
+
+	auto startTime = SolveOptions::Clock::now();
+	options = &opts;
+	// The budget of this call comes on top of the nodes already tried, saturating on overflow
+	if (opts.maxNodes > std::numeric_limits<uint64_t>::max() - stats.nodes) {
+		nodeLimit = std::numeric_limits<uint64_t>::max();
+	}
+	else {
+		nodeLimit = stats.nodes + opts.maxNodes;
+	}
+	SolveStatus status = runSearch(board);
+	options = nullptr;
+	stats.elapsed += SolveOptions::Clock::now() - startTime;
+	return status;
+}
+
+template <class Policies>
+bool BasicSolution<Policies>::isPaused() const {
+	return paused;
+}
+
+template <class Policies>
+uint32_t BasicSolution<Policies>::countSolutions(const std::array<std::array<char, SUDOKU_SIZE>, SUDOKU_SIZE>& board, uint32_t limit) {
+	auto startTime = SolveOptions::Clock::now();
+	options = nullptr;
+	// Restarts would find the same solutions again
+	configureSearch(SolveOptions());
+	uint32_t count = 0;
+
+	if (applyGivens(board)) {
+		bool found = findValuesForEmptyCells();
+		while (found) {
+			count++;
+			if (count >= limit || depth == 0) break;
+
+			// Reject the last guess as if it had failed and keep searching
+			if (learns()) {
+				blameAllLevels();
+			}
+			if (Instrumentation::counters) {
+				stats.backtracks++;
+			}
+			restoreLevel(depth - 1);
+			descending = false;
+			found = backtrack();
+		}
+	}
+
+	stats.elapsed = SolveOptions::Clock::now() - startTime;
+	return count;
+}
+
+template <class Policies>
+void BasicSolution<Policies>::setTrace(SolveTrace* t) {
+	if (!Instrumentation::tracing && t != nullptr) throw std::logic_error("This engine is built without tracing");
+	trace = t;
+}
+
+template <class Policies>
+void BasicSolution<Policies>::setConstraints(const ConstraintGraph& g) {
+	graph = &g;
+}
+
+template <class Policies>
+const SolveStats& BasicSolution<Policies>::getStats() const {
+	return stats;
+}
+
+// The engines of SolverPolicies.h. Another combination of policies needs its line here
+template class BasicSolution<DefaultPolicies>;
+template class BasicSolution<FastPolicies>;
+template class BasicSolution<StaticOrderPolicies>;
+template class BasicSolution<ForwardCheckingPolicies>;
+template class BasicSolution<LoggingPolicies>;
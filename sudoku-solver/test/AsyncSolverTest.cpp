@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+
+#include <AsyncSolver.h>
+#include <SudokuValidator.h>
+#include <sudoku-solver.h>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+
+namespace {
+
+std::array<std::array<char, 9>, 9> leetcode = { {
+    {'5','3','.','.','7','.','.','.','.'},
+    {'6','.','.','1','9','5','.','.','.'},
+    {'.','9','8','.','.','.','.','6','.'},
+    {'8','.','.','.','6','.','.','.','3'},
+    {'4','.','.','8','.','3','.','.','1'},
+    {'7','.','.','.','2','.','.','.','6'},
+    {'.','6','.','.','.','.','2','8','.'},
+    {'.','.','.','4','1','9','.','.','5'},
+    {'.','.','.','.','8','.','.','7','9'}} };
+
+// No solution, but plain backtracking needs a very long time to prove it
+std::array<std::array<char, 9>, 9> runaway = { {
+    {'.','.','.','.','.','5','.','8','.'},
+    {'.','.','.','6','.','1','.','4','3'},
+    {'.','.','.','.','.','.','.','.','.'},
+    {'.','1','.','5','.','.','.','.','.'},
+    {'.','.','.','1','.','6','.','.','.'},
+    {'3','.','.','.','.','.','.','.','5'},
+    {'5','3','.','.','.','.','.','6','1'},
+    {'.','.','.','.','.','.','.','.','4'},
+    {'.','.','.','.','.','.','.','.','.'}} };
+
+}
+
+TEST(SolveOptionsTest, DeadlineStopsTheSearch) {
+    auto board = runaway;
+    SolveOptions opts;
+    opts.deadline = SolveOptions::Clock::now() + std::chrono::milliseconds(50);
+
+    Solution s;
+    EXPECT_EQ(s.solveSudoku(board, opts), SolveStatus::BudgetExceeded);
+    EXPECT_EQ(board, runaway);
+}
+
+TEST(SolveOptionsTest, SolutionIsReusable) {
+    Solution s;
+    SolveOptions opts;
+
+    auto first = leetcode;
+    EXPECT_EQ(s.solveSudoku(first, opts), SolveStatus::Solved);
+
+    auto second = leetcode;
+    second[0][1] = '5'; // Two 5s on the first row
+    EXPECT_EQ(s.solveSudoku(second, opts), SolveStatus::Unsolvable);
+
+    auto third = leetcode;
+    EXPECT_EQ(s.solveSudoku(third, opts), SolveStatus::Solved);
+    EXPECT_EQ(first, third);
+}
+
+TEST(AsyncSolverTest, FutureReturnsSolvedBoard) {
+    AsyncSolver solver(2);
+    auto future = solver.submit(leetcode);
+    AsyncSolveResult result = future.get();
+
+    EXPECT_EQ(result.status, SolveStatus::Solved);
+    EXPECT_TRUE(SudokuValidator::isSudokuValid(result.board));
+}
+
+TEST(AsyncSolverTest, CallbackIsCalled) {
+    AsyncSolver solver(1);
+    std::promise<SolveStatus> done;
+
+    solver.submit(leetcode, SolveOptions(), [&done](AsyncSolveResult& result) {
+        done.set_value(result.status);
+    });
+    EXPECT_EQ(done.get_future().get(), SolveStatus::Solved);
+}
+
+TEST(AsyncSolverTest, ThrowingCallbackKeepsTheWorker) {
+    AsyncSolver solver(1);
+    solver.submit(leetcode, SolveOptions(), [](AsyncSolveResult&) {
+        throw std::runtime_error("callback failed");
+    });
+
+    // The only worker survived the exception and picks up the next job
+    EXPECT_EQ(solver.submit(leetcode).get().status, SolveStatus::Solved);
+}
+
+TEST(AsyncSolverTest, CancelRunawayPuzzle) {
+    AsyncSolver solver(1);
+    SolveOptions opts;
+    auto runawayFuture = solver.submit(runaway, opts);
+    auto nextFuture = solver.submit(leetcode);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    opts.cancellation.cancel();
+
+    // The runaway puzzle frees the only worker, so the next puzzle still gets solved
+    EXPECT_EQ(runawayFuture.get().status, SolveStatus::Cancelled);
+    EXPECT_EQ(nextFuture.get().status, SolveStatus::Solved);
+}
+
+TEST(AsyncSolverTest, ManyPuzzles) {
+    AsyncSolver solver(4);
+    std::vector<std::future<AsyncSolveResult>> futures;
+    for (int i = 0; i < 32; i++) {
+        futures.push_back(solver.submit(leetcode));
+    }
+    for (auto& f : futures) {
+        AsyncSolveResult result = f.get();
+        EXPECT_TRUE(SudokuValidator::isSudokuValid(result.board));
+    }
+}
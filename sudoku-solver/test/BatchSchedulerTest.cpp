@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+
+#include <BatchScheduler.h>
+#include <BitboardSolution.h>
+#include <PuzzleFormat.h>
+#include <PuzzleGenerator.h>
+
+#include "TestPuzzles.h"
+
+#include <cmath>
+#include <limits>
+
+namespace {
+
+std::vector<std::array<std::array<char, 9>, 9>> mixedBatch() {
+    std::vector<std::array<std::array<char, 9>, 9>> boards;
+    PuzzleGenerator generator(21);
+    for (int i = 0; i < 40; i++) {
+        boards.push_back(generator.generate().puzzle);
+    }
+    boards.push_back(fromLine(hardLine));
+    boards.push_back(fromLine(unsolvableLine));
+    boards.push_back(fromLine(std::string("11") + std::string(79, '.'))); // Inconsistent givens
+    boards.push_back(fromLine(leetcodeLine));
+    return boards;
+}
+
+void expectMatchesSerial(const std::vector<std::array<std::array<char, 9>, 9>>& puzzles,
+                         const std::vector<std::array<std::array<char, 9>, 9>>& results,
+                         const std::vector<SolveStatus>& statuses) {
+    ASSERT_EQ(results.size(), puzzles.size());
+    ASSERT_EQ(statuses.size(), puzzles.size());
+    for (size_t i = 0; i < puzzles.size(); i++) {
+        auto expected = puzzles[i];
+        BitboardSolution s;
+        SolveStatus status = s.solveSudoku(expected, SolveOptions());
+        EXPECT_EQ(statuses[i], status) << i;
+        EXPECT_EQ(results[i], expected) << i;
+    }
+}
+
+}
+
+TEST(BatchSchedulerTest, Estimate) {
+    DifficultyEstimate easy = BatchScheduler::estimate(fromLine(leetcodeLine));
+    EXPECT_EQ(easy.clues, 30);
+    EXPECT_EQ(easy.unresolved, 0);
+    EXPECT_EQ(easy.score, 0);
+
+    DifficultyEstimate hard = BatchScheduler::estimate(fromLine(hardLine));
+    EXPECT_EQ(hard.clues, 17);
+    EXPECT_GT(hard.unresolved, 0);
+    EXPECT_GT(hard.score, 50);
+
+    std::array<std::array<char, 9>, 9> blank;
+    for (auto& row : blank) row.fill('.');
+    DifficultyEstimate empty = BatchScheduler::estimate(blank);
+    EXPECT_EQ(empty.unresolved, 81);
+    EXPECT_NEAR(empty.score, 81 * std::log2(9.0), 1e-9);
+
+    BitboardState state;
+    DifficultyEstimate kept;
+    ASSERT_TRUE(BatchScheduler::estimate(fromLine(hardLine), state, kept));
+    EXPECT_EQ(kept.clues, hard.clues);
+    EXPECT_EQ(kept.unresolved, hard.unresolved);
+    EXPECT_EQ(kept.score, BatchScheduler::score(state));
+
+    auto clash = fromLine(leetcodeLine);
+    clash[0][2] = '5';
+    EXPECT_FALSE(BatchScheduler::estimate(clash, state, kept));
+    EXPECT_EQ(kept.clues, 31);
+    EXPECT_EQ(kept.score, 0);
+}
+
+TEST(BatchSchedulerTest, SolvesLongestFirst) {
+    const auto puzzles = mixedBatch();
+    auto boards = puzzles;
+
+    BatchOptions options;
+    options.threads = 3;
+    options.splitScore = std::numeric_limits<double>::infinity();
+    BatchScheduler scheduler(options);
+    auto statuses = scheduler.solve(boards);
+
+    expectMatchesSerial(puzzles, boards, statuses);
+    const BatchStats& stats = scheduler.getStats();
+    EXPECT_EQ(stats.puzzles, puzzles.size());
+    EXPECT_EQ(stats.splitPuzzles, 0u);
+    EXPECT_EQ(stats.pieces, puzzles.size() - 1); // The inconsistent puzzle needs no job
+    EXPECT_LE(stats.longestPiece, stats.work);
+}
+
+TEST(BatchSchedulerTest, SplitsHardPuzzles) {
+    const auto puzzles = mixedBatch();
+    auto boards = puzzles;
+
+    BatchOptions options;
+    options.threads = 4;
+    options.splitScore = 20;
+    options.maxPieces = 16;
+    BatchScheduler scheduler(options);
+    auto statuses = scheduler.solve(boards);
+
+    expectMatchesSerial(puzzles, boards, statuses);
+    const BatchStats& stats = scheduler.getStats();
+    EXPECT_GT(stats.splitPuzzles, 0u);
+    EXPECT_GT(stats.pieces, puzzles.size());
+}
+
+TEST(BatchSchedulerTest, BudgetPerPiece) {
+    std::vector<std::array<std::array<char, 9>, 9>> boards{ fromLine(hardLine) };
+
+    BatchOptions options;
+    options.threads = 2;
+    options.maxNodes = 0;
+    options.splitScore = std::numeric_limits<double>::infinity();
+    BatchScheduler scheduler(options);
+    auto statuses = scheduler.solve(boards);
+
+    EXPECT_EQ(statuses[0], SolveStatus::BudgetExceeded);
+    EXPECT_EQ(boards[0], fromLine(hardLine));
+}
+
+TEST(BatchSchedulerTest, ShardsByNode) {
+    const auto puzzles = mixedBatch();
+    auto boards = puzzles;
+
+    // Two nodes sharing one CPU the process may use
+    int cpu = NumaTopology::detect().getNodes()[0].cpus[0];
+    NumaNode first;
+    first.cpus = { cpu };
+    NumaNode second;
+    second.id = 1;
+    second.cpus = { cpu };
+
+    BatchOptions options;
+    options.threads = 3;
+    options.splitScore = 20;
+    options.pinThreads = true;
+    options.shardByNode = true;
+    BatchScheduler scheduler(options, NumaTopology({ first, second }));
+    auto statuses = scheduler.solve(boards);
+
+    expectMatchesSerial(puzzles, boards, statuses);
+    const BatchStats& stats = scheduler.getStats();
+    EXPECT_EQ(stats.shards, 2u);
+#if defined(__linux__)
+    EXPECT_EQ(stats.pinnedThreads, 3u);
+#endif
+
+    // Fewer puzzles than shards leaves a shard empty
+    std::vector<std::array<std::array<char, 9>, 9>> one(1, fromLine(hardLine));
+    statuses = scheduler.solve(one);
+    ASSERT_EQ(statuses.size(), 1u);
+    EXPECT_EQ(statuses[0], SolveStatus::Solved);
+}
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+
+#include <BitboardSolution.h>
+#include <PuzzleFormat.h>
+#include <PuzzleGenerator.h>
+#include <SudokuValidator.h>
+#include <sudoku-solver.h>
+
+#include "TestPuzzles.h"
+
+TEST(Bitboard81Test, Operations) {
+    Bitboard81 b = Bitboard81::cell(3) | Bitboard81::cell(64) | Bitboard81::cell(80);
+    EXPECT_EQ(b.count(), 3);
+    EXPECT_EQ(b.first(), 3);
+    EXPECT_EQ(b.last(), 80);
+    EXPECT_TRUE(b.test(80));
+    EXPECT_FALSE(b.test(79));
+
+    b.reset(3);
+    EXPECT_EQ(b.first(), 64);
+    b.reset(64);
+    b.reset(80);
+    EXPECT_EQ(b.last(), -1);
+    EXPECT_EQ(Bitboard81::cell(63).last(), 63);
+    EXPECT_EQ(Bitboard81::all().count(), 81);
+    EXPECT_TRUE(Bitboard81::all().andNot(Bitboard81::all()).none());
+}
+
+TEST(BitboardStateTest, AssignRemovesPeers) {
+    BitboardState s = BitboardState::empty();
+    ASSERT_TRUE(s.assign(0, 5));
+    EXPECT_EQ(s.valueAt(0), 5);
+    EXPECT_EQ(s.candidatesAt(0), 1 << 5);
+    EXPECT_EQ(s.candidatesAt(8), 0x3FE & ~(1 << 5));  // same row
+    EXPECT_EQ(s.candidatesAt(72), 0x3FE & ~(1 << 5)); // same column
+    EXPECT_EQ(s.candidatesAt(20), 0x3FE & ~(1 << 5)); // same box
+    EXPECT_EQ(s.candidatesAt(40), 0x3FE);
+    EXPECT_FALSE(s.assign(1, 5));
+}
+
+TEST(BitboardSolutionTest, SolvesKnownPuzzles) {
+    const char* puzzles[] = {
+        "53..7....6..195....98....6.8...6...34..8.3..17...2...6.6....28....419..5....8..79",
+        ".518..3...2..4.5........7..1.3..........92.8......8.6..4..7....6......198........",
+        ".4..19.768.......3...6......9..27.1...4...9.......5.....3.62..7.2.5........4...6.",
+        "..............3.85..1.2.......5.7.....4...1...9.......5......73..2.1........4...9",
+        ".................................................................................",
+    };
+    BitboardSolution b;
+    Solution s;
+    for (const char* p : puzzles) {
+        auto board = fromLine(p);
+        auto expected = board;
+        EXPECT_EQ(b.solveSudoku(board, SolveOptions()), SolveStatus::Solved) << p;
+        EXPECT_TRUE(SudokuValidator::isSudokuValid(board)) << p;
+
+        // Both engines agree on puzzles with a unique solution
+        if (s.countSolutions(expected, 2) == 1) {
+            s.solveSudoku(expected);
+            EXPECT_EQ(board, expected) << p;
+        }
+    }
+}
+
+TEST(BitboardSolutionTest, MatchesCellSolverOnGeneratedPuzzles) {
+    PuzzleGenerator g(8);
+    BitboardSolution b;
+    for (int i = 0; i < 30; i++) {
+        GeneratedPuzzle p = g.generate();
+        auto board = p.puzzle;
+        b.solveSudoku(board);
+        EXPECT_EQ(board, p.solution);
+        EXPECT_EQ(b.countSolutions(p.puzzle, 2), 1u);
+    }
+}
+
+TEST(BitboardSolutionTest, Unsolvable) {
+    // Two 1s in a row
+    auto invalid = fromLine("1...1............................................................................");
+    auto board = invalid;
+    BitboardSolution b;
+    EXPECT_EQ(b.solveSudoku(board, SolveOptions()), SolveStatus::Unsolvable);
+    EXPECT_EQ(board, invalid);
+
+    EXPECT_EQ(b.countSolutions(invalid, 2), 0u);
+}
+
+TEST(BitboardSolutionTest, DeadlineOnRunawayPuzzle) {
+    // No solution, but proving it takes seconds of search
+    auto runaway = fromLine(".....5.8....6.1.43..........1.5........1.6...3.......553.....61........4.........");
+    auto board = runaway;
+    SolveOptions opts;
+    opts.deadline = SolveOptions::Clock::now() + std::chrono::milliseconds(20);
+
+    BitboardSolution b;
+    EXPECT_EQ(b.solveSudoku(board, opts), SolveStatus::BudgetExceeded);
+    EXPECT_EQ(board, runaway);
+    EXPECT_GT(b.getStats().nodes, 0u);
+}
+
+TEST(BitboardSolutionTest, CountSolutions) {
+    auto blank = fromLine(std::string(81, '.'));
+    BitboardSolution b;
+    EXPECT_EQ(b.countSolutions(blank, 3), 3u);
+}
+
+TEST(BitboardSolutionTest, NodeBudget) {
+    auto blank = fromLine(std::string(81, '.'));
+    SolveOptions opts;
+    opts.maxNodes = 0;
+
+    BitboardSolution b;
+    EXPECT_EQ(b.solveSudoku(blank, opts), SolveStatus::BudgetExceeded);
+    EXPECT_EQ(b.getStats().nodes, 0u);
+}
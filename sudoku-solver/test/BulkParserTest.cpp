@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include <BulkParser.h>
+#include <InputPuzzles.h>
+#include <PuzzleFormat.h>
+
+#include "TestPuzzles.h"
+
+#include <random>
+#include <string>
+
+namespace {
+
+using Board = BulkParser::Board;
+
+/// A board in the bracketed format, with `gap` called for the whitespace between tokens
+template <class Gap>
+std::string bracketed(const std::string& line, Gap gap) {
+    std::string text = "[" + gap();
+    for (int r = 0; r < 9; r++) {
+        text += "[" + gap();
+        for (int c = 0; c < 9; c++) {
+            text += std::string("\"") + line[r * 9 + c] + "\"" + gap();
+            if (c < 8) text += "," + gap();
+        }
+        text += "]" + gap();
+        if (r < 8) text += ",\n" + gap();
+    }
+    return text + "]";
+}
+
+std::string bracketed(const std::string& line) {
+    return bracketed(line, []() { return std::string(); });
+}
+
+}
+
+TEST(BulkParser, InputFiles) {
+    for (const InputPuzzle& input : inputPuzzles) {
+        ParseResult result = BulkParser::parse(input.text);
+        EXPECT_TRUE(result.errors.empty()) << input.name << ": " << result.errors[0].message;
+        EXPECT_EQ(result.boards.size(), 1u) << input.name;
+    }
+
+    ParseResult leetcode = BulkParser::parse(bracketed(leetcodeLine));
+    ASSERT_EQ(leetcode.boards.size(), 1u);
+    EXPECT_EQ(PuzzleFormat::toLine(leetcode.boards[0]), leetcodeLine);
+}
+
+TEST(BulkParser, MixedRecords) {
+    std::string zeros = leetcodeLine;
+    for (char& c : zeros) {
+        if (c == '.') c = '0';
+    }
+    const std::string text = "# header\n" + leetcodeLine + "\r\n" + zeros + " unsolvable\n\n  " + bracketed(leetcodeLine) + "\n" + leetcodeLine;
+    ParseResult result = BulkParser::parse(text);
+    ASSERT_TRUE(result.errors.empty()) << result.errors[0].message;
+    ASSERT_EQ(result.boards.size(), 4u);
+    for (const Board& board : result.boards) {
+        EXPECT_EQ(PuzzleFormat::toLine(board), leetcodeLine);
+    }
+    EXPECT_EQ(result.offsets[0], 9u);
+    EXPECT_EQ(result.offsets[1], 9u + 83);
+    EXPECT_EQ(text[result.offsets[2]], '[');
+    EXPECT_EQ(result.offsets[3], text.size() - 81);
+}
+
+TEST(BulkParser, CellsAcrossWindows) {
+    // Random whitespace moves every cell across the 64-byte window boundaries
+    std::mt19937 random(7);
+    for (int round = 0; round < 200; round++) {
+        std::string text = bracketed(leetcodeLine, [&random]() {
+            return std::string(random() % 7, random() % 2 ? ' ' : '\n');
+        });
+        ParseResult result = BulkParser::parse(std::string(round % 64, ' ') + text);
+        ASSERT_TRUE(result.errors.empty()) << round << ": " << result.errors[0].message << " at " << result.errors[0].offset;
+        ASSERT_EQ(result.boards.size(), 1u);
+        EXPECT_EQ(PuzzleFormat::toLine(result.boards[0]), leetcodeLine) << round;
+    }
+}
+
+TEST(BulkParser, ErrorsWithOffsets) {
+    std::string badCell = leetcodeLine;
+    badCell[40] = 'x';
+    std::string text = badCell + "\n" + leetcodeLine.substr(0, 80) + "\n" + leetcodeLine + "\n";
+    ParseResult result = BulkParser::parse(text);
+    ASSERT_EQ(result.errors.size(), 2u);
+    EXPECT_EQ(result.errors[0].offset, 40u);
+    EXPECT_EQ(result.errors[1].offset, 82u + 80);
+    EXPECT_EQ(result.errors[1].message, "Line board of 80 cells");
+    ASSERT_EQ(result.boards.size(), 1u);
+    EXPECT_EQ(result.offsets[0], 82u + 81);
+
+    // A bad byte, a short row and a missing end, each followed by a good board
+    std::string board = bracketed(leetcodeLine);
+    std::string badByte = board;
+    size_t at = badByte.find("\"7\"") + 1;
+    badByte[at] = 'x';
+    std::string shortRow = board;
+    shortRow.erase(shortRow.find(",\".\"]"), 4);
+    std::string all = badByte + "\n" + board + "\n" + shortRow + "\n" + board + "\n" + board.substr(0, 200);
+    result = BulkParser::parse(all);
+    ASSERT_EQ(result.errors.size(), 3u);
+    EXPECT_EQ(result.errors[0].offset, at);
+    EXPECT_EQ(result.errors[0].message, "Unexpected 'x' in a cell");
+    EXPECT_EQ(all[result.errors[1].offset], ']');
+    EXPECT_EQ(result.errors[1].message, "Row of 8 cells");
+    EXPECT_EQ(result.errors[2].offset, all.size());
+    EXPECT_EQ(result.boards.size(), 2u);
+
+    result = BulkParser::parse("@\n" + leetcodeLine);
+    ASSERT_EQ(result.errors.size(), 1u);
+    EXPECT_EQ(result.errors[0].offset, 0u);
+    EXPECT_EQ(result.boards.size(), 1u);
+}
+
+TEST(BulkParser, ManyLines) {
+    std::string text;
+    for (int i = 0; i < 10000; i++) {
+        text += leetcodeLine + "\n";
+    }
+    ParseResult result = BulkParser::parse(text);
+    EXPECT_TRUE(result.errors.empty());
+    ASSERT_EQ(result.boards.size(), 10000u);
+    EXPECT_EQ(result.offsets.back(), 9999u * 82);
+    EXPECT_THROW(BulkParser::parseFile("no-such-file"), std::runtime_error);
+}
@@ -0,0 +1,44 @@
+/*
+ * Solves a small batch through the shared library, from C. The other tests
+ * link the static library, where every symbol is visible.
+ */
+#include <sudoku-solver-c.h>
+
+#include <stdio.h>
+#include <string.h>
+
+static const char puzzles[] =
+    "53..7....6..195....98....6.8...6...34..8.3..17...2...6.6....28....419..5....8..79"
+    "11...............................................................................";
+
+static const char solution[] =
+    "534678912672195348198342567859761423426853791713924856961537284287419635345286179";
+
+static int fail(const char* message)
+{
+    fprintf(stderr, "%s\n", message);
+    return 1;
+}
+
+int main(void)
+{
+    char solutions[sizeof(puzzles)];
+    int32_t statuses[2] = { -1, -1 };
+    sudoku_solver* solver;
+    int64_t solved;
+
+    if (sudoku_api_version() != SUDOKU_C_API_VERSION) return fail("unexpected interface version");
+
+    solver = sudoku_solver_create(2);
+    if (solver == NULL) return fail("sudoku_solver_create failed");
+    sudoku_solver_set_max_nodes(solver, 0);
+    solved = sudoku_solve_batch(solver, puzzles, solutions, statuses, 2);
+    sudoku_solver_destroy(solver);
+
+    if (solved != 1) return fail("expected one puzzle solved");
+    if (statuses[0] != SUDOKU_SOLVED || statuses[1] != SUDOKU_UNSOLVABLE) return fail("unexpected statuses");
+    if (memcmp(solutions, solution, SUDOKU_CELLS) != 0) return fail("wrong solution");
+    if (memcmp(solutions + SUDOKU_CELLS, puzzles + SUDOKU_CELLS, SUDOKU_CELLS) != 0) return fail("unsolved puzzle was changed");
+    if (sudoku_solve_batch(NULL, puzzles, solutions, statuses, 2) != SUDOKU_ERROR_ARGUMENT) return fail("NULL handle accepted");
+    return 0;
+}
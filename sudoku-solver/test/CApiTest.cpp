@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+
+#include <BitboardSolution.h>
+#include <PuzzleFormat.h>
+#include <PuzzleGenerator.h>
+#include <SudokuValidator.h>
+#include <sudoku-solver-c.h>
+
+#include "TestPuzzles.h"
+
+#include <string>
+#include <vector>
+
+namespace {
+
+/// Puzzles laid out back to back, as a foreign caller would pass them
+std::string batchOf(const std::vector<std::string>& lines) {
+    std::string buffer;
+    for (const auto& line : lines) {
+        buffer += line;
+    }
+    return buffer;
+}
+
+void expectSolutionOf(const std::string& puzzle, const std::string& solution) {
+    ASSERT_EQ(solution.size(), 81u);
+    std::array<std::array<char, 9>, 9> board;
+    ASSERT_TRUE(PuzzleFormat::fromLine(solution, board));
+    EXPECT_TRUE(SudokuValidator::isSudokuValid(board));
+    for (size_t c = 0; c < 81; c++) {
+        if (puzzle[c] != '.' && puzzle[c] != '0') {
+            EXPECT_EQ(solution[c], puzzle[c]);
+        }
+    }
+}
+
+}
+
+TEST(CApi, SolvesMixedBatch) {
+    std::vector<std::string> lines = { leetcodeLine, unsolvableLine, std::string(81, '0'), hardLine,
+                                       std::string("11") + std::string(79, '.'), std::string(80, '.') + "x" };
+    std::string puzzles = batchOf(lines);
+    std::string solutions(puzzles.size(), ' ');
+    std::vector<int32_t> statuses(lines.size(), -1);
+
+    sudoku_solver* solver = sudoku_solver_create(1);
+    ASSERT_NE(solver, nullptr);
+    EXPECT_EQ(sudoku_solve_batch(solver, puzzles.data(), &solutions[0], statuses.data(), lines.size()), 3);
+    sudoku_solver_destroy(solver);
+
+    EXPECT_EQ(statuses, (std::vector<int32_t>{ SUDOKU_SOLVED, SUDOKU_UNSOLVABLE, SUDOKU_SOLVED, SUDOKU_SOLVED,
+                                               SUDOKU_UNSOLVABLE, SUDOKU_INVALID }));
+    for (size_t i = 0; i < lines.size(); i++) {
+        std::string solution = solutions.substr(81 * i, 81);
+        if (statuses[i] == SUDOKU_SOLVED) {
+            expectSolutionOf(lines[i], solution);
+        }
+        else {
+            EXPECT_EQ(solution, lines[i]);
+        }
+    }
+}
+
+TEST(CApi, ThreadsSolveInPlaceLikeOneThread) {
+    PuzzleGenerator generator(39);
+    std::vector<std::string> lines;
+    for (int i = 0; i < 200; i++) {
+        lines.push_back(PuzzleFormat::toLine(generator.generate().puzzle));
+    }
+    lines.push_back(hardLine);
+    lines.push_back(unsolvableLine);
+    const std::string puzzles = batchOf(lines);
+
+    std::string serial = puzzles;
+    std::vector<int32_t> serialStatuses(lines.size());
+    sudoku_solver* one = sudoku_solver_create(1);
+    ASSERT_NE(one, nullptr);
+    EXPECT_EQ(sudoku_solve_batch(one, serial.data(), &serial[0], serialStatuses.data(), lines.size()), 201);
+    sudoku_solver_destroy(one);
+
+    sudoku_solver* four = sudoku_solver_create(4);
+    ASSERT_NE(four, nullptr);
+    for (int round = 0; round < 3; round++) {
+        std::string parallel = puzzles;
+        std::vector<int32_t> parallelStatuses(lines.size());
+        EXPECT_EQ(sudoku_solve_batch(four, parallel.data(), &parallel[0], parallelStatuses.data(), lines.size()), 201);
+        EXPECT_EQ(parallel, serial);
+        EXPECT_EQ(parallelStatuses, serialStatuses);
+    }
+    sudoku_solver_destroy(four);
+}
+
+TEST(CApi, NodeBudget) {
+    std::string puzzle = hardLine;
+    std::string solution(81, ' ');
+    int32_t status = -1;
+
+    sudoku_solver* solver = sudoku_solver_create(2);
+    ASSERT_NE(solver, nullptr);
+    sudoku_solver_set_max_nodes(solver, 1);
+    EXPECT_EQ(sudoku_solve_batch(solver, puzzle.data(), &solution[0], &status, 1), 0);
+    EXPECT_EQ(status, SUDOKU_BUDGET_EXCEEDED);
+    EXPECT_EQ(solution, puzzle);
+
+    sudoku_solver_set_max_nodes(solver, 0);
+    EXPECT_EQ(sudoku_solve_batch(solver, puzzle.data(), &solution[0], &status, 1), 1);
+    EXPECT_EQ(status, SUDOKU_SOLVED);
+    sudoku_solver_destroy(solver);
+}
+
+TEST(CApi, RejectsMissingBuffers) {
+    char buffer[81];
+    int32_t status;
+    sudoku_solver* solver = sudoku_solver_create(1);
+    ASSERT_NE(solver, nullptr);
+    EXPECT_EQ(sudoku_solve_batch(nullptr, buffer, buffer, &status, 1), SUDOKU_ERROR_ARGUMENT);
+    EXPECT_EQ(sudoku_solve_batch(solver, nullptr, buffer, &status, 1), SUDOKU_ERROR_ARGUMENT);
+    EXPECT_EQ(sudoku_solve_batch(solver, buffer, buffer, nullptr, 1), SUDOKU_ERROR_ARGUMENT);
+    EXPECT_EQ(sudoku_solve_batch(solver, nullptr, nullptr, nullptr, 0), 0);
+    EXPECT_EQ(sudoku_api_version(), SUDOKU_C_API_VERSION);
+    sudoku_solver_destroy(solver);
+    sudoku_solver_destroy(nullptr);
+}
@@ -126,4 +126,16 @@ TEST(CellTest, setValue) {
 
     EXPECT_THROW(c.setCellValue(0), std::logic_error);
     EXPECT_THROW(c.setCellValue(10), std::logic_error);
+}
+
+TEST(CellTest, getRemainingPossibilitiesMask) {
+    Cell c;
+    EXPECT_EQ(c.getRemainingPossibilitiesMask(), 0b1111111110);
+
+    EXPECT_NO_THROW(c.excludeValue(1));
+    EXPECT_NO_THROW(c.excludeValue(9));
+    EXPECT_EQ(c.getRemainingPossibilitiesMask(), 0b0111111100);
+
+    EXPECT_NO_THROW(c.setCellValue(4));
+    EXPECT_EQ(c.getRemainingPossibilitiesMask(), 0b0000010000);
 }
\ No newline at end of file
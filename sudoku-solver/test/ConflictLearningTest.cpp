@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+
+#include <BitboardSolution.h>
+#include <PuzzleFormat.h>
+#include <PuzzleGenerator.h>
+#include <SudokuValidator.h>
+#include <sudoku-solver.h>
+
+#include "TestPuzzles.h"
+
+#include <random>
+
+namespace {
+
+SolveOptions chronological() {
+    SolveOptions opts;
+    opts.learnFromConflicts = false;
+    return opts;
+}
+
+}
+
+TEST(ConflictLearningTest, SameSolutionWithFewerNodes) {
+    Solution plain;
+    auto expected = fromLine(hardLine);
+    ASSERT_EQ(plain.solveSudoku(expected, chronological()), SolveStatus::Solved);
+    EXPECT_EQ(plain.getStats().levelsSkipped, 0u);
+    EXPECT_EQ(plain.getStats().nogoodsLearned, 0u);
+
+    Solution learning;
+    auto board = fromLine(hardLine);
+    ASSERT_EQ(learning.solveSudoku(board, SolveOptions()), SolveStatus::Solved);
+    EXPECT_TRUE(SudokuValidator::isSudokuValid(board));
+    EXPECT_EQ(board, expected); // The puzzle has a single solution
+
+    EXPECT_GT(learning.getStats().levelsSkipped, 0u);
+    EXPECT_GT(learning.getStats().nogoodsLearned, 0u);
+    EXPECT_LT(learning.getStats().nodes * 2, plain.getStats().nodes);
+}
+
+TEST(ConflictLearningTest, ProvesUnsolvable) {
+    // Consistent givens, but 9 at r1c6 leaves no solution
+    auto board = fromLine(".5...98..94.6.5..3....2....8..4......3.5...98.75..2...5....614....2.....4.2...96.");
+    const auto before = board;
+
+    Solution s;
+    EXPECT_EQ(s.solveSudoku(board, SolveOptions()), SolveStatus::Unsolvable);
+    EXPECT_EQ(board, before);
+    EXPECT_EQ(s.solveSudoku(board, chronological()), SolveStatus::Unsolvable);
+}
+
+TEST(ConflictLearningTest, ResumeKeepsLearnedState) {
+    Solution reference;
+    auto expected = fromLine(hardLine);
+    reference.solveSudoku(expected, SolveOptions());
+
+    SolveOptions slice;
+    slice.maxNodes = 100;
+
+    Solution s;
+    auto board = fromLine(hardLine);
+    SolveStatus status = s.solveSudoku(board, slice);
+    while (status == SolveStatus::BudgetExceeded) {
+        status = s.resume(board, slice);
+    }
+    ASSERT_EQ(status, SolveStatus::Solved);
+    EXPECT_EQ(board, expected);
+    EXPECT_EQ(s.getStats().nodes, reference.getStats().nodes);
+}
+
+TEST(ConflictLearningTest, CountsMatchBitboardEngine) {
+    // Sparse puzzles with many solutions exercise the chronological fallback after each solution
+    PuzzleGenerator generator(11);
+    std::mt19937 rng(11);
+    for (int n = 0; n < 100; n++) {
+        auto board = generator.randomSolvedGrid();
+        for (int k = 0; k < 58; k++) {
+            board[rng() % 9][rng() % 9] = '.';
+        }
+
+        Solution s;
+        BitboardSolution b;
+        EXPECT_EQ(s.countSolutions(board, 4), b.countSolutions(board, 4));
+    }
+}
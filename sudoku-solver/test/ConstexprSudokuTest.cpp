@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+
+#include <ConstexprSudoku.h>
+
+// Only built with -DSUDOKU_CXX17=ON
+#ifdef SUDOKU_HAS_CONSTEXPR_SOLVER
+
+#include <InputPuzzles.h>
+#include <PuzzleFormat.h>
+#include <PuzzleGenerator.h>
+#include <sudoku-solver.h>
+
+#include <utility>
+
+namespace {
+
+using Board = ConstexprSudoku::Board;
+
+constexpr bool solvesInput(const InputPuzzle& input)
+{
+    const Board puzzle = ConstexprSudoku::fromArrayText(input.text);
+    const ConstexprSudoku::Result result = ConstexprSudoku::solve(puzzle);
+    return result.solved && ConstexprSudoku::solves(result.board, puzzle);
+}
+
+template <size_t... I>
+constexpr bool solvesEveryInput(std::index_sequence<I...>)
+{
+    return (solvesInput(inputPuzzles[I]) && ...);
+}
+
+constexpr size_t inputCount = sizeof(inputPuzzles) / sizeof(inputPuzzles[0]);
+
+// Every puzzle of input/ is solved by the compiler
+static_assert(inputCount > 0, "No puzzle found in input/");
+static_assert(solvesEveryInput(std::make_index_sequence<inputCount>()), "A puzzle of input/ has no solution");
+
+// Known answer of the LeetCode puzzle
+constexpr Board leetcode = ConstexprSudoku::fromLine("53..7....6..195....98....6.8...6...34..8.3..17...2...6.6....28....419..5....8..79");
+constexpr ConstexprSudoku::Result leetcodeSolved = ConstexprSudoku::solve(leetcode);
+static_assert(leetcodeSolved.solved, "");
+static_assert(ConstexprSudoku::equal(leetcodeSolved.board, ConstexprSudoku::fromLine("534678912672195348198342567859761423426853791713924856961537284287419635345286179")), "");
+
+// Clashing givens and impossible puzzles
+static_assert(!ConstexprSudoku::solve(ConstexprSudoku::fromLine("55...............................................................................")).solved, "");
+static_assert(!ConstexprSudoku::solve(ConstexprSudoku::fromLine("12345678.........9...............................................................")).solved, "");
+
+// A solution table built by the compiler
+constexpr std::array<Board, 2> tablePuzzles{ leetcode, ConstexprSudoku::fromLine(".................................................................................") };
+constexpr std::array<ConstexprSudoku::Result, 2> table = ConstexprSudoku::solveAll(tablePuzzles);
+static_assert(ConstexprSudoku::equal(table[0].board, leetcodeSolved.board) && ConstexprSudoku::isSolved(table[1].board), "");
+
+}
+
+TEST(ConstexprSudoku, MatchesRuntimeSolver) {
+    PuzzleGenerator generator(21);
+    for (int i = 0; i < 50; i++) {
+        Board puzzle = generator.generate().puzzle;
+        ConstexprSudoku::Result result = ConstexprSudoku::solve(puzzle);
+        ASSERT_TRUE(result.solved);
+
+        // Generated puzzles have a single solution, so both solvers must agree
+        Board expected = puzzle;
+        Solution s;
+        s.solveSudoku(expected);
+        EXPECT_EQ(result.board, expected) << PuzzleFormat::toLine(puzzle);
+    }
+}
+
+TEST(ConstexprSudoku, RejectsMalformedText) {
+    EXPECT_THROW(ConstexprSudoku::fromLine("123"), std::invalid_argument);
+    EXPECT_THROW(ConstexprSudoku::fromArrayText("[[\"1\",\"2\"]]"), std::invalid_argument);
+
+    Board bad = ConstexprSudoku::fromLine(std::string(81, '.'));
+    bad[4][4] = 'x';
+    EXPECT_FALSE(ConstexprSudoku::solve(bad).solved);
+    EXPECT_EQ(ConstexprSudoku::solve(bad).board, bad);
+}
+
+#endif
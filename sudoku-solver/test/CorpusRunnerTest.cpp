@@ -0,0 +1,222 @@
+#include <gtest/gtest.h>
+
+#include <CorpusRunner.h>
+#include <PuzzleFormat.h>
+#include <PuzzleGenerator.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/// A fresh run directory and input under the test temporary directory, removed at the end
+class CorpusRunnerTest : public testing::Test {
+protected:
+    std::string directory;
+    std::string input;
+    std::string output;
+
+    void SetUp() override {
+        std::string base = testing::TempDir() + "corpus-" + testing::UnitTest::GetInstance()->current_test_info()->name();
+        directory = base + "-run";
+        input = base + ".txt";
+        output = base + ".out";
+
+        // Ten puzzles with a comment, a broken line and a blank line in between
+        PuzzleGenerator generator(11);
+        std::ofstream in(input, std::ios::binary);
+        in << "# corpus\n";
+        for (int i = 0; i < 10; i++) {
+            in << PuzzleFormat::toLine(generator.generate().puzzle) << '\n';
+            if (i == 4) in << "not a puzzle\n\n";
+        }
+    }
+
+    void TearDown() override {
+        removeRun();
+        std::remove(input.c_str());
+        std::remove(output.c_str());
+    }
+
+    /// Remove the run directory, keeping the input
+    void removeRun() {
+        for (int k = 0; k < 16; k++) {
+            for (const char* suffix : { ".out", ".done", ".progress", ".claim" }) {
+                std::remove((directory + "/shard-" + std::to_string(k) + suffix).c_str());
+            }
+        }
+        std::remove((directory + "/plan").c_str());
+        std::remove(directory.c_str());
+    }
+
+    std::string read(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        std::ostringstream text;
+        text << in.rdbuf();
+        return text.str();
+    }
+
+    void write(const std::string& path, const std::string& text) {
+        std::ofstream(path, std::ios::binary) << text;
+    }
+
+    /// Let several workers race for the expired claim of a one-shard run and check that exactly one solves it
+    void raceHeirs(int heirCount, int trials) {
+        CorpusRunner::plan(input, directory, 100);
+        const std::string expected = cleanRun();
+
+        for (int trial = 0; trial < trials; trial++) {
+            removeRun();
+            CorpusRunner::plan(input, directory, 100);
+            write(directory + "/shard-0.claim", "dead 0\n");
+
+            // All see the expired claim, only one may take the shard over
+            std::vector<size_t> finished(heirCount, 0);
+            std::vector<std::thread> heirs;
+            for (int w = 0; w < heirCount; w++) {
+                heirs.emplace_back([this, w, &finished]() {
+                    CorpusOptions options;
+                    options.worker = "heir" + std::to_string(w);
+                    options.threads = 1;
+                    options.checkpointEvery = 2;
+                    finished[w] = CorpusRunner(directory, options).work();
+                });
+            }
+            for (auto& heir : heirs) {
+                heir.join();
+            }
+
+            size_t total = 0;
+            for (size_t f : finished) {
+                total += f;
+            }
+            EXPECT_EQ(total, 1u) << trial;
+            CorpusStats stats = CorpusRunner(directory).merge(output);
+            EXPECT_EQ(read(output), expected) << trial;
+            EXPECT_EQ(stats.puzzles, 11u) << trial;
+        }
+    }
+
+    /// Solve everything with one worker and return the merged output
+    std::string cleanRun() {
+        CorpusOptions options;
+        options.threads = 2;
+        options.checkpointEvery = 2;
+        CorpusRunner runner(directory, options);
+        runner.work();
+        runner.merge(output);
+        return read(output);
+    }
+};
+
+}
+
+TEST_F(CorpusRunnerTest, PlanIsDeterministic) {
+    CorpusPlan plan = CorpusRunner::plan(input, directory, 4);
+    ASSERT_EQ(plan.shards.size(), 4u); // 13 lines
+    EXPECT_EQ(plan.shards[0].offset, 0u);
+    EXPECT_EQ(plan.shards[3].lines, 1u);
+
+    EXPECT_THROW(CorpusRunner::plan(input, directory, 4), std::runtime_error);
+
+    CorpusPlan loaded = CorpusRunner(directory).loadPlan();
+    EXPECT_EQ(loaded.input, input);
+    ASSERT_EQ(loaded.shards.size(), plan.shards.size());
+    for (size_t k = 0; k < plan.shards.size(); k++) {
+        EXPECT_EQ(loaded.shards[k].offset, plan.shards[k].offset);
+        EXPECT_EQ(loaded.shards[k].lines, plan.shards[k].lines);
+    }
+}
+
+TEST_F(CorpusRunnerTest, WorkAndMerge) {
+    CorpusRunner::plan(input, directory, 4);
+    CorpusRunner runner(directory);
+    EXPECT_THROW(runner.merge(output), std::runtime_error);
+
+    CorpusOptions options;
+    options.checkpointEvery = 3;
+    EXPECT_EQ(CorpusRunner(directory, options).work(), 4u);
+    EXPECT_EQ(CorpusRunner(directory, options).work(), 0u);
+    for (ShardState state : runner.status()) {
+        EXPECT_EQ(state, ShardState::Done);
+    }
+
+    CorpusStats stats = runner.merge(output);
+    EXPECT_EQ(stats.puzzles, 11u);
+    EXPECT_EQ(stats.solved, 10u);
+    EXPECT_EQ(stats.invalid, 1u);
+
+    std::istringstream in(read(input));
+    std::istringstream out(read(output));
+    std::string puzzle;
+    std::string result;
+    while (std::getline(in, puzzle)) {
+        if (puzzle.empty() || puzzle[0] == '#') continue;
+        ASSERT_TRUE(std::getline(out, result));
+        std::array<std::array<char, 9>, 9> board;
+        if (!PuzzleFormat::fromLine(puzzle, board)) {
+            EXPECT_EQ(result, "invalid");
+            continue;
+        }
+        ASSERT_EQ(result.size(), 81u);
+        for (size_t c = 0; c < 81; c++) {
+            if (puzzle[c] != '.') {
+                EXPECT_EQ(result[c], puzzle[c]) << c;
+            }
+        }
+    }
+    EXPECT_FALSE(std::getline(out, result));
+}
+
+TEST_F(CorpusRunnerTest, ResumesFromCheckpoint) {
+    CorpusRunner::plan(input, directory, 100);
+    const std::string expected = cleanRun();
+    TearDown();
+    SetUp();
+    CorpusRunner::plan(input, directory, 100);
+
+    // A worker died long ago after checkpointing three lines and writing a bit more
+    std::istringstream lines(expected);
+    std::string first;
+    std::string second;
+    std::getline(lines, first);
+    std::getline(lines, second);
+    write(directory + "/shard-0.claim", "dead 0\n");
+    write(directory + "/shard-0.progress", "next 3\nbytes " + std::to_string(2 * 82) + "\npuzzles 2\nsolved 2\n");
+    write(directory + "/shard-0.out", first + '\n' + second + '\n' + "partial line");
+
+    CorpusOptions options;
+    options.worker = "heir";
+    options.checkpointEvery = 2;
+    EXPECT_EQ(CorpusRunner(directory, options).work(), 1u);
+    CorpusStats stats = CorpusRunner(directory).merge(output);
+    EXPECT_EQ(read(output), expected);
+    EXPECT_EQ(stats.puzzles, 11u);
+    EXPECT_EQ(stats.solved, 10u);
+}
+
+TEST_F(CorpusRunnerTest, LiveClaimIsLeftAlone) {
+    CorpusRunner::plan(input, directory, 7);
+    write(directory + "/shard-0.claim", "alive " + std::to_string(std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count()) + "\n");
+
+    CorpusRunner runner(directory);
+    EXPECT_EQ(runner.work(), 1u);
+    std::vector<ShardState> states = runner.status();
+    ASSERT_EQ(states.size(), 2u);
+    EXPECT_EQ(states[0], ShardState::Claimed);
+    EXPECT_EQ(states[1], ShardState::Done);
+    EXPECT_THROW(runner.merge(output), std::runtime_error);
+    EXPECT_EQ(runner.finishedStats().puzzles, 5u);
+}
+
+TEST_F(CorpusRunnerTest, RacingHeirsSolveOnce) {
+    raceHeirs(2, 4);
+}
+
+TEST_F(CorpusRunnerTest, ThreeRacingHeirsSolveOnce) {
+    raceHeirs(3, 4);
+}
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include <LatencyHistogram.h>
+#include <LoadReplay.h>
+#include <PuzzleFormat.h>
+#include <PuzzleGenerator.h>
+
+#include <stdexcept>
+
+TEST(LatencyHistogram, ExactBelowSubBucketRange) {
+    LatencyHistogram h;
+    for (uint64_t v = 1; v <= 1000; v++) {
+        h.record(v);
+    }
+    EXPECT_EQ(h.count(), 1000u);
+    EXPECT_EQ(h.min(), 1u);
+    EXPECT_EQ(h.max(), 1000u);
+    EXPECT_DOUBLE_EQ(h.mean(), 500.5);
+    EXPECT_EQ(h.valueAtPercentile(50), 500u);
+    EXPECT_EQ(h.valueAtPercentile(99), 990u);
+    EXPECT_EQ(h.valueAtPercentile(100), 1000u);
+}
+
+TEST(LatencyHistogram, RelativePrecision) {
+    LatencyHistogram h;
+    const uint64_t values[] = { 1234567, 987654321, 3000000000ULL, 123456789012ULL };
+    for (uint64_t v : values) {
+        h.reset();
+        h.record(v);
+        h.record(v + 1); // So the percentile comes from the bucket, not from max
+        uint64_t p = h.valueAtPercentile(50);
+        EXPECT_GE(p, v);
+        EXPECT_LE(static_cast<double>(p - v), static_cast<double>(v) * 1e-3) << v;
+    }
+}
+
+TEST(LatencyHistogram, TailAndMerge) {
+    LatencyHistogram fast;
+    LatencyHistogram slow;
+    for (int i = 0; i < 9990; i++) fast.record(std::chrono::microseconds(100));
+    for (int i = 0; i < 10; i++) slow.record(std::chrono::milliseconds(50));
+
+    fast.add(slow);
+    EXPECT_EQ(fast.count(), 10000u);
+    EXPECT_NEAR(static_cast<double>(fast.valueAtPercentile(99)), 100000.0, 100.0);
+    EXPECT_NEAR(static_cast<double>(fast.valueAtPercentile(99.95)), 50000000.0, 50000.0);
+    EXPECT_EQ(fast.max(), 50000000u);
+
+    // Over the range, counted at the top
+    LatencyHistogram small(1000000);
+    small.record(5000000);
+    EXPECT_EQ(small.max(), 1000000u);
+    EXPECT_THROW(fast.add(small), std::invalid_argument);
+    EXPECT_THROW(LatencyHistogram(1000, 6), std::invalid_argument);
+}
+
+TEST(LoadReplay, InlineAndPool) {
+    PuzzleGenerator generator(3);
+    std::vector<LoadReplay::Board> corpus;
+    for (int i = 0; i < 20; i++) {
+        corpus.push_back(generator.generate().puzzle);
+    }
+
+    for (ReplayMode mode : { ReplayMode::Inline, ReplayMode::Pool }) {
+        ReplayConfig config;
+        config.mode = mode;
+        config.threads = 2;
+        config.rate = 2000;
+        config.requests = 50;
+        ReplayStats stats = LoadReplay(config).run(corpus);
+        EXPECT_EQ(stats.sent, 50u);
+        EXPECT_EQ(stats.solved, 50u);
+        EXPECT_EQ(stats.response.count(), 50u);
+        EXPECT_EQ(stats.service.count(), 50u);
+
+        // The last arrival is due 24.5 ms in, so the run can't be shorter
+        EXPECT_GE(stats.elapsed, std::chrono::microseconds(24500));
+        EXPECT_GE(stats.response.max(), stats.service.min());
+    }
+
+    ReplayConfig bad;
+    bad.rate = 0;
+    EXPECT_THROW(LoadReplay{ bad }, std::invalid_argument);
+}
+
+TEST(LoadReplay, StallIsChargedToLaterArrivals) {
+    // One thread and arrivals far faster than it solves: the queue grows, and
+    // the response latencies must grow with it although every solve is quick
+    PuzzleGenerator generator(4);
+    std::vector<LoadReplay::Board> corpus{ generator.generate().puzzle };
+
+    ReplayConfig config;
+    config.mode = ReplayMode::Inline;
+    config.rate = 1e7;
+    config.requests = 2000;
+    ReplayStats stats = LoadReplay(config).run(corpus);
+    EXPECT_GT(stats.response.valueAtPercentile(99), 10 * stats.service.valueAtPercentile(99));
+    EXPECT_GT(stats.maxSendLag.count(), 0);
+}
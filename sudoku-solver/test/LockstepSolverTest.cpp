@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include <LockstepSolver.h>
+#include <PuzzleGenerator.h>
+#include <SudokuGeometry.h>
+#include <SudokuValidator.h>
+#include <sudoku-solver.h>
+
+#include <set>
+
+TEST(SudokuGeometryTest, UnitsAndPeers) {
+    const auto& units = SudokuGeometry::units();
+    const auto& peers = SudokuGeometry::peers();
+
+    // Square 4 is the center square
+    std::set<int> center(units[22].begin(), units[22].end());
+    EXPECT_EQ(center, std::set<int>({ 30, 31, 32, 39, 40, 41, 48, 49, 50 }));
+
+    for (size_t c = 0; c < SudokuGeometry::CELLS; c++) {
+        std::set<int> unique(peers[c].begin(), peers[c].end());
+        EXPECT_EQ(unique.size(), SudokuGeometry::PEERS);
+        EXPECT_EQ(unique.count(static_cast<int>(c)), 0u);
+    }
+}
+
+TEST(LockstepSolverTest, MatchesScalarSolver) {
+    std::vector<std::array<std::array<char, 9>, 9>> boards;
+    PuzzleGenerator g(11);
+    for (int i = 0; i < 37; i++) {
+        boards.push_back(g.generate().puzzle);
+    }
+    auto expected = boards;
+
+    LockstepSolver lockstep;
+    auto statuses = lockstep.solve(boards);
+
+    Solution s;
+    for (size_t i = 0; i < boards.size(); i++) {
+        s.solveSudoku(expected[i]);
+        EXPECT_EQ(statuses[i], SolveStatus::Solved);
+        EXPECT_EQ(boards[i], expected[i]);
+    }
+
+    const auto& stats = lockstep.getStats();
+    EXPECT_EQ(stats.solvedInLockstep + stats.fellBack, boards.size());
+    EXPECT_GT(stats.solvedInLockstep, 0u);
+}
+
+TEST(LockstepSolverTest, MixedBatch) {
+    std::array<std::array<char, 9>, 9> blank;
+    for (auto& row : blank) row.fill('.');
+
+    auto invalid = blank;
+    invalid[0][0] = '1';
+    invalid[0][5] = '1';
+
+    PuzzleGenerator g(5);
+    GeneratedPuzzle easy;
+    ASSERT_TRUE(g.generate(Difficulty::Easy, 20, easy));
+
+    std::vector<std::array<std::array<char, 9>, 9>> boards = { easy.puzzle, invalid, blank };
+    LockstepSolver lockstep;
+    auto statuses = lockstep.solve(boards);
+
+    EXPECT_EQ(statuses[0], SolveStatus::Solved);
+    EXPECT_EQ(boards[0], easy.solution);
+
+    EXPECT_EQ(statuses[1], SolveStatus::Unsolvable);
+    EXPECT_EQ(boards[1], invalid);
+
+    EXPECT_EQ(statuses[2], SolveStatus::Solved);
+    EXPECT_TRUE(SudokuValidator::isSudokuValid(boards[2]));
+
+    EXPECT_EQ(lockstep.getStats().solvedInLockstep, 1u);
+    EXPECT_EQ(lockstep.getStats().unsolvableInLockstep, 1u);
+    EXPECT_EQ(lockstep.getStats().fellBack, 1u);
+}
@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+
+#include <MinimalityChecker.h>
+#include <PuzzleFormat.h>
+#include <PuzzleGenerator.h>
+#include <sudoku-solver.h>
+
+#include "TestPuzzles.h"
+
+#include <vector>
+
+namespace {
+
+using Board = MinimalityChecker::Board;
+
+/// The clues whose removal alone keeps the solution unique, found with one full count per clue
+std::vector<uint8_t> redundantByCounting(const Board& puzzle) {
+    std::vector<uint8_t> redundant;
+    for (int c = 0; c < 81; c++) {
+        if (puzzle[c / 9][c % 9] == '.') continue;
+        Board without = puzzle;
+        without[c / 9][c % 9] = '.';
+        Solution s;
+        if (s.countSolutions(without, 2) == 1) {
+            redundant.push_back(static_cast<uint8_t>(c));
+        }
+    }
+    return redundant;
+}
+
+/// Generated puzzles, half of them with a few clues of the solution put back
+std::vector<Board> samplePuzzles(size_t count) {
+    PuzzleGenerator generator(48);
+    std::vector<Board> puzzles;
+    for (size_t i = 0; i < count; i++) {
+        GeneratedPuzzle g = generator.generate();
+        if (i % 2 == 1) {
+            for (int c = static_cast<int>(i); c < 81; c += 13) {
+                g.puzzle[c / 9][c % 9] = g.solution[c / 9][c % 9];
+            }
+        }
+        puzzles.push_back(g.puzzle);
+    }
+    return puzzles;
+}
+
+int clueCount(const Board& board) {
+    int n = 0;
+    for (const auto& row : board) {
+        for (char v : row) {
+            if (v != '.') n++;
+        }
+    }
+    return n;
+}
+
+}
+
+TEST(MinimalityChecker, MatchesCounting) {
+    std::vector<Board> puzzles = samplePuzzles(8);
+    puzzles.push_back(fromLine(leetcodeLine));
+
+    MinimalityChecker checker;
+    for (const Board& puzzle : puzzles) {
+        MinimalityResult r = checker.run(puzzle, MinimalityMode::Check);
+        ASSERT_EQ(r.solutions, 1u) << PuzzleFormat::toLine(puzzle);
+        EXPECT_EQ(r.redundant, redundantByCounting(puzzle)) << PuzzleFormat::toLine(puzzle);
+        EXPECT_EQ(r.trials, static_cast<uint32_t>(clueCount(puzzle)));
+        EXPECT_EQ(r.puzzle, puzzle);
+    }
+
+    // Clue removal of the generator stops at a minimal puzzle
+    EXPECT_TRUE(checker.run(samplePuzzles(1)[0], MinimalityMode::Check).isMinimal());
+    EXPECT_FALSE(checker.run(fromLine(leetcodeLine), MinimalityMode::Check).isMinimal());
+}
+
+TEST(MinimalityChecker, ReducesToAMinimalPuzzle) {
+    std::vector<Board> puzzles = samplePuzzles(4);
+    puzzles.push_back(fromLine(leetcodeLine));
+    puzzles.push_back(fromLine(solvedLine));
+
+    MinimalityChecker checker;
+    for (const Board& puzzle : puzzles) {
+        MinimalityResult r = checker.run(puzzle, MinimalityMode::Reduce);
+        ASSERT_EQ(r.solutions, 1u);
+        EXPECT_EQ(clueCount(r.puzzle), clueCount(puzzle) - static_cast<int>(r.redundant.size()));
+        for (int c = 0; c < 81; c++) {
+            if (r.puzzle[c / 9][c % 9] != '.') {
+                EXPECT_EQ(r.puzzle[c / 9][c % 9], puzzle[c / 9][c % 9]) << c;
+            }
+        }
+        EXPECT_TRUE(checker.run(r.puzzle, MinimalityMode::Check).isMinimal()) << PuzzleFormat::toLine(r.puzzle);
+
+        Board solution = r.puzzle;
+        Solution s;
+        ASSERT_EQ(s.countSolutions(solution, 2), 1u);
+        s.solveSudoku(solution);
+        Board expected = puzzle;
+        s.solveSudoku(expected);
+        EXPECT_EQ(solution, expected);
+    }
+}
+
+TEST(MinimalityChecker, FullGridHasOnlyRedundantClues) {
+    MinimalityResult r = MinimalityChecker().run(fromLine(solvedLine), MinimalityMode::Check);
+    EXPECT_EQ(r.solutions, 1u);
+    EXPECT_EQ(r.redundant.size(), 81u);
+}
+
+TEST(MinimalityChecker, NeedsAUniqueSolution) {
+    Board empty;
+    for (auto& row : empty) row.fill('.');
+    MinimalityResult r = MinimalityChecker().run(empty, MinimalityMode::Check);
+    EXPECT_EQ(r.solutions, 2u);
+    EXPECT_EQ(r.trials, 0u);
+    EXPECT_FALSE(r.isMinimal());
+
+    Board clash = fromLine(leetcodeLine);
+    clash[0][2] = '5';
+    r = MinimalityChecker().run(clash, MinimalityMode::Reduce);
+    EXPECT_EQ(r.solutions, 0u);
+    EXPECT_EQ(r.puzzle, clash);
+}
+
+TEST(MinimalityChecker, RunAllMatchesOneByOne) {
+    std::vector<Board> puzzles = samplePuzzles(12);
+    for (MinimalityMode mode : { MinimalityMode::Check, MinimalityMode::Reduce }) {
+        std::vector<MinimalityResult> results = MinimalityChecker::runAll(puzzles, mode, 4);
+        ASSERT_EQ(results.size(), puzzles.size());
+        MinimalityChecker checker;
+        for (size_t i = 0; i < puzzles.size(); i++) {
+            MinimalityResult expected = checker.run(puzzles[i], mode);
+            EXPECT_EQ(results[i].redundant, expected.redundant) << i;
+            EXPECT_EQ(results[i].puzzle, expected.puzzle) << i;
+        }
+    }
+    EXPECT_TRUE(MinimalityChecker::runAll({}, MinimalityMode::Check, 4).empty());
+}
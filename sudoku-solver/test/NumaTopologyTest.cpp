@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+
+#include <NumaTopology.h>
+
+#include <cstdint>
+#include <thread>
+
+TEST(NumaTopology, ParseCpuList) {
+    std::vector<int> cpus;
+    ASSERT_TRUE(NumaTopology::parseCpuList("0-3,8,10-11\n", cpus));
+    EXPECT_EQ(cpus, (std::vector<int>{ 0, 1, 2, 3, 8, 10, 11 }));
+
+    ASSERT_TRUE(NumaTopology::parseCpuList("", cpus));
+    EXPECT_TRUE(cpus.empty());
+
+    EXPECT_FALSE(NumaTopology::parseCpuList("3-1", cpus));
+    EXPECT_FALSE(NumaTopology::parseCpuList("0,a", cpus));
+    EXPECT_FALSE(NumaTopology::parseCpuList("-2", cpus));
+}
+
+TEST(NumaTopology, NodesWithoutCpusAreDropped) {
+    NumaNode empty;
+    NumaNode second;
+    second.id = 1;
+    second.cpus = { 4, 5 };
+    NumaTopology topology({ empty, second });
+    ASSERT_EQ(topology.getNodes().size(), 1u);
+    EXPECT_EQ(topology.getNodes()[0].id, 1);
+    EXPECT_EQ(topology.cpuCount(), 2u);
+
+    EXPECT_EQ(NumaTopology(std::vector<NumaNode>()).cpuCount(), 1u);
+}
+
+TEST(NumaTopology, DetectListsTheCpusOfTheProcess) {
+    NumaTopology topology = NumaTopology::detect();
+    EXPECT_FALSE(topology.getNodes().empty());
+    EXPECT_GE(topology.cpuCount(), 1u);
+    EXPECT_FALSE(NumaTopology::pinThisThread(-1));
+
+    // Pin a thread of its own, not the one running the other tests
+    bool pinned = false;
+    std::thread t([&]() { pinned = NumaTopology::pinThisThread(topology.getNodes()[0].cpus[0]); });
+    t.join();
+#if defined(__linux__)
+    EXPECT_TRUE(pinned);
+#endif
+}
+
+TEST(NodeArena, AllocatesAlignedZeroedMemory) {
+    NodeArena arena(256);
+    char* c = arena.allocateArray<char>(3);
+    uint64_t* words = arena.allocateArray<uint64_t>(4);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(words) % alignof(uint64_t), 0u);
+    EXPECT_GE(reinterpret_cast<char*>(words), c + 3);
+    for (int i = 0; i < 4; i++) {
+        EXPECT_EQ(words[i], 0u);
+    }
+    EXPECT_EQ(arena.reserved(), 256u);
+
+    // Too big for a block, gets its own
+    char* big = arena.allocateArray<char>(1000);
+    big[999] = 1;
+    EXPECT_EQ(arena.reserved(), 1256u);
+
+    // Nothing to hold, nothing reserved
+    EXPECT_EQ(arena.allocateArray<char>(0), nullptr);
+    EXPECT_EQ(arena.reserved(), 1256u);
+
+    arena.release();
+    EXPECT_EQ(arena.reserved(), 0u);
+}
@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+
+#include <PuzzleFormat.h>
+#include <PuzzleGenerator.h>
+#include <SudokuValidator.h>
+#include <sudoku-solver.h>
+
+#include <set>
+
+TEST(CountSolutionsTest, UniquePuzzle) {
+    std::array<std::array<char, 9>, 9> board;
+    ASSERT_TRUE(PuzzleFormat::fromLine("53..7....6..195....98....6.8...6...34..8.3..17...2...6.6....28....419..5....8..79", board));
+
+    Solution s;
+    EXPECT_EQ(s.countSolutions(board, 2), 1u);
+}
+
+TEST(CountSolutionsTest, BlankBoardStopsAtLimit) {
+    std::array<std::array<char, 9>, 9> board;
+    for (auto& row : board) row.fill('.');
+
+    Solution s;
+    EXPECT_EQ(s.countSolutions(board, 2), 2u);
+    EXPECT_EQ(s.countSolutions(board, 10), 10u);
+}
+
+TEST(CountSolutionsTest, InvalidGivens) {
+    std::array<std::array<char, 9>, 9> board;
+    ASSERT_TRUE(PuzzleFormat::fromLine("55..7....6..195....98....6.8...6...34..8.3..17...2...6.6....28....419..5....8..79", board));
+
+    Solution s;
+    EXPECT_EQ(s.countSolutions(board, 2), 0u);
+}
+
+TEST(PuzzleFormatTest, RoundTrip) {
+    const std::string line = "53..7....6..195....98....6.8...6...34..8.3..17...2...6.6....28....419..5....8..79";
+    std::array<std::array<char, 9>, 9> board;
+    ASSERT_TRUE(PuzzleFormat::fromLine(line, board));
+    EXPECT_EQ(board[0][0], '5');
+    EXPECT_EQ(board[0][2], '.');
+    EXPECT_EQ(board[8][8], '9');
+    EXPECT_EQ(PuzzleFormat::toLine(board), line);
+}
+
+TEST(PuzzleFormatTest, RejectsBadLines) {
+    std::array<std::array<char, 9>, 9> board;
+    EXPECT_FALSE(PuzzleFormat::fromLine("53..7", board));
+    EXPECT_FALSE(PuzzleFormat::fromLine(std::string(80, '.') + "x", board));
+
+    // '0' is read as an empty cell
+    ASSERT_TRUE(PuzzleFormat::fromLine(std::string(81, '0'), board));
+    EXPECT_EQ(board[4][4], '.');
+}
+
+TEST(PuzzleGeneratorTest, SolvedGridIsValid) {
+    PuzzleGenerator g(42);
+    for (int i = 0; i < 10; i++) {
+        auto grid = g.randomSolvedGrid();
+        EXPECT_TRUE(SudokuValidator::isSudokuValid(grid));
+    }
+}
+
+TEST(PuzzleGeneratorTest, PuzzleHasUniqueSolution) {
+    PuzzleGenerator g(1);
+    GeneratedPuzzle p = g.generate();
+
+    Solution s;
+    EXPECT_EQ(s.countSolutions(p.puzzle, 2), 1u);
+
+    auto solved = p.puzzle;
+    s.solveSudoku(solved);
+    EXPECT_EQ(solved, p.solution);
+
+    int clues = 0;
+    for (const auto& row : p.puzzle) {
+        for (char c : row) {
+            if (c != '.') clues++;
+        }
+    }
+    EXPECT_EQ(clues, p.clues);
+    EXPECT_LT(p.clues, 40);
+}
+
+TEST(PuzzleGeneratorTest, SameSeedSamePuzzle) {
+    PuzzleGenerator a(1234);
+    PuzzleGenerator b(1234);
+    EXPECT_EQ(a.generate().puzzle, b.generate().puzzle);
+}
+
+TEST(PuzzleGeneratorTest, TargetDifficulty) {
+    PuzzleGenerator g(3);
+    GeneratedPuzzle p;
+    ASSERT_TRUE(g.generate(Difficulty::Easy, 20, p));
+    EXPECT_EQ(p.difficulty, Difficulty::Easy);
+    EXPECT_EQ(PuzzleGenerator::grade(p.puzzle), Difficulty::Easy);
+    EXPECT_EQ(p.nodes, 0u);
+
+    ASSERT_TRUE(g.generate(Difficulty::Hard, 20, p));
+    EXPECT_EQ(PuzzleGenerator::grade(p.puzzle), Difficulty::Hard);
+}
+
+TEST(PuzzleGeneratorTest, GenerateParallel) {
+    std::set<std::string> lines;
+    PuzzleGenerator::generateParallel(16, Difficulty::Medium, 4, 99, [&lines](const GeneratedPuzzle& p) {
+        EXPECT_EQ(p.difficulty, Difficulty::Medium);
+        lines.insert(PuzzleFormat::toLine(p.puzzle));
+    });
+    EXPECT_EQ(lines.size(), 16u);
+}
+
+TEST(PuzzleGeneratorTest, GenerateParallelGivesUp) {
+    // Expert puzzles are rare enough that five attempts can't make a hundred
+    uint64_t seen = 0;
+    uint64_t delivered = PuzzleGenerator::generateParallel(100, Difficulty::Expert, 2, 7, [&seen](const GeneratedPuzzle& p) {
+        EXPECT_EQ(p.difficulty, Difficulty::Expert);
+        seen++;
+    }, 5);
+    EXPECT_EQ(delivered, seen);
+    EXPECT_LE(delivered, 5u);
+}
+
+TEST(PuzzleGeneratorTest, DifficultyNames) {
+    Difficulty d;
+    EXPECT_TRUE(PuzzleGenerator::parseDifficulty("expert", d));
+    EXPECT_EQ(d, Difficulty::Expert);
+    EXPECT_STREQ(PuzzleGenerator::difficultyName(Difficulty::Medium), "medium");
+    EXPECT_FALSE(PuzzleGenerator::parseDifficulty("impossible", d));
+}
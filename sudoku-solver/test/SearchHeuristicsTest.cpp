@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include <PuzzleFormat.h>
+#include <SolveTrace.h>
+#include <SudokuValidator.h>
+#include <sudoku-solver.h>
+
+#include "TestPuzzles.h"
+
+namespace {
+
+SolveOptions restarting(RestartPolicy policy, uint64_t seed) {
+    SolveOptions opts;
+    opts.valueOrder = ValueOrder::LeastConstraining;
+    opts.randomizeTies = true;
+    opts.seed = seed;
+    opts.restarts = policy;
+    opts.restartBase = 5;
+    return opts;
+}
+
+}
+
+TEST(SearchHeuristicsTest, EveryValueOrderSolves) {
+    const auto expected = [] {
+        auto board = fromLine(hardLine);
+        Solution s;
+        s.solveSudoku(board);
+        return board;
+    }();
+
+    for (ValueOrder order : { ValueOrder::Ascending, ValueOrder::LeastConstraining, ValueOrder::DigitFrequency }) {
+        for (bool randomize : { false, true }) {
+            SolveOptions opts;
+            opts.valueOrder = order;
+            opts.randomizeTies = randomize;
+
+            auto board = fromLine(hardLine);
+            Solution s;
+            ASSERT_EQ(s.solveSudoku(board, opts), SolveStatus::Solved);
+            EXPECT_EQ(board, expected);
+            EXPECT_EQ(s.getStats().restarts, 0u);
+        }
+    }
+}
+
+TEST(SearchHeuristicsTest, RestartsStillSolve) {
+    for (RestartPolicy policy : { RestartPolicy::Luby, RestartPolicy::Geometric }) {
+        auto board = fromLine(hardLine);
+        Solution s;
+        ASSERT_EQ(s.solveSudoku(board, restarting(policy, 1)), SolveStatus::Solved);
+        EXPECT_TRUE(SudokuValidator::isSudokuValid(board));
+        EXPECT_GT(s.getStats().restarts, 0u);
+    }
+}
+
+TEST(SearchHeuristicsTest, SameSeedReplaysTheSearch) {
+    SolveTrace firstTrace;
+    SolveTrace secondTrace;
+
+    Solution first;
+    first.setTrace(&firstTrace);
+    auto a = fromLine(hardLine);
+    first.solveSudoku(a, restarting(RestartPolicy::Luby, 42));
+
+    Solution second;
+    second.setTrace(&secondTrace);
+    auto b = fromLine(hardLine);
+    second.solveSudoku(b, restarting(RestartPolicy::Luby, 42));
+
+    EXPECT_EQ(first.getStats().nodes, second.getStats().nodes);
+    EXPECT_EQ(first.getStats().backtracks, second.getStats().backtracks);
+    EXPECT_EQ(first.getStats().restarts, second.getStats().restarts);
+    EXPECT_EQ(firstTrace.toCompactString(), secondTrace.toCompactString());
+}
+
+TEST(SearchHeuristicsTest, RestartsProveUnsolvable) {
+    auto board = fromLine(".5...98..94.6.5..3....2....8..4......3.5...98.75..2...5....614....2.....4.2...96.");
+    SolveOptions opts = restarting(RestartPolicy::Geometric, 3);
+    opts.restartBase = 1;
+
+    Solution s;
+    EXPECT_EQ(s.solveSudoku(board, opts), SolveStatus::Unsolvable);
+}
+
+TEST(SearchHeuristicsTest, PausedSearchKeepsItsSettings) {
+    Solution reference;
+    auto expected = fromLine(hardLine);
+    reference.solveSudoku(expected, restarting(RestartPolicy::Luby, 7));
+
+    SolveOptions slice = restarting(RestartPolicy::Luby, 7);
+    slice.maxNodes = 50;
+
+    Solution s;
+    auto board = fromLine(hardLine);
+    SolveStatus status = s.solveSudoku(board, slice);
+    while (status == SolveStatus::BudgetExceeded) {
+        status = s.resume(board, slice);
+    }
+    ASSERT_EQ(status, SolveStatus::Solved);
+    EXPECT_EQ(board, expected);
+    EXPECT_EQ(s.getStats().nodes, reference.getStats().nodes);
+    EXPECT_EQ(s.getStats().restarts, reference.getStats().restarts);
+}
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+
+#include <BitboardSolution.h>
+#include <PuzzleFormat.h>
+#include <SolutionEnumerator.h>
+#include <SudokuValidator.h>
+
+#include <algorithm>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Board = SolutionEnumerator::Board;
+
+/// Keeps every block it is given
+class CollectingSink : public SolutionSink {
+public:
+    std::string data;
+    uint64_t count = 0;
+    uint64_t blocks = 0;
+
+    void write(const char* block, size_t size, uint64_t n) override {
+        data.append(block, size);
+        count += n;
+        blocks++;
+    }
+};
+
+class FailingSink : public SolutionSink {
+public:
+    void write(const char*, size_t, uint64_t) override {
+        throw std::runtime_error("disk full");
+    }
+};
+
+/// The LeetCode solution with its first four rows emptied, which leaves many solutions
+Board openBoard() {
+    Board board;
+    PuzzleFormat::fromLine(std::string(36, '.') + "426853791713924856961537284287419635345286179", board);
+    return board;
+}
+
+std::vector<std::string> lines(const std::string& data) {
+    std::vector<std::string> result;
+    for (size_t i = 0; i + 82 <= data.size(); i += 82) {
+        result.push_back(data.substr(i, 81));
+        EXPECT_EQ(data[i + 81], '\n');
+    }
+    return result;
+}
+
+}
+
+TEST(SolutionEnumerator, EveryDistinctSolutionOnce) {
+    const Board puzzle = openBoard();
+    BitboardSolution counter;
+    const uint32_t expected = counter.countSolutions(puzzle, 1000000);
+    ASSERT_GT(expected, 100u);
+
+    for (unsigned threads : { 1u, 4u }) {
+        EnumerateOptions options;
+        options.threads = threads;
+        options.piecesPerThread = 8;
+        CollectingSink sink;
+        EnumerateStats stats = SolutionEnumerator(options).run(puzzle, sink);
+        EXPECT_EQ(stats.solutions, expected);
+        EXPECT_EQ(sink.count, expected);
+        EXPECT_GT(stats.pieces, 1u);
+
+        std::vector<std::string> found = lines(sink.data);
+        ASSERT_EQ(found.size(), expected);
+        EXPECT_EQ(std::set<std::string>(found.begin(), found.end()).size(), expected);
+        for (const std::string& line : found) {
+            Board solution;
+            ASSERT_TRUE(PuzzleFormat::fromLine(line, solution));
+            EXPECT_TRUE(SudokuValidator::isSudokuValid(solution));
+            EXPECT_EQ(line.substr(36), PuzzleFormat::toLine(puzzle).substr(36));
+        }
+    }
+}
+
+TEST(SolutionEnumerator, LimitAndBinary) {
+    Board blank;
+    for (auto& row : blank) row.fill('.');
+
+    EnumerateOptions options;
+    options.threads = 3;
+    options.limit = 5000;
+    options.format = SolutionFormat::Binary;
+    CollectingSink sink;
+    EnumerateStats stats = SolutionEnumerator(options).run(blank, sink);
+    EXPECT_EQ(stats.solutions, 5000u);
+    ASSERT_EQ(sink.data.size(), 5000u * SolutionEnumerator::BINARY_SIZE);
+
+    std::set<std::string> distinct;
+    for (size_t i = 0; i < 5000; i++) {
+        Board solution;
+        SolutionEnumerator::decodeBinary(sink.data.data() + i * SolutionEnumerator::BINARY_SIZE, solution);
+        EXPECT_TRUE(SudokuValidator::isSudokuValid(solution));
+        distinct.insert(PuzzleFormat::toLine(solution));
+    }
+    EXPECT_EQ(distinct.size(), 5000u);
+}
+
+TEST(SolutionEnumerator, UniqueAndContradictoryBoards) {
+    Board unique;
+    PuzzleFormat::fromLine("53..7....6..195....98....6.8...6...34..8.3..17...2...6.6....28....419..5....8..79", unique);
+    CollectingSink sink;
+    EXPECT_EQ(SolutionEnumerator().run(unique, sink).solutions, 1u);
+    EXPECT_EQ(sink.data, "534678912672195348198342567859761423426853791713924856961537284287419635345286179\n");
+
+    Board clash = unique;
+    clash[0][2] = '5';
+    CollectingSink none;
+    EXPECT_EQ(SolutionEnumerator().run(clash, none).solutions, 0u);
+    EXPECT_EQ(none.blocks, 0u);
+
+    FailingSink failing;
+    EXPECT_THROW(SolutionEnumerator().run(openBoard(), failing), std::runtime_error);
+}
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+
+#include <SudokuValidator.h>
+#include <sudoku-solver.h>
+
+#include <thread>
+
+namespace {
+
+std::array<std::array<char, 9>, 9> nyTimesHard = { {
+    {'.','5','1','8','.','.','3','.','.'},
+    {'.','2','.','.','4','.','5','.','.'},
+    {'.','.','.','.','.','.','7','.','.'},
+    {'1','.','3','.','.','.','.','.','.'},
+    {'.','.','.','.','9','2','.','8','.'},
+    {'.','.','.','.','.','8','.','6','.'},
+    {'.','4','.','.','7','.','.','.','.'},
+    {'6','.','.','.','.','.','.','1','9'},
+    {'8','.','.','.','.','.','.','.','.'}} };
+
+}
+
+TEST(SolveBudgetTest, UnlimitedBudgetSolves) {
+    auto board = nyTimesHard;
+    Solution s;
+    EXPECT_EQ(s.solveSudoku(board, SolveOptions()), SolveStatus::Solved);
+    EXPECT_TRUE(SudokuValidator::isSudokuValid(board));
+    EXPECT_GT(s.getStats().nodes, 0u);
+    EXPECT_GT(s.getStats().maxDepth, 0u);
+}
+
+TEST(SolveBudgetTest, NodeBudgetExceeded) {
+    Solution s;
+    auto unlimited = nyTimesHard;
+    s.solveSudoku(unlimited, SolveOptions());
+    const uint64_t needed = s.getStats().nodes;
+    ASSERT_GT(needed, 1u);
+
+    SolveOptions opts;
+    opts.maxNodes = needed - 1;
+    auto board = nyTimesHard;
+    EXPECT_EQ(s.solveSudoku(board, opts), SolveStatus::BudgetExceeded);
+    EXPECT_EQ(board, nyTimesHard);
+
+    // Partial statistics are reported up to the last node within budget
+    EXPECT_EQ(s.getStats().nodes, needed - 1);
+    EXPECT_GT(s.getStats().cellsSetByPropagation, 0u);
+
+    opts.maxNodes = needed;
+    EXPECT_EQ(s.solveSudoku(board, opts), SolveStatus::Solved);
+}
+
+TEST(SolveBudgetTest, ZeroNodeBudget) {
+    std::array<std::array<char, 9>, 9> blank;
+    for (auto& row : blank) row.fill('.');
+
+    SolveOptions opts;
+    opts.maxNodes = 0;
+
+    Solution s;
+    EXPECT_EQ(s.solveSudoku(blank, opts), SolveStatus::BudgetExceeded);
+    EXPECT_EQ(s.getStats().nodes, 0u);
+    EXPECT_EQ(s.getStats().cellsSetByPropagation, 0u);
+}
+
+TEST(SolveBudgetTest, ResumeInTimeSlices) {
+    Solution reference;
+    auto expected = nyTimesHard;
+    reference.solveSudoku(expected, SolveOptions());
+    const uint64_t needed = reference.getStats().nodes;
+
+    SolveOptions slice;
+    slice.maxNodes = 3;
+
+    Solution s;
+    auto board = nyTimesHard;
+    SolveStatus status = s.solveSudoku(board, slice);
+    int slices = 1;
+    while (status == SolveStatus::BudgetExceeded) {
+        EXPECT_TRUE(s.isPaused());
+        EXPECT_EQ(board, nyTimesHard);
+        status = s.resume(board, slice);
+        slices++;
+    }
+
+    // Slicing the search does not change it
+    EXPECT_EQ(status, SolveStatus::Solved);
+    EXPECT_FALSE(s.isPaused());
+    EXPECT_EQ(board, expected);
+    EXPECT_EQ(s.getStats().nodes, needed);
+    EXPECT_EQ(static_cast<uint64_t>(slices), (needed + 2) / 3);
+}
+
+TEST(SolveBudgetTest, ResumeOnAnotherThread) {
+    SolveOptions firstSlice;
+    firstSlice.maxNodes = 1;
+
+    Solution s;
+    auto board = nyTimesHard;
+    ASSERT_EQ(s.solveSudoku(board, firstSlice), SolveStatus::BudgetExceeded);
+
+    Solution migrated = std::move(s);
+    SolveStatus status = SolveStatus::BudgetExceeded;
+    std::thread worker([&]() {
+        status = migrated.resume(board, SolveOptions());
+    });
+    worker.join();
+
+    EXPECT_EQ(status, SolveStatus::Solved);
+    EXPECT_TRUE(SudokuValidator::isSudokuValid(board));
+}
+
+TEST(SolveBudgetTest, ResumeWithoutPausedSearch) {
+    Solution s;
+    auto board = nyTimesHard;
+    EXPECT_THROW(s.resume(board, SolveOptions()), std::logic_error);
+
+    s.solveSudoku(board, SolveOptions());
+    EXPECT_THROW(s.resume(board, SolveOptions()), std::logic_error);
+}
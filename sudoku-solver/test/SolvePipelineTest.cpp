@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+
+#include <BitboardSolution.h>
+#include <PuzzleFormat.h>
+#include <PuzzleGenerator.h>
+#include <RingBuffer.h>
+#include <SolvePipeline.h>
+
+#include <algorithm>
+#include <atomic>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+TEST(RingBufferTest, FifoAndBounded) {
+    RingBuffer<int> q(4);
+    EXPECT_EQ(q.capacity(), 4u);
+
+    for (int i = 0; i < 4; i++) {
+        int v = i;
+        EXPECT_TRUE(q.tryPush(v));
+    }
+    int extra = 99;
+    EXPECT_FALSE(q.tryPush(extra));
+    EXPECT_EQ(q.sizeApprox(), 4u);
+
+    int v = -1;
+    for (int i = 0; i < 4; i++) {
+        ASSERT_TRUE(q.tryPop(v));
+        EXPECT_EQ(v, i);
+    }
+    EXPECT_FALSE(q.tryPop(v));
+    EXPECT_THROW(RingBuffer<int>(6), std::invalid_argument);
+}
+
+TEST(RingBufferTest, ManyProducersAndConsumers) {
+    RingBuffer<uint64_t> q(64);
+    const uint64_t perProducer = 20000;
+    std::atomic<uint64_t> sum{ 0 };
+    std::atomic<uint64_t> popped{ 0 };
+
+    std::vector<std::thread> threads;
+    for (uint64_t p = 0; p < 4; p++) {
+        threads.emplace_back([&q, p, perProducer]() {
+            for (uint64_t i = 1; i <= perProducer; i++) {
+                uint64_t v = p * perProducer + i;
+                while (!q.tryPush(v)) std::this_thread::yield();
+            }
+        });
+    }
+    for (int c = 0; c < 4; c++) {
+        threads.emplace_back([&]() {
+            uint64_t v;
+            while (popped.load() < 4 * perProducer) {
+                if (q.tryPop(v)) {
+                    sum += v;
+                    popped++;
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+
+    const uint64_t n = 4 * perProducer;
+    EXPECT_EQ(popped.load(), n);
+    EXPECT_EQ(sum.load(), n * (n + 1) / 2);
+}
+
+namespace {
+
+std::vector<std::string> puzzles(int count) {
+    std::vector<std::string> lines;
+    PuzzleGenerator generator(5);
+    for (int i = 0; i < count; i++) {
+        lines.push_back(PuzzleFormat::toLine(generator.generate().puzzle));
+    }
+    return lines;
+}
+
+std::string solvedLine(const std::string& line) {
+    std::array<std::array<char, 9>, 9> board;
+    PuzzleFormat::fromLine(line, board);
+    BitboardSolution s;
+    s.solveSudoku(board);
+    return PuzzleFormat::toLine(board);
+}
+
+std::vector<std::string> splitLines(const std::string& text) {
+    std::vector<std::string> lines;
+    std::istringstream in(text);
+    std::string line;
+    while (std::getline(in, line)) lines.push_back(line);
+    return lines;
+}
+
+}
+
+TEST(SolvePipelineTest, PreservesOrder) {
+    auto lines = puzzles(300);
+    std::string input;
+    for (const auto& l : lines) input += l + "\n";
+
+    PipelineConfig config;
+    config.solverThreads = 3;
+    config.queueCapacity = 8; // Small queues force the stages to wait on each other
+    SolvePipeline pipeline(config);
+
+    std::istringstream in(input);
+    std::ostringstream out;
+    PipelineStats stats = pipeline.run(in, out);
+
+    auto results = splitLines(out.str());
+    ASSERT_EQ(results.size(), lines.size());
+    for (size_t i = 0; i < lines.size(); i++) {
+        EXPECT_EQ(results[i], solvedLine(lines[i]));
+    }
+
+    EXPECT_EQ(stats.solvedPuzzles, 300u);
+    EXPECT_EQ(stats.rejectedSolutions, 0u);
+    EXPECT_EQ(stats.reader.items, 300u);
+    EXPECT_EQ(stats.solver.items, 300u);
+    EXPECT_EQ(stats.validator.items, 300u);
+    EXPECT_EQ(stats.writer.items, 300u);
+    EXPECT_EQ(stats.solverThreads, 3u);
+    EXPECT_EQ(stats.parsed.capacity, 8u);
+    EXPECT_LE(stats.parsed.meanOccupancy, 8.0);
+    EXPECT_GT(stats.elapsed.count(), 0);
+}
+
+TEST(SolvePipelineTest, UnorderedKeepsEveryResult) {
+    auto lines = puzzles(100);
+    std::string input;
+    std::vector<std::string> expected;
+    for (const auto& l : lines) {
+        input += l + "\n";
+        expected.push_back(solvedLine(l));
+    }
+
+    PipelineConfig config;
+    config.solverThreads = 4;
+    config.preserveOrder = false;
+    SolvePipeline pipeline(config);
+
+    std::istringstream in(input);
+    std::ostringstream out;
+    pipeline.run(in, out);
+
+    auto results = splitLines(out.str());
+    std::sort(results.begin(), results.end());
+    std::sort(expected.begin(), expected.end());
+    EXPECT_EQ(results, expected);
+}
+
+TEST(SolvePipelineTest, ReportsBadLines) {
+    const std::string unsolvable = "55" + std::string(79, '.');
+    std::istringstream in("# comment\n\nnot a puzzle\n" + unsolvable + "\r\n" + std::string(81, '.') + "\n");
+
+    PipelineConfig config;
+    config.solverThreads = 1;
+    SolvePipeline pipeline(config);
+    std::ostringstream out;
+    PipelineStats stats = pipeline.run(in, out);
+
+    auto results = splitLines(out.str());
+    ASSERT_EQ(results.size(), 3u);
+    EXPECT_EQ(results[0], "invalid");
+    EXPECT_EQ(results[1], unsolvable + " unsolvable");
+    EXPECT_EQ(results[2].size(), 81u);
+
+    EXPECT_EQ(stats.invalidLines, 1u);
+    EXPECT_EQ(stats.unsolvablePuzzles, 1u);
+    EXPECT_EQ(stats.solvedPuzzles, 1u);
+}
+
+TEST(SolvePipelineTest, RejectsBadCapacity) {
+    PipelineConfig config;
+    config.queueCapacity = 100;
+    EXPECT_THROW(SolvePipeline pipeline(config), std::invalid_argument);
+}
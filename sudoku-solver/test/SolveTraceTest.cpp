@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+
+#include <PuzzleFormat.h>
+#include <SolveTrace.h>
+#include <sudoku-solver.h>
+
+namespace {
+
+/// Replay the trace on the givens and check every naked single was forced by the cells placed before it
+void expectTraceReplays(const std::string& line) {
+    std::array<std::array<char, 9>, 9> board;
+    ASSERT_TRUE(PuzzleFormat::fromLine(line, board));
+    auto solved = board;
+
+    SolveTrace trace;
+    Solution s;
+    s.setTrace(&trace);
+    s.solveSudoku(solved);
+
+    std::array<std::array<char, 9>, 9> replay;
+    for (auto& row : replay) row.fill('.');
+
+    for (const auto& e : trace) {
+        ASSERT_EQ(replay[e.row][e.col], '.') << SolveTrace::describe(e);
+        if (e.technique == Technique::Given) {
+            EXPECT_EQ(board[e.row][e.col], static_cast<char>('0' + e.digit));
+        }
+        if (e.technique == Technique::NakedSingle) {
+            std::array<bool, 10> seen = {};
+            for (int k = 0; k < 9; k++) {
+                int bi = (e.row / 3) * 3 + k / 3;
+                int bj = (e.col / 3) * 3 + k % 3;
+                for (char c : { replay[e.row][k], replay[k][e.col], replay[bi][bj] }) {
+                    if (c != '.') seen[c - '0'] = true;
+                }
+            }
+            for (int d = 1; d <= 9; d++) {
+                EXPECT_EQ(seen[d], d != e.digit) << SolveTrace::describe(e);
+            }
+        }
+        replay[e.row][e.col] = static_cast<char>('0' + e.digit);
+    }
+
+    EXPECT_EQ(trace.size(), 81u);
+    EXPECT_EQ(replay, solved);
+}
+
+}
+
+TEST(SolveTraceTest, PropagationOnly) {
+    const std::string leetcode = "53..7....6..195....98....6.8...6...34..8.3..17...2...6.6....28....419..5....8..79";
+    expectTraceReplays(leetcode);
+
+    std::array<std::array<char, 9>, 9> board;
+    PuzzleFormat::fromLine(leetcode, board);
+    SolveTrace trace;
+    Solution s;
+    s.setTrace(&trace);
+    s.solveSudoku(board);
+
+    EXPECT_EQ(trace.countOf(Technique::Given), 30u);
+    EXPECT_EQ(trace.countOf(Technique::NakedSingle), 51u);
+    EXPECT_EQ(trace.hardestTechnique(), Technique::NakedSingle);
+}
+
+TEST(SolveTraceTest, FailedGuessesAreRolledBack) {
+    // NY Times hard needs guesses
+    const std::string hard = ".518..3...2..4.5........7..1.3..........92.8......8.6..4..7....6......198........";
+    expectTraceReplays(hard);
+
+    std::array<std::array<char, 9>, 9> board;
+    PuzzleFormat::fromLine(hard, board);
+    SolveTrace trace;
+    Solution s;
+    s.setTrace(&trace);
+    s.solveSudoku(board);
+    EXPECT_EQ(trace.hardestTechnique(), Technique::Guess);
+    EXPECT_GT(s.getStats().backtracks, 0u);
+}
+
+TEST(SolveTraceTest, CompactExport) {
+    SolveTrace trace;
+    trace.record(0, 2, 4, Technique::NakedSingle);
+    trace.record(8, 8, 9, Technique::Guess);
+    trace.record(4, 0, 1, Technique::Given);
+
+    EXPECT_EQ(trace.toCompactString(), "134N999G511C");
+    EXPECT_EQ(SolveTrace::describe(trace[0]), "r1c3 = 4 (naked single)");
+    EXPECT_EQ(trace.hardestTechnique(), Technique::Guess);
+
+    trace.truncate(1);
+    EXPECT_EQ(trace.toCompactString(), "134N");
+}
+
+TEST(SolveTraceTest, ClearedOnEverySolve) {
+    std::array<std::array<char, 9>, 9> board;
+    for (auto& row : board) row.fill('.');
+
+    SolveTrace trace;
+    Solution s;
+    s.setTrace(&trace);
+    s.solveSudoku(board);
+    EXPECT_EQ(trace.size(), 81u);
+    EXPECT_EQ(trace.countOf(Technique::Given), 0u);
+
+    s.solveSudoku(board);
+    EXPECT_EQ(trace.countOf(Technique::Given), 81u);
+
+    s.setTrace(nullptr);
+    s.solveSudoku(board);
+    EXPECT_EQ(trace.size(), 81u);
+}
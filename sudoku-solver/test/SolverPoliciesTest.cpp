@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+
+#include <BulkParser.h>
+#include <InputPuzzles.h>
+#include <PuzzleFormat.h>
+#include <SolverRegistry.h>
+#include <SudokuValidator.h>
+#include <sudoku-solver.h>
+
+#include "TestPuzzles.h"
+
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+using Board = std::array<std::array<char, 9>, 9>;
+
+const char* nyTimesHardLine = ".518..3...2..4.5........7..1.3..........92.8......8.6..4..7....6......198........";
+
+Board emptyBoard() {
+    Board board;
+    for (auto& row : board) row.fill('.');
+    return board;
+}
+
+void expectSolves(Board solution, const Board& puzzle) {
+    EXPECT_TRUE(SudokuValidator::isSudokuValid(solution));
+    for (int c = 0; c < 81; c++) {
+        if (puzzle[c / 9][c % 9] != '.') {
+            EXPECT_EQ(solution[c / 9][c % 9], puzzle[c / 9][c % 9]) << c;
+        }
+    }
+}
+
+template <class Policies>
+uint32_t countWith(const Board& board, uint32_t limit) {
+    BasicSolution<Policies> s;
+    return s.countSolutions(board, limit);
+}
+
+}
+
+TEST(SolverPolicies, EnginesAgreeOnInputFiles) {
+    for (const InputPuzzle& input : inputPuzzles) {
+        ParseResult parsed = BulkParser::parse(input.text);
+        for (const Board& puzzle : parsed.boards) {
+            Board expected = puzzle;
+            SolveStatus expectedStatus;
+            SolverRegistry::find("cells")->solveAll(&expected, 1, SolveOptions(), &expectedStatus);
+
+            for (const SolverEngine& engine : SolverRegistry::engines()) {
+                if (std::string(engine.name) == "cells-log") continue;
+                Board board = puzzle;
+                SolveStatus status;
+                engine.solveAll(&board, 1, SolveOptions(), &status);
+                ASSERT_EQ(status, expectedStatus) << input.name << " " << engine.name;
+                if (status == SolveStatus::Solved) {
+                    expectSolves(board, puzzle);
+                }
+                else {
+                    EXPECT_EQ(board, puzzle) << engine.name;
+                }
+            }
+        }
+    }
+}
+
+TEST(SolverPolicies, EnginesSolveABatch) {
+    std::vector<Board> puzzles = { fromLine(nyTimesHardLine), emptyBoard() };
+    Board clash = emptyBoard();
+    clash[0][0] = clash[0][8] = '5';
+    puzzles.push_back(clash);
+
+    for (const SolverEngine& engine : SolverRegistry::engines()) {
+        if (std::string(engine.name) == "cells-log") continue;
+        std::vector<Board> boards = puzzles;
+        std::vector<SolveStatus> statuses(boards.size());
+        engine.solveAll(boards.data(), boards.size(), SolveOptions(), statuses.data());
+        EXPECT_EQ(statuses[0], SolveStatus::Solved) << engine.name;
+        EXPECT_EQ(statuses[1], SolveStatus::Solved) << engine.name;
+        EXPECT_EQ(statuses[2], SolveStatus::Unsolvable) << engine.name;
+        expectSolves(boards[0], puzzles[0]);
+        expectSolves(boards[1], puzzles[1]);
+    }
+}
+
+TEST(SolverPolicies, CountSolutionsAgree) {
+    Board twoSolutions = fromLine("534..8912672195348198342567859..1423426853791713924856961537284287419635345286179");
+    for (uint32_t limit : { 1u, 2u, 5u }) {
+        const uint32_t expected = countWith<DefaultPolicies>(twoSolutions, limit);
+        EXPECT_EQ(countWith<FastPolicies>(twoSolutions, limit), expected);
+        EXPECT_EQ(countWith<StaticOrderPolicies>(twoSolutions, limit), expected);
+        EXPECT_EQ(countWith<ForwardCheckingPolicies>(twoSolutions, limit), expected);
+    }
+    EXPECT_EQ(countWith<FastPolicies>(twoSolutions, 5), 2u);
+    EXPECT_EQ(countWith<ForwardCheckingPolicies>(emptyBoard(), 20), 20u);
+}
+
+TEST(SolverPolicies, NoLimitsIgnoresTheBudget) {
+    SolveOptions opts;
+    opts.maxNodes = 1;
+
+    Board limited = fromLine(nyTimesHardLine);
+    Solution s;
+    EXPECT_EQ(s.solveSudoku(limited, opts), SolveStatus::BudgetExceeded);
+
+    Board unlimited = fromLine(nyTimesHardLine);
+    BasicSolution<FastPolicies> fast;
+    EXPECT_EQ(fast.solveSudoku(unlimited, opts), SolveStatus::Solved);
+    EXPECT_FALSE(fast.isPaused());
+    EXPECT_GT(fast.getStats().nodes, 1u);
+}
+
+TEST(SolverPolicies, SilentEnginesCountOnlyNodes) {
+    Board board = fromLine(nyTimesHardLine);
+    BasicSolution<FastPolicies> fast;
+    ASSERT_EQ(fast.solveSudoku(board, SolveOptions()), SolveStatus::Solved);
+    EXPECT_GT(fast.getStats().nodes, 0u);
+    EXPECT_EQ(fast.getStats().backtracks, 0u);
+    EXPECT_EQ(fast.getStats().maxDepth, 0u);
+
+    SolveTrace trace;
+    EXPECT_THROW(fast.setTrace(&trace), std::logic_error);
+    EXPECT_NO_THROW(fast.setTrace(nullptr));
+}
+
+TEST(SolverPolicies, ForwardCheckingGuessesSingles) {
+    // Every cell the full propagation fills for free is a node of its own under forward checking
+    Board puzzle = fromLine("53..7....6..195....98....6.8...6...34..8.3..17...2...6.6....28....419..5....8..79");
+
+    Board board = puzzle;
+    BasicSolution<FastPolicies> fast;
+    ASSERT_EQ(fast.solveSudoku(board, SolveOptions()), SolveStatus::Solved);
+    EXPECT_EQ(fast.getStats().nodes, 0u);
+
+    board = puzzle;
+    BasicSolution<ForwardCheckingPolicies> forward;
+    ASSERT_EQ(forward.solveSudoku(board, SolveOptions()), SolveStatus::Solved);
+    expectSolves(board, puzzle);
+    EXPECT_GT(forward.getStats().nodes, 0u);
+}
+
+TEST(SolverPolicies, LoggingEngineLogs) {
+    Board board = fromLine("53..7....6..195....98....6.8...6...34..8.3..17...2...6.6....28....419..5....8..79");
+    testing::internal::CaptureStdout();
+    BasicSolution<LoggingPolicies> s;
+    SolveStatus status = s.solveSudoku(board, SolveOptions());
+    std::string log = testing::internal::GetCapturedStdout();
+    ASSERT_EQ(status, SolveStatus::Solved);
+    EXPECT_NE(log.find("Setting value at"), std::string::npos);
+}
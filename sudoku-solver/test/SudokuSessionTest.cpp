@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+
+#include <PuzzleFormat.h>
+#include <SudokuSession.h>
+
+#include <chrono>
+
+namespace {
+
+std::array<std::array<char, 9>, 9> leetcode() {
+    std::array<std::array<char, 9>, 9> board;
+    PuzzleFormat::fromLine("53..7....6..195....98....6.8...6...34..8.3..17...2...6.6....28....419..5....8..79", board);
+    return board;
+}
+
+}
+
+TEST(SudokuSessionTest, EmptyBoard) {
+    SudokuSession session;
+    EXPECT_TRUE(session.isConsistent());
+    EXPECT_TRUE(session.isSolvable());
+    EXPECT_EQ(session.candidates(4, 4), 0x3FE);
+
+    EXPECT_TRUE(session.assign(0, 0, 5));
+    EXPECT_EQ(session.value(0, 0), 5);
+    EXPECT_EQ(session.candidates(0, 8), 0x3FE & ~(1 << 5));
+    EXPECT_EQ(session.entries()[0][0], '5');
+}
+
+TEST(SudokuSessionTest, GivensArePropagated) {
+    SudokuSession session(leetcode());
+    EXPECT_TRUE(session.isConsistent());
+    // The leetcode sample is solved by propagation alone
+    EXPECT_EQ(session.value(0, 2), 4);
+    EXPECT_EQ(session.candidates(0, 2), 1 << 4);
+    EXPECT_EQ(session.historySize(), 0u);
+    EXPECT_THROW(session.assign(0, 0, 1), std::logic_error);
+}
+
+TEST(SudokuSessionTest, ZeroBlanksAreEmpty) {
+    auto givens = leetcode();
+    for (auto& row : givens) {
+        for (char& c : row) {
+            if (c == '.') c = '0';
+        }
+    }
+
+    SudokuSession session(givens);
+    EXPECT_TRUE(session.isConsistent());
+    EXPECT_EQ(session.entries(), leetcode());
+    EXPECT_TRUE(session.assign(0, 2, 4));
+    EXPECT_EQ(session.entries()[0][2], '4');
+}
+
+TEST(SudokuSessionTest, ConflictAndUndo) {
+    SudokuSession session;
+    ASSERT_TRUE(session.assign(0, 0, 1));
+    EXPECT_FALSE(session.assign(0, 5, 1)); // Same row
+    EXPECT_FALSE(session.isConsistent());
+    EXPECT_FALSE(session.isSolvable());
+    EXPECT_EQ(session.candidates(3, 3), 0);
+
+    ASSERT_TRUE(session.undo());
+    EXPECT_TRUE(session.isConsistent());
+    EXPECT_TRUE(session.isSolvable());
+    EXPECT_EQ(session.entries()[0][5], '.');
+    EXPECT_EQ(session.candidates(0, 5), 0x3FE & ~(1 << 1));
+
+    ASSERT_TRUE(session.undo());
+    EXPECT_FALSE(session.undo());
+    EXPECT_EQ(session.candidates(0, 5), 0x3FE);
+}
+
+TEST(SudokuSessionTest, ConsistentButUnsolvable) {
+    std::array<std::array<char, 9>, 9> givens;
+    PuzzleFormat::fromLine(".5....8..94.6.5..3....2....8..4......3.5...98.75..2...5....614....2.....4.2...96.", givens);
+    SudokuSession session(givens);
+    ASSERT_TRUE(session.isSolvable());
+
+    // Propagation finds nothing wrong with a 9 there, only the search does
+    EXPECT_TRUE(session.assign(0, 5, 9));
+    EXPECT_TRUE(session.isConsistent());
+    EXPECT_FALSE(session.isSolvable());
+
+    session.undo();
+    EXPECT_TRUE(session.isSolvable());
+}
+
+TEST(SudokuSessionTest, EraseReplaysLaterEntries) {
+    SudokuSession session;
+    ASSERT_TRUE(session.assign(0, 0, 1));
+    ASSERT_TRUE(session.assign(4, 4, 5));
+    EXPECT_FALSE(session.assign(0, 8, 1));
+
+    // Removing the first 1 fixes the conflict and keeps the other entries
+    ASSERT_TRUE(session.erase(0, 0));
+    EXPECT_TRUE(session.isConsistent());
+    EXPECT_EQ(session.historySize(), 2u);
+    EXPECT_EQ(session.value(4, 4), 5);
+    EXPECT_EQ(session.value(0, 8), 1);
+    EXPECT_EQ(session.entries()[0][0], '.');
+    EXPECT_FALSE(session.erase(0, 0));
+}
+
+TEST(SudokuSessionTest, InvalidArguments) {
+    SudokuSession session;
+    EXPECT_THROW(session.assign(9, 0, 1), std::out_of_range);
+    EXPECT_THROW(session.assign(0, 0, 0), std::out_of_range);
+    EXPECT_THROW(session.candidates(0, -1), std::out_of_range);
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <PuzzleFormat.h>
+
+#include <array>
+#include <stdexcept>
+#include <string>
+
+/// Easy puzzle of LeetCode problem 37, solved by propagation alone
+const std::string leetcodeLine = "53..7....6..195....98....6.8...6...34..8.3..17...2...6.6....28....419..5....8..79";
+
+/// Solution of leetcodeLine
+const std::string solvedLine = "534678912672195348198342567859761423426853791713924856961537284287419635345286179";
+
+/// A 17 clue puzzle that needs a search
+const std::string hardLine = "......52..8.4......3...9...5.1...6..2..7........3.....6...1..........7.4.......3.";
+
+/// A puzzle without a solution
+const std::string unsolvableLine = ".5...98..94.6.5..3....2....8..4......3.5...98.75..2...5....614....2.....4.2...96.";
+
+/// Parse a puzzle line of a test, which fails the test if the line is mistyped
+inline std::array<std::array<char, 9>, 9> fromLine(const std::string& line) {
+    std::array<std::array<char, 9>, 9> board;
+    if (!PuzzleFormat::fromLine(line, board)) {
+        throw std::invalid_argument("Not a puzzle line: " + line);
+    }
+    return board;
+}
@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+
+#include <BitboardSolution.h>
+#include <PuzzleFormat.h>
+#include <Timeline.h>
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+size_t occurrences(const std::string& text, const std::string& pattern) {
+    size_t n = 0;
+    for (size_t at = text.find(pattern); at != std::string::npos; at = text.find(pattern, at + 1)) {
+        n++;
+    }
+    return n;
+}
+
+std::string exportTrace() {
+    std::ostringstream out;
+    Timeline::writeChromeTrace(out);
+    return out.str();
+}
+
+}
+
+TEST(Timeline, RecordsScopesOfEveryThread) {
+    Timeline::enable(64);
+    {
+        TimelineScope scope("main phase");
+    }
+    std::thread other([]() {
+        Timeline::setThreadName("other thread");
+        TimelineScope scope("other phase");
+    });
+    other.join();
+    Timeline::disable();
+
+    EXPECT_EQ(Timeline::recordedEvents(), 2u);
+    std::string trace = exportTrace();
+    EXPECT_EQ(trace.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["), 0u);
+    EXPECT_EQ(occurrences(trace, "\"name\":\"main phase\",\"cat\":\"sudoku\",\"ph\":\"X\""), 1u);
+    EXPECT_EQ(occurrences(trace, "\"name\":\"other phase\",\"cat\":\"sudoku\",\"ph\":\"X\""), 1u);
+    EXPECT_EQ(occurrences(trace, "\"args\":{\"name\":\"other thread\"}"), 1u);
+}
+
+TEST(Timeline, NothingIsRecordedWhileDisabled) {
+    Timeline::enable(64);
+    Timeline::disable();
+    {
+        TimelineScope scope("ignored");
+    }
+    EXPECT_EQ(Timeline::recordedEvents(), 0u);
+    EXPECT_EQ(exportTrace().find("ignored"), std::string::npos);
+}
+
+TEST(Timeline, FullBufferDropsEvents) {
+    Timeline::enable(4);
+    for (int i = 0; i < 10; i++) {
+        TimelineScope scope("repeated");
+    }
+    Timeline::disable();
+
+    EXPECT_EQ(Timeline::recordedEvents(), 4u);
+    EXPECT_EQ(Timeline::droppedEvents(), 6u);
+    EXPECT_EQ(occurrences(exportTrace(), "\"name\":\"repeated\""), 4u);
+}
+
+TEST(Timeline, ExitedThreadsHandTheirBuffersOn) {
+    Timeline::enable(64);
+    Timeline::disable();
+    std::thread idle([]() {
+        Timeline::setThreadName("idle thread");
+        TimelineScope scope("ignored");
+    });
+    idle.join();
+    const size_t before = Timeline::threadBuffers();
+
+    Timeline::enable(64);
+    for (int round = 0; round < 5; round++) {
+        std::vector<std::thread> workers;
+        for (int t = 0; t < 3; t++) {
+            workers.emplace_back([]() {
+                Timeline::setThreadName("pool worker");
+                TimelineScope scope("work");
+            });
+        }
+        for (auto& w : workers) {
+            w.join();
+        }
+    }
+    Timeline::disable();
+
+    EXPECT_EQ(Timeline::recordedEvents(), 15u);
+    EXPECT_LE(Timeline::threadBuffers(), before + 3);
+    std::string trace = exportTrace();
+    EXPECT_EQ(occurrences(trace, "\"name\":\"work\""), 15u);
+    EXPECT_EQ(trace.find("idle thread"), std::string::npos);
+}
+
+TEST(Timeline, SolverPhasesFollowTheBuildOption) {
+    std::array<std::array<char, 9>, 9> board;
+    ASSERT_TRUE(PuzzleFormat::fromLine("......52..8.4......3...9...5.1...6..2..7........3.....6...1..........7.4.......3.", board));
+
+    Timeline::enable();
+    BitboardSolution solver;
+    EXPECT_EQ(solver.solveSudoku(board, SolveOptions()), SolveStatus::Solved);
+    Timeline::disable();
+
+    std::string trace = exportTrace();
+    if (Timeline::compiledIn()) {
+        EXPECT_EQ(occurrences(trace, "\"name\":\"load\""), 1u);
+        EXPECT_EQ(occurrences(trace, "\"name\":\"search\""), 1u);
+    }
+    else {
+        EXPECT_EQ(Timeline::recordedEvents(), 0u);
+    }
+}
@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+
+#include <ConstraintGraph.h>
+#include <PuzzleFormat.h>
+#include <SudokuValidator.h>
+#include <sudoku-solver.h>
+
+#include "TestPuzzles.h"
+
+#include <stdexcept>
+
+namespace {
+
+using Board = std::array<std::array<char, 9>, 9>;
+
+Board emptyBoard() {
+    Board board;
+    for (auto& row : board) row.fill('.');
+    return board;
+}
+
+/// Every third cell of the solution, the rest left empty
+Board thinned(const Board& solution) {
+    Board puzzle = emptyBoard();
+    for (int c = 0; c < 81; c += 3) {
+        puzzle[c / 9][c % 9] = solution[c / 9][c % 9];
+    }
+    return puzzle;
+}
+
+void expectSolvedUnder(const Board& puzzle, const ConstraintGraph& graph) {
+    Board board = puzzle;
+    Solution s;
+    s.setConstraints(graph);
+    ASSERT_EQ(s.solveSudoku(board, SolveOptions()), SolveStatus::Solved);
+    EXPECT_TRUE(SudokuValidator::isValid(board, graph));
+    for (int c = 0; c < 81; c++) {
+        if (puzzle[c / 9][c % 9] != '.') {
+            EXPECT_EQ(board[c / 9][c % 9], puzzle[c / 9][c % 9]) << c;
+        }
+    }
+}
+
+}
+
+TEST(ConstraintGraph, ClassicPeers) {
+    const ConstraintGraph& graph = ConstraintGraph::classic();
+    for (int c = 0; c < 81; c++) {
+        EXPECT_EQ(graph.peers(c).size(), 20u);
+        EXPECT_EQ(graph.cagesOf(c).size(), 0u);
+    }
+    EXPECT_EQ(graph.getUnits().size(), 27u);
+
+    ConstraintGraph diagonal(RuleSet::diagonal());
+    EXPECT_EQ(diagonal.peers(0).size(), 26u);  // On one diagonal
+    EXPECT_EQ(diagonal.peers(40).size(), 32u); // The center is on both
+    EXPECT_EQ(diagonal.peers(1).size(), 20u);
+}
+
+TEST(ConstraintGraph, CageDigits) {
+    EXPECT_EQ(ConstraintGraph::cageDigits(2, 3, 0, 0x3FE), (1 << 1) | (1 << 2));
+    EXPECT_EQ(ConstraintGraph::cageDigits(2, 17, 0, 0x3FE), (1 << 8) | (1 << 9));
+    EXPECT_EQ(ConstraintGraph::cageDigits(2, 10, 1 << 1, 0x3FE), 0x3FE & ~((1 << 1) | (1 << 9) | (1 << 5)));
+    EXPECT_EQ(ConstraintGraph::cageDigits(2, 18, 0, 0x3FE), 0);
+    EXPECT_EQ(ConstraintGraph::cageDigits(1, 4, 0, 1 << 5), 0);
+}
+
+TEST(ConstraintGraph, RejectsBadRules) {
+    EXPECT_THROW(RuleSet::jigsaw("abc"), std::invalid_argument);
+    EXPECT_THROW(RuleSet::jigsaw(std::string(81, 'a')), std::invalid_argument);
+
+    Cage impossible;
+    impossible.cells = { 0, 1 };
+    impossible.sum = 2;
+    EXPECT_THROW(ConstraintGraph(RuleSet::killer({ impossible })), std::invalid_argument);
+
+    Cage repeated;
+    repeated.cells = { 0, 0 };
+    repeated.sum = 3;
+    EXPECT_THROW(ConstraintGraph(RuleSet::killer({ repeated })), std::invalid_argument);
+}
+
+TEST(VariantRules, ClassicValidatorMatches) {
+    Board solved = fromLine(solvedLine);
+    EXPECT_TRUE(SudokuValidator::isSudokuValid(solved));
+    std::swap(solved[0][0], solved[0][1]);
+    EXPECT_FALSE(SudokuValidator::isSudokuValid(solved));
+}
+
+TEST(VariantRules, Diagonal) {
+    ConstraintGraph graph(RuleSet::diagonal());
+
+    // The classic solution breaks the diagonals, so the variant has to be searched from scratch
+    EXPECT_FALSE(SudokuValidator::isValid(fromLine(solvedLine), graph));
+    Board solved = emptyBoard();
+    Solution s;
+    s.setConstraints(graph);
+    ASSERT_EQ(s.solveSudoku(solved, SolveOptions()), SolveStatus::Solved);
+    EXPECT_TRUE(SudokuValidator::isValid(solved, graph));
+
+    expectSolvedUnder(thinned(solved), graph);
+}
+
+TEST(VariantRules, Jigsaw) {
+    // Trade cells holding the same digit between neighbouring squares, the solution stays valid
+    const Board solution = fromLine(solvedLine);
+    std::string regions(81, ' ');
+    for (int c = 0; c < 81; c++) {
+        regions[c] = static_cast<char>('a' + (c / 27) * 3 + (c % 9) / 3);
+    }
+    for (int square = 0; square < 8; square++) {
+        int a = (square / 3) * 27 + (square % 3) * 3;
+        for (int b = 0; b < 81; b++) {
+            if (regions[b] == 'a' + square + 1 && solution[a / 9][a % 9] == solution[b / 9][b % 9]) {
+                std::swap(regions[a], regions[b]);
+                break;
+            }
+        }
+    }
+    ASSERT_NE(regions.substr(0, 3), "aaa");
+
+    ConstraintGraph graph(RuleSet::jigsaw(regions));
+    EXPECT_TRUE(SudokuValidator::isValid(solution, graph));
+    expectSolvedUnder(thinned(solution), graph);
+    expectSolvedUnder(emptyBoard(), graph);
+}
+
+TEST(VariantRules, Killer) {
+    // Cages of three cells along the rows, without a single given
+    const Board solution = fromLine(solvedLine);
+    std::vector<Cage> cages;
+    for (int c = 0; c < 81; c += 3) {
+        Cage cage;
+        for (int k = 0; k < 3; k++) {
+            cage.cells.push_back(static_cast<uint8_t>(c + k));
+            cage.sum += solution[(c + k) / 9][(c + k) % 9] - '0';
+        }
+        cages.push_back(cage);
+    }
+
+    ConstraintGraph graph(RuleSet::killer(cages));
+    EXPECT_TRUE(SudokuValidator::isValid(solution, graph));
+    expectSolvedUnder(emptyBoard(), graph);
+
+    Board wrongSum = solution;
+    std::swap(wrongSum[0][0], wrongSum[0][3]);
+    std::swap(wrongSum[1][0], wrongSum[1][3]);
+    EXPECT_FALSE(SudokuValidator::isValid(wrongSum, graph));
+}
@@ -0,0 +1,98 @@
+#include "CorpusRunner.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+namespace {
+
+int usage(const char* program)
+{
+	std::cerr << "Usage: " << program << " plan <input> <directory> [lines per shard]" << std::endl
+		<< "       " << program << " work <directory> [--threads N] [--checkpoint N] [--lease SECONDS] [--worker NAME] [--max-nodes N]" << std::endl
+		<< "       " << program << " status <directory>" << std::endl
+		<< "       " << program << " merge <directory> <output>" << std::endl;
+	return -1;
+}
+
+void printStats(const CorpusStats& stats)
+{
+	double seconds = static_cast<double>(stats.solveTime.count()) / 1e9;
+	std::cerr << stats.puzzles << " puzzles: " << stats.solved << " solved, " << stats.unsolvable << " unsolvable, "
+		<< stats.overBudget << " over budget, " << stats.invalid << " invalid in " << seconds << " s of solving" << std::endl;
+}
+
+}
+
+/**
+ * @brief Solve a large corpus in shards, with workers that may run on several hosts
+ *
+ * plan cuts the input into shards inside a run directory on a shared filesystem.
+ * Any number of `work` processes then claim and solve the shards, checkpointing
+ * as they go; a worker killed midway is taken over once its lease expires.
+ * merge writes the results in input order and prints the aggregate counters.
+*/
+int main(int argc, char** argv)
+{
+	if (argc < 3) return usage(argv[0]);
+	const std::string command = argv[1];
+	const std::string directory = command == "plan" ? (argc > 3 ? argv[3] : "") : argv[2];
+
+	try {
+		if (command == "plan" && (argc == 4 || argc == 5)) {
+			uint64_t lines = argc == 5 ? std::strtoull(argv[4], nullptr, 10) : 100000;
+			CorpusPlan plan = CorpusRunner::plan(argv[2], directory, lines);
+			std::cerr << plan.shards.size() << " shards" << std::endl;
+			return 0;
+		}
+		if (command == "work") {
+			CorpusOptions options;
+			for (int i = 3; i < argc; i++) {
+				if (i + 1 >= argc) return usage(argv[0]);
+				if (std::strcmp(argv[i], "--threads") == 0) {
+					options.threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+				}
+				else if (std::strcmp(argv[i], "--checkpoint") == 0) {
+					options.checkpointEvery = std::strtoull(argv[++i], nullptr, 10);
+				}
+				else if (std::strcmp(argv[i], "--lease") == 0) {
+					options.lease = std::chrono::seconds(std::strtoll(argv[++i], nullptr, 10));
+				}
+				else if (std::strcmp(argv[i], "--worker") == 0) {
+					options.worker = argv[++i];
+				}
+				else if (std::strcmp(argv[i], "--max-nodes") == 0) {
+					options.maxNodes = std::strtoull(argv[++i], nullptr, 10);
+				}
+				else {
+					return usage(argv[0]);
+				}
+			}
+			CorpusRunner runner(directory, options);
+			size_t finished = runner.work();
+			std::cerr << finished << " shards finished by this worker" << std::endl;
+			return 0;
+		}
+		if (command == "status" && argc == 3) {
+			CorpusRunner runner(directory);
+			size_t counts[3] = { 0, 0, 0 };
+			for (ShardState state : runner.status()) {
+				counts[static_cast<int>(state)]++;
+			}
+			std::cout << counts[0] << " pending, " << counts[1] << " claimed, " << counts[2] << " done" << std::endl;
+			printStats(runner.finishedStats());
+			return 0;
+		}
+		if (command == "merge" && argc == 4) {
+			CorpusRunner runner(directory);
+			printStats(runner.merge(argv[3]));
+			return 0;
+		}
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return -1;
+	}
+	return usage(argv[0]);
+}
@@ -0,0 +1,62 @@
+#include "PuzzleFormat.h"
+#include "SolutionEnumerator.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+/**
+ * @brief Write every solution of a board, or the first N, to stdout
+ *
+ * Usage: sudoku-enumerate <puzzle> [--limit N] [--threads N] [--binary]
+ *
+ * The puzzle is given in the line format, "-" reads it from the first line of
+ * stdin. Solutions are written in the line format, or as 41-byte records with
+ * --binary. Counters go to stderr.
+*/
+int main(int argc, char** argv)
+{
+	if (argc < 2) {
+		std::cerr << "Usage: " << argv[0] << " <puzzle> [--limit N] [--threads N] [--binary]" << std::endl;
+		return -1;
+	}
+
+	EnumerateOptions options;
+	for (int i = 2; i < argc; i++) {
+		if (std::strcmp(argv[i], "--limit") == 0 && i + 1 < argc) {
+			options.limit = std::strtoull(argv[++i], nullptr, 10);
+		}
+		else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+			options.threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+		}
+		else if (std::strcmp(argv[i], "--binary") == 0) {
+			options.format = SolutionFormat::Binary;
+		}
+		else {
+			std::cerr << "Usage: " << argv[0] << " <puzzle> [--limit N] [--threads N] [--binary]" << std::endl;
+			return -1;
+		}
+	}
+
+	std::string line = argv[1];
+	if (line == "-") {
+		std::getline(std::cin, line);
+	}
+	SolutionEnumerator::Board board;
+	if (!PuzzleFormat::fromLine(line, board)) {
+		std::cerr << "Not a puzzle: " << line << std::endl;
+		return -1;
+	}
+
+	std::ios::sync_with_stdio(false);
+	StreamSolutionSink sink(std::cout);
+	EnumerateStats stats = SolutionEnumerator(options).run(board, sink);
+	std::cout.flush();
+
+	double seconds = static_cast<double>(stats.elapsed.count()) / 1e9;
+	std::cerr << stats.solutions << " solutions in " << seconds << " s ("
+		<< (seconds > 0 ? static_cast<double>(stats.solutions) / seconds / 1e6 : 0.0) << " M/s), "
+		<< stats.nodes << " nodes over " << stats.pieces << " subtrees" << std::endl;
+	return std::cout ? 0 : -1;
+}
@@ -0,0 +1,52 @@
+#include "PuzzleFormat.h"
+#include "PuzzleGenerator.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <string>
+
+/**
+ * @brief Write puzzles with a unique solution in the line format
+ *
+ * Usage: sudoku-generator <count> [difficulty] [threads] [seed] [max-attempts]
+ *
+ * difficulty is one of easy, medium, hard, expert (default medium).
+ * threads defaults to every core, seed to 1, max-attempts to 1000 per puzzle.
+ * One puzzle is written per line on stdout. When the attempts run out before
+ * every puzzle was found, the shortfall is reported on stderr and the exit
+ * status is nonzero.
+*/
+int main(int argc, char** argv)
+{
+	if (argc < 2) {
+		std::cerr << "Usage: " << argv[0] << " <count> [easy|medium|hard|expert] [threads] [seed] [max-attempts]" << std::endl;
+		return -1;
+	}
+
+	uint64_t count = std::strtoull(argv[1], nullptr, 10);
+	Difficulty target = Difficulty::Medium;
+	if (argc > 2 && !PuzzleGenerator::parseDifficulty(argv[2], target)) {
+		std::cerr << "Unknown difficulty: " << argv[2] << std::endl;
+		return -1;
+	}
+	unsigned threads = argc > 3 ? static_cast<unsigned>(std::strtoul(argv[3], nullptr, 10)) : 0;
+	uint64_t seed = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 1;
+	const uint64_t attemptsPerPuzzle = 1000;
+	uint64_t maxAttempts = count > std::numeric_limits<uint64_t>::max() / attemptsPerPuzzle ? std::numeric_limits<uint64_t>::max() : count * attemptsPerPuzzle;
+	if (argc > 5) {
+		maxAttempts = std::strtoull(argv[5], nullptr, 10);
+	}
+
+	std::ios::sync_with_stdio(false);
+	uint64_t delivered = PuzzleGenerator::generateParallel(count, target, threads, seed, [](const GeneratedPuzzle& p) {
+		std::cout << PuzzleFormat::toLine(p.puzzle) << '\n';
+	}, maxAttempts);
+	std::cout.flush();
+	if (delivered < count) {
+		std::cerr << "Only " << delivered << " of " << count << " " << PuzzleGenerator::difficultyName(target)
+			<< " puzzles found in " << maxAttempts << " attempts" << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,111 @@
+#include "BulkParser.h"
+#include "MinimalityChecker.h"
+#include "PuzzleFormat.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+namespace {
+
+int usage(const char* program)
+{
+	std::cerr << "Usage: " << program << " <puzzles> [--reduce] [--threads N]" << std::endl;
+	return -1;
+}
+
+}
+
+/**
+ * @brief Check that puzzles are minimal, or reduce them to a minimal clue set
+ *
+ * Usage: sudoku-minimal <puzzles> [--reduce] [--threads N]
+ *
+ * The puzzles are read like sudoku-solver reads them, "-" reads stdin. One line
+ * is written per puzzle, in input order: the puzzle followed by " minimal" or
+ * " redundant N" when checking, the reduced puzzle when reducing. A puzzle
+ * without a unique solution is followed by " unsolvable" or " multiple".
+ * Counters go to stderr.
+*/
+int main(int argc, char** argv)
+{
+	if (argc < 2) return usage(argv[0]);
+
+	MinimalityMode mode = MinimalityMode::Check;
+	unsigned threads = 0;
+	for (int i = 2; i < argc; i++) {
+		if (std::strcmp(argv[i], "--reduce") == 0) {
+			mode = MinimalityMode::Reduce;
+		}
+		else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+			threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+		}
+		else {
+			return usage(argv[0]);
+		}
+	}
+
+	std::string input = argv[1];
+	ParseResult parsed;
+	try {
+		if (input == "-") {
+			std::string text((std::istreambuf_iterator<char>(std::cin)), std::istreambuf_iterator<char>());
+			parsed = BulkParser::parse(text);
+		}
+		else {
+			parsed = BulkParser::parseFile(input);
+		}
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return -1;
+	}
+	for (const ParseError& error : parsed.errors) {
+		std::cerr << input << ": byte " << error.offset << ": " << error.message << std::endl;
+	}
+
+	auto startTime = std::chrono::steady_clock::now();
+	std::vector<MinimalityResult> results = MinimalityChecker::runAll(parsed.boards, mode, threads);
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+	std::ios::sync_with_stdio(false);
+	uint64_t minimal = 0;
+	uint64_t notUnique = 0;
+	uint64_t removed = 0;
+	uint64_t trials = 0;
+	for (const MinimalityResult& r : results) {
+		std::cout << PuzzleFormat::toLine(r.puzzle);
+		if (r.solutions != 1) {
+			std::cout << (r.solutions == 0 ? " unsolvable" : " multiple");
+			notUnique++;
+		}
+		else if (mode == MinimalityMode::Check) {
+			if (r.isMinimal()) {
+				std::cout << " minimal";
+				minimal++;
+			}
+			else {
+				std::cout << " redundant " << r.redundant.size();
+			}
+		}
+		std::cout << '\n';
+		removed += r.redundant.size();
+		trials += r.trials;
+	}
+	std::cout.flush();
+
+	std::cerr << results.size() << " puzzles in " << seconds << " s ("
+		<< (seconds > 0 ? static_cast<double>(results.size()) / seconds : 0.0) << "/s), "
+		<< notUnique << " without a unique solution, ";
+	if (mode == MinimalityMode::Check) {
+		std::cerr << minimal << " minimal, ";
+	}
+	else {
+		std::cerr << removed << " clues removed, ";
+	}
+	std::cerr << trials << " trials" << std::endl;
+	return std::cout ? 0 : -1;
+}
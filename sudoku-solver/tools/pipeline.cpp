@@ -0,0 +1,109 @@
+#include "SolvePipeline.h"
+#include "Timeline.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+
+void printStage(const char* name, const StageStats& s, const PipelineStats& all, unsigned threads)
+{
+	double elapsed = static_cast<double>(all.elapsed.count());
+	auto share = [elapsed, threads](std::chrono::nanoseconds t) {
+		return elapsed == 0 ? 0.0 : 100.0 * static_cast<double>(t.count()) / (elapsed * threads);
+	};
+	std::cerr << std::setw(10) << name << std::setw(10) << s.items
+		<< std::setw(9) << std::fixed << std::setprecision(1) << share(s.busy) << '%'
+		<< std::setw(9) << share(s.blocked) << '%'
+		<< std::setw(9) << share(s.starved) << '%' << std::endl;
+}
+
+void printQueue(const char* name, const QueueStats& q)
+{
+	std::cerr << std::setw(10) << name << std::setw(10) << q.capacity
+		<< std::setw(10) << std::fixed << std::setprecision(1) << q.meanOccupancy << std::endl;
+}
+
+}
+
+/**
+ * @brief Solve puzzles from stdin to stdout through the staged pipeline
+ *
+ * Usage: sudoku-pipeline [solver threads] [--unordered] [--capacity N] [--timeline FILE]
+ *
+ * One puzzle per line in the line format. Stage and queue counters are written
+ * to stderr at the end. --timeline writes the solve phases of every thread as
+ * Chrome trace-event JSON, in builds configured with SUDOKU_ENABLE_TIMELINE.
+*/
+int main(int argc, char** argv)
+{
+	PipelineConfig config;
+	const char* timelinePath = nullptr;
+	for (int i = 1; i < argc; i++) {
+		if (std::strcmp(argv[i], "--unordered") == 0) {
+			config.preserveOrder = false;
+		}
+		else if (std::strcmp(argv[i], "--capacity") == 0 && i + 1 < argc) {
+			config.queueCapacity = std::strtoull(argv[++i], nullptr, 10);
+		}
+		else if (std::strcmp(argv[i], "--timeline") == 0 && i + 1 < argc) {
+			timelinePath = argv[++i];
+		}
+		else if (argv[i][0] >= '0' && argv[i][0] <= '9') {
+			config.solverThreads = static_cast<unsigned>(std::strtoul(argv[i], nullptr, 10));
+		}
+		else {
+			std::cerr << "Usage: " << argv[0] << " [solver threads] [--unordered] [--capacity N] [--timeline FILE]" << std::endl;
+			return -1;
+		}
+	}
+
+	if (timelinePath != nullptr) {
+		if (!Timeline::compiledIn()) {
+			std::cerr << "Built without SUDOKU_ENABLE_TIMELINE, the timeline will be empty" << std::endl;
+		}
+		Timeline::enable();
+	}
+
+	std::ios::sync_with_stdio(false);
+	PipelineStats stats;
+	try {
+		SolvePipeline pipeline(config);
+		stats = pipeline.run(std::cin, std::cout);
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return -1;
+	}
+
+	if (timelinePath != nullptr) {
+		Timeline::disable();
+		std::ofstream trace(timelinePath);
+		Timeline::writeChromeTrace(trace);
+		if (!trace) {
+			std::cerr << "Unable to write " << timelinePath << std::endl;
+			return -1;
+		}
+		if (Timeline::droppedEvents() != 0) {
+			std::cerr << Timeline::droppedEvents() << " timeline events dropped, the buffers were full" << std::endl;
+		}
+	}
+
+	double seconds = static_cast<double>(stats.elapsed.count()) / 1e9;
+	std::cerr << stats.solvedPuzzles << " solved, " << stats.unsolvablePuzzles << " unsolvable, "
+		<< stats.overBudgetPuzzles << " over budget, " << stats.invalidLines << " invalid, "
+		<< stats.rejectedSolutions << " rejected in " << seconds << " s" << std::endl;
+	std::cerr << "     stage     items     busy   blocked   starved" << std::endl;
+	printStage("reader", stats.reader, stats, 1);
+	printStage("solver", stats.solver, stats, stats.solverThreads);
+	printStage("validator", stats.validator, stats, 1);
+	printStage("writer", stats.writer, stats, 1);
+	std::cerr << "     queue  capacity  mean use" << std::endl;
+	printQueue("parsed", stats.parsed);
+	printQueue("solved", stats.solved);
+	printQueue("validated", stats.validated);
+	return 0;
+}
@@ -0,0 +1,116 @@
+#include "LoadReplay.h"
+#include "PuzzleFormat.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace {
+
+void printLatencies(const char* name, const LatencyHistogram& h)
+{
+	auto us = [](uint64_t ns) { return static_cast<double>(ns) / 1000.0; };
+	std::cout << std::setw(9) << name << std::fixed << std::setprecision(1)
+		<< std::setw(11) << us(h.valueAtPercentile(50))
+		<< std::setw(11) << us(h.valueAtPercentile(90))
+		<< std::setw(11) << us(h.valueAtPercentile(99))
+		<< std::setw(11) << us(h.valueAtPercentile(99.9))
+		<< std::setw(11) << us(h.max())
+		<< std::setw(11) << h.mean() / 1000.0 << std::endl;
+}
+
+int usage(const char* program)
+{
+	std::cerr << "Usage: " << program << " <corpus> [--rate PER_SECOND] [--mode inline|pool] [--threads N] [--requests N] [--max-nodes N]" << std::endl;
+	return -1;
+}
+
+}
+
+/**
+ * @brief Replay a corpus at a fixed arrival rate and report latency percentiles
+ *
+ * Usage: sudoku-replay <corpus> [--rate PER_SECOND] [--mode inline|pool] [--threads N] [--requests N] [--max-nodes N]
+ *
+ * One puzzle per line in the line format, "-" reads stdin. Response latencies
+ * are measured from the time each puzzle was due, so they include queueing and
+ * are free of coordinated omission; service latencies are the solves alone.
+*/
+int main(int argc, char** argv)
+{
+	if (argc < 2) return usage(argv[0]);
+
+	ReplayConfig config;
+	for (int i = 2; i < argc; i++) {
+		if (i + 1 >= argc) return usage(argv[0]);
+		if (std::strcmp(argv[i], "--rate") == 0) {
+			config.rate = std::strtod(argv[++i], nullptr);
+		}
+		else if (std::strcmp(argv[i], "--mode") == 0) {
+			std::string mode = argv[++i];
+			if (mode == "inline") config.mode = ReplayMode::Inline;
+			else if (mode == "pool") config.mode = ReplayMode::Pool;
+			else return usage(argv[0]);
+		}
+		else if (std::strcmp(argv[i], "--threads") == 0) {
+			config.threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+		}
+		else if (std::strcmp(argv[i], "--requests") == 0) {
+			config.requests = std::strtoull(argv[++i], nullptr, 10);
+		}
+		else if (std::strcmp(argv[i], "--max-nodes") == 0) {
+			config.maxNodesPerPuzzle = std::strtoull(argv[++i], nullptr, 10);
+		}
+		else {
+			return usage(argv[0]);
+		}
+	}
+
+	std::ifstream file;
+	if (std::strcmp(argv[1], "-") != 0) {
+		file.open(argv[1]);
+		if (!file) {
+			std::cerr << "Unable to read " << argv[1] << std::endl;
+			return -1;
+		}
+	}
+	std::istream& in = file.is_open() ? file : std::cin;
+
+	std::vector<LoadReplay::Board> corpus;
+	std::string line;
+	uint64_t skipped = 0;
+	while (std::getline(in, line)) {
+		if (line.empty() || line[0] == '#') continue;
+		LoadReplay::Board board;
+		if (PuzzleFormat::fromLine(line, board)) corpus.push_back(board);
+		else skipped++;
+	}
+	if (corpus.empty()) {
+		std::cerr << "No puzzle in " << argv[1] << std::endl;
+		return -1;
+	}
+	if (skipped != 0) {
+		std::cerr << skipped << " lines are not puzzles, skipped" << std::endl;
+	}
+
+	ReplayStats stats;
+	try {
+		stats = LoadReplay(config).run(corpus);
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return -1;
+	}
+
+	std::cout << stats.sent << " puzzles at " << config.rate << "/s offered, " << std::fixed << std::setprecision(1)
+		<< stats.throughput() << "/s completed: " << stats.solved << " solved, " << stats.unsolvable << " unsolvable, "
+		<< stats.overBudget << " over budget" << std::endl;
+	std::cout << "arrivals fell up to " << static_cast<double>(stats.maxSendLag.count()) / 1000.0 << " us behind schedule" << std::endl;
+	std::cout << "  latency    p50 (us)   p90 (us)   p99 (us) p99.9 (us)   max (us)  mean (us)" << std::endl;
+	printLatencies("response", stats.response);
+	printLatencies("service", stats.service);
+	return 0;
+}